@@ -0,0 +1,73 @@
+/*
+ * @brief Compact binary trace of Local Client loan applications
+ *
+ * Every record holds the external inputs of one application: Local Bank index, client number and all dice
+ * rolls drawn while the client was created and its loan was processed (loan value, installments, Local Bank
+ * and Central Bank validation), recorded with dice::tape. simulationEngine replays a trace through localClient,
+ * localBank::loanProcessingMethod() and centralBank at maximum speed (see simulationConfig::replayFileName).
+ *
+ * @attention Central Bank validation of the loan covering waiting loans (localBank::applyForLoan()) is recorded in the
+ * application which crossed LOCAL_BANK::THRESHOLD_FOR_LOAN. Threads of economy2 (resigning clients, Local Bank
+ * installments) can make a replay cross it in a different application, replay then asks for rolls the trace
+ * does not have (simulationResult::replayMisses) and its result is not the recorded one.
+ *
+ * File format (host byte order): uint32 TRACE::MAGIC, uint32 TRACE::VERSION, uint64 number of records, then
+ * per record uint16 Local Bank index, uint32 client number, uint8 number of rolls and one uint8 per roll.
+ */
+
+#ifndef LIB_APPLICATIONTRACE_APPLICATIONTRACE_H_
+#define LIB_APPLICATIONTRACE_APPLICATIONTRACE_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../../constants.h"
+
+/*!
+ * @brief Inputs of a single loan application
+ */
+struct applicationRecord {
+	std::uint16_t localBankIndex; ///< Index of the Local Bank (from 0)
+	std::uint32_t clientNumber; ///< Number of the Local Client
+	std::vector<std::uint8_t> rolls; ///< Dice rolls in the order they were drawn
+};
+
+class applicationTrace {
+
+private:
+	std::vector<applicationRecord> records; ///< Records in the order they were appended
+	std::mutex traceMTX; ///< Protects **records** while recording
+
+public:
+	/*!
+	 * @brief Appending **record**, safe to call from many threads
+	 *
+	 * Rolls above 255 per application are not stored (record is truncated).
+	 */
+	void append(applicationRecord record);
+
+	/*!
+	 * @brief Writing all records to **fileName**, returns false on I/O error
+	 */
+	bool write(const std::string& fileName);
+
+	/*!
+	 * @brief Reading records from **fileName** (replacing current ones), returns false if the file is not a valid trace
+	 */
+	bool read(const std::string& fileName);
+
+	/*!
+	 * @attention not synchronized with applicationTrace::append()
+	 */
+	const std::vector<applicationRecord>& getRecords() const {
+		return this->records;
+	};
+
+	/*!
+	 * @brief Returns number of Local Banks needed to replay the trace (the highest index + 1)
+	 */
+	int getLocalBanksAmount() const;
+};
+
+#endif /* LIB_APPLICATIONTRACE_APPLICATIONTRACE_H_ */
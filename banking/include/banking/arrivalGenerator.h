@@ -0,0 +1,63 @@
+/*
+ * @brief Thread feeding arrivalQueue from an arrivalProcess
+ *
+ * Arrivals are scheduled on absolute times (start + sum of inter-arrival times), so a late wake up does not
+ * lower the offered load. The generator knows nothing about the banks, it only pushes into the queue.
+ */
+
+#ifndef LIB_ARRIVALGENERATOR_ARRIVALGENERATOR_H_
+#define LIB_ARRIVALGENERATOR_ARRIVALGENERATOR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "arrivalProcess.h"
+#include "arrivalQueue.h"
+
+class arrivalGenerator {
+
+private:
+	std::unique_ptr<arrivalProcess> process; ///< Source of inter-arrival times
+	arrivalQueue* queuePtr; ///< Queue receiving arrivals, not owned
+	std::uint32_t clientsAmount; ///< Number of arrivals to generate
+	std::atomic<std::uint32_t> generated; ///< Number of arrivals generated so far (admitted or dropped)
+	std::atomic<bool> stopRequested; ///< Set by arrivalGenerator::stop()
+	std::atomic<bool> finished; ///< Set when the generator thread generated its last arrival, just before the queue is closed
+	std::thread generatorThread; ///< Thread running arrivalGenerator::run()
+
+	void run();
+
+public:
+	/*!
+	 * @brief Starting thread generating **clientsAmountArg** arrivals from **processArg** into **queueArg**
+	 *
+	 * Queue is closed when all arrivals were generated, the process ran out of arrivals or the generator was stopped.
+	 */
+	arrivalGenerator(std::unique_ptr<arrivalProcess> processArg, arrivalQueue* queueArg, std::uint32_t clientsAmountArg);
+
+	/*!
+	 * @brief Stopping and joining generator thread
+	 */
+	~arrivalGenerator();
+
+	arrivalGenerator(const arrivalGenerator&) = delete;
+	arrivalGenerator& operator=(const arrivalGenerator&) = delete;
+
+	/*!
+	 * @brief Requesting stop, the thread finishes after its current wait
+	 */
+	void stop() {
+		this->stopRequested.store(true, std::memory_order_relaxed);
+	};
+
+	bool isFinished() {
+		return this->finished.load(std::memory_order_acquire);
+	};
+
+	std::uint32_t getGenerated() {
+		return this->generated.load(std::memory_order_relaxed);
+	};
+};
+
+#endif /* LIB_ARRIVALGENERATOR_ARRIVALGENERATOR_H_ */
@@ -0,0 +1,91 @@
+/*
+ * @brief Processes generating Local Client arrival times
+ *
+ * Open-loop load generation: arrival times depend only on the process and its seed, never on the state of
+ * the banks. Processes are created from a text specification (see arrivalProcess::create()):
+ * - **poisson:<rate>** arrivals with exponential inter-arrival times, **rate** clients per second
+ * - **mmpp:<low rate>:<high rate>:<mean state seconds>** bursty Markov modulated Poisson process switching
+ *   between two rates, time spent in each state is exponential with the given mean
+ * - **trace:<file>** replay of arrival times (seconds from start, one per line, # starts a comment)
+ */
+
+#ifndef LIB_ARRIVALPROCESS_ARRIVALPROCESS_H_
+#define LIB_ARRIVALPROCESS_ARRIVALPROCESS_H_
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../../constants.h"
+
+class arrivalProcess {
+
+public:
+	virtual ~arrivalProcess() {};
+
+	/*!
+	 * @brief Returns time in seconds from the previous arrival (or from start) to the next one
+	 *
+	 * Negative value means there are no more arrivals.
+	 */
+	virtual double nextInterarrival() = 0;
+
+	/*!
+	 * @brief Creating process described by **spec**
+	 *
+	 * @return nullptr if **spec** is malformed or trace file cannot be read
+	 */
+	static std::unique_ptr<arrivalProcess> create(const std::string& spec, unsigned seed = ARRIVALS::SEED);
+};
+
+class poissonArrivalProcess : public arrivalProcess {
+
+private:
+	std::mt19937_64 engine; ///< Own generator, arrivals do not consume dice rolls
+	std::exponential_distribution<double> interarrival; ///< Inter-arrival time distribution
+
+public:
+	poissonArrivalProcess(double rate, unsigned seed);
+
+	double nextInterarrival() override;
+};
+
+class mmppArrivalProcess : public arrivalProcess {
+
+private:
+	std::mt19937_64 engine; ///< Own generator, arrivals do not consume dice rolls
+	std::exponential_distribution<double> lowInterarrival; ///< Inter-arrival time in low rate state
+	std::exponential_distribution<double> highInterarrival; ///< Inter-arrival time in high rate state
+	std::exponential_distribution<double> stateDuration; ///< Time spent in one state
+	bool highState; ///< Current state
+	double stateLeft; ///< Seconds left in the current state
+
+public:
+	mmppArrivalProcess(double lowRate, double highRate, double meanStateSeconds, unsigned seed);
+
+	/*!
+	 * Exponential distribution is memoryless, so when the state ends before the next arrival
+	 * the remaining wait is drawn again with the rate of the new state.
+	 */
+	double nextInterarrival() override;
+};
+
+class traceArrivalProcess : public arrivalProcess {
+
+private:
+	std::vector<double> arrivalTimes; ///< Absolute arrival times in seconds, non-decreasing
+	std::size_t nextArrival; ///< Index of the next arrival
+	double previousTime; ///< Time of the previous arrival
+
+public:
+	traceArrivalProcess(std::vector<double> arrivalTimesArg);
+
+	/*!
+	 * @brief Reading arrival times from **fileName**, returns false if file cannot be read or is malformed
+	 */
+	static bool readTrace(const std::string& fileName, std::vector<double>& arrivalTimesOut);
+
+	double nextInterarrival() override;
+};
+
+#endif /* LIB_ARRIVALPROCESS_ARRIVALPROCESS_H_ */
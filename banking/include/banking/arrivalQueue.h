@@ -0,0 +1,171 @@
+/*
+ * @brief Bounded queue between the arrival generator and the banks
+ *
+ * Arrivals are pushed without blocking (open loop: the generator never waits for the banks), arrival
+ * which does not fit is dropped and counted. Queue depth and time spent in the queue are measured,
+ * so saturation shows up as growing wait and dropped arrivals instead of slower generation.
+ * The same queue bounds pending loan applications of a single Local Bank in economy2, where
+ * arrivalQueue::push() applies an admissionPolicy when the queue is full.
+ */
+
+#ifndef LIB_ARRIVALQUEUE_ARRIVALQUEUE_H_
+#define LIB_ARRIVALQUEUE_ARRIVALQUEUE_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include "../../constants.h"
+
+/*!
+ * @brief Latency histogram with power of two buckets, safe to record from many threads
+ */
+class latencyHistogram {
+
+private:
+	std::array<std::atomic<std::uint64_t>, PROFILING::HISTOGRAM_BUCKETS> buckets {}; ///< Bucket i counts latencies in [2^i, 2^(i+1)) ns
+	std::atomic<std::uint64_t> samples {0}; ///< Number of recorded latencies
+	std::atomic<std::uint64_t> maxNs {0}; ///< The highest recorded latency
+
+public:
+	void record(std::chrono::steady_clock::duration latency);
+
+	/*!
+	 * @brief Adding all latencies recorded by **other**
+	 */
+	void merge(const latencyHistogram& other);
+
+	std::uint64_t getSamples() const {
+		return this->samples.load(std::memory_order_relaxed);
+	};
+
+	std::uint64_t getMaxNs() const {
+		return this->maxNs.load(std::memory_order_relaxed);
+	};
+
+	/*!
+	 * @brief Returns upper bound (in ns) of the bucket containing **quantile** of recorded latencies, 0 if empty
+	 */
+	std::uint64_t getQuantileNs(double quantile) const;
+
+	/*!
+	 * @brief Returns "p50 <x> us, p99 <y> us, max <z> us"
+	 */
+	std::string toString() const;
+};
+
+/*!
+ * @brief Single Local Client arrival
+ */
+struct clientArrival {
+	std::uint32_t clientNumber; ///< Number of the arriving client
+	std::chrono::steady_clock::time_point arrivalTime; ///< Time the client arrived (was scheduled)
+};
+
+/*!
+ * @brief What arrivalQueue::push() does when the queue is full
+ */
+enum class admissionPolicy {
+	REJECT, ///< New arrival is rejected
+	SHED, ///< The oldest waiting arrival is dropped to make room for the new one
+	WAIT ///< Producer waits for room (up to a timeout)
+};
+
+/*!
+ * @brief Outcome of arrivalQueue::push()
+ */
+enum class admissionResult {
+	ADMITTED, ///< Arrival is in the queue
+	ADMITTED_SHEDDING, ///< Arrival is in the queue instead of the oldest one, which was dropped
+	REJECTED, ///< Arrival is not in the queue (full, timed out or closed)
+};
+
+class arrivalQueue {
+
+private:
+	std::size_t capacity; ///< Maximal number of waiting arrivals
+	admissionPolicy policy; ///< Behaviour of arrivalQueue::push() on full queue
+	std::deque<clientArrival> arrivals; ///< Waiting arrivals, protected by **queueMTX**
+	bool closed; ///< No more arrivals will be pushed, protected by **queueMTX**
+	std::mutex queueMTX; ///< Protects **arrivals** and **closed**
+	std::condition_variable notEmpty; ///< Signalled on push and close
+	std::condition_variable notFull; ///< Signalled on pop and close
+	std::uint64_t pushed; ///< Number of admitted arrivals, protected by **queueMTX**
+	std::uint64_t dropped; ///< Number of arrivals dropped because the queue was full, protected by **queueMTX**
+	std::uint64_t shed; ///< Number of waiting arrivals dropped by admissionPolicy::SHED, protected by **queueMTX**
+	std::uint64_t waited; ///< Number of pushes which had to wait for room, protected by **queueMTX**
+	std::size_t maxDepth; ///< The highest observed depth, protected by **queueMTX**
+	double depthSum; ///< Sum of depths seen by admitted arrivals, protected by **queueMTX**
+	latencyHistogram queueWait; ///< Time between arrival and pop
+
+public:
+	arrivalQueue(std::size_t capacityArg = ARRIVALS::QUEUE_CAPACITY, admissionPolicy policyArg = admissionPolicy::REJECT);
+
+	/*!
+	 * @brief Parsing **reject**, **shed** or **wait**, returns false on unknown name
+	 */
+	static bool parsePolicy(const std::string& policyName, admissionPolicy& policyOut);
+
+	/*!
+	 * @brief Adding **arrival**, never blocks
+	 *
+	 * @return false if the queue is full (arrival is dropped) or closed
+	 */
+	bool tryPush(const clientArrival& arrival);
+
+	/*!
+	 * @brief Adding **arrival** according to the admissionPolicy of the queue
+	 *
+	 * With admissionPolicy::WAIT waits at most **timeout** for room. Rejected arrivals are counted
+	 * in arrivalQueue::getDropped(), waiting arrivals dropped to make room in arrivalQueue::getShed().
+	 */
+	admissionResult push(const clientArrival& arrival, std::chrono::milliseconds timeout);
+
+	/*!
+	 * @brief Taking the oldest arrival, waiting at most **timeout** for one
+	 *
+	 * @return false if nothing arrived in time or the queue is closed and empty
+	 */
+	bool pop(clientArrival& arrivalOut, std::chrono::milliseconds timeout);
+
+	/*!
+	 * @brief Marking that no more arrivals will come, waiting consumers are woken up
+	 */
+	void close();
+
+	/*!
+	 * @brief Returns true if the queue is closed and all arrivals were taken
+	 */
+	bool isDrained();
+
+	std::size_t getDepth();
+
+	std::size_t getCapacity() {
+		return this->capacity;
+	};
+
+	std::uint64_t getPushed();
+
+	std::uint64_t getDropped();
+
+	std::uint64_t getShed();
+
+	std::uint64_t getWaited();
+
+	std::size_t getMaxDepth();
+
+	/*!
+	 * @brief Returns average depth seen by admitted arrivals (including themselves)
+	 */
+	double getAverageDepth();
+
+	const latencyHistogram& getQueueWait() {
+		return this->queueWait;
+	};
+};
+
+#endif /* LIB_ARRIVALQUEUE_ARRIVALQUEUE_H_ */
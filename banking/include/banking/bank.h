@@ -8,6 +8,7 @@
 #ifndef LIB_BANK_BANK_H_
 #define LIB_BANK_BANK_H_
 
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -16,21 +17,38 @@
 
 #include "dice.h"
 #include "client.h"
+#include "economicParameters.h"
 #include "loan.h"
+#include "settlementBuffer.h"
+#include "ledger.h"
+#include "nameTable.h"
+#include "profiledMutex.h"
+#include "traceRecorder.h"
 #include "../../constants.h"
 #include "loggerClass.h"
 
 class bank {
 
 protected:
-	std::string name; ///< Name of the bank
+	nameTable::entityId id; ///< Id of the bank name in nameTable
 	double totalTreasury; ///< The total value of treasury, also the starting value
 	double currentTreasury; ///< The current value of treasury
-	double interestRate; ///< Starting value of interest rate
+	/*!
+	 * @brief Starting value of interest rate
+	 * 
+	 * Atomic because Local Banks and Local Clients read Central Bank rate from their own threads
+	 * while Central Bank adjusts it under its bank::bankMTX
+	 */
+	std::atomic<double> interestRate;
 	dice diceBank; ///< Dice object which is in <loanProcessingMethod>()
-	std::mutex bankMTX; ///< Mutex used in implementation of these methods:
+	profiledMutex bankMTX; ///< Mutex used in implementation of these methods:
 	double totalLoans; ///< Variable needed for statistic
 	double totalValidLoans; ///< Variable needed for statistic
+	bool epochSettlement; ///< If true installments are accumulated and settled by bank::settleEpoch()
+	settlementBuffer pendingSettlement; ///< Installments received but not yet settled to treasury
+	ledger::accountId treasuryAccount; ///< Ledger account mirroring bank::currentTreasury
+	ledger::accountId pendingAccount; ///< Ledger account mirroring bank::pendingSettlement
+	std::atomic<const economicParameters*> parameters; ///< Current parameters snapshot, see bank::publishParameters()
 
 public:
 	/*!
@@ -39,15 +57,22 @@ public:
 	 * @param totalTreasuryArg used to set both **totalTreasury** and **currentTreasury**
 	 * @param interestRateArg is used to set bank.interestRate
 	 */
-	bank(std::string nameArg, double totalTreasuryArg, double interestRateArg) :
-		name(nameArg),
+	bank(const std::string& nameArg, double totalTreasuryArg, double interestRateArg) :
+		id(nameTable::intern(nameArg)),
 		totalTreasury(totalTreasuryArg),
 		currentTreasury(totalTreasuryArg),
 		interestRate(interestRateArg),
 		diceBank(dice(BANK::DICE_SIZE)),
+		bankMTX(nameArg + " bankMTX"),
 		totalLoans(0),
-		totalValidLoans(0)
-	{};
+		totalValidLoans(0),
+		epochSettlement(false),
+		treasuryAccount(ledger::openAccount()),
+		pendingAccount(ledger::openAccount()),
+		parameters(economicParameters::defaults())
+	{
+		ledger::transfer(ledger::EXTERNAL, this->treasuryAccount, totalTreasuryArg);
+	};
 
 	virtual ~bank() {};
 
@@ -73,15 +98,63 @@ public:
 	 * 
 	 * Method responsible for receiving and processing single installment 
 	 * payment of a valid loan.
+	 * In epoch settlement mode the installment is only deposited into bank.pendingSettlement
+	 * and treasury is updated later by bank::settleEpoch().
+	 * Only incoming leg is posted to ledger, the payer posts the outgoing one.
 	 */
 	void receivePayment(loan* loanPtr) {
-		std::lock_guard<std::mutex> lock_guard1(this->bankMTX);
+		traceSpan span("receivePayment");
+		if (this->epochSettlement) {
+			this->pendingSettlement.deposit(loanPtr->getSingleInstallmentValue());
+			ledger::post(this->pendingAccount, loanPtr->getSingleInstallmentValue());
+			return;
+		}
+		profiledLock lock_guard1(this->bankMTX);
 		this->currentTreasury = this->currentTreasury + loanPtr->getSingleInstallmentValue();
+		ledger::post(this->treasuryAccount, loanPtr->getSingleInstallmentValue());
 		this->adjustInterestRate();
 		this->logCurrentTreasuryRate();
 		this->logCurrentInterestRate();
 	};
 
+	/*!
+	 * @brief Method settling all installments received since the previous epoch
+	 * 
+	 * Adds pending installments to bank::currentTreasury and recomputes interest rate once.
+	 * Does nothing if no installment was received.
+	 */
+	void settleEpoch() {
+		traceSpan span("settleEpoch");
+		int installments {0};
+		double amount = this->pendingSettlement.drain(installments);
+		if (installments == 0) {
+			return;
+		}
+		profiledLock lock_guard1(this->bankMTX);
+		this->currentTreasury = this->currentTreasury + amount;
+		ledger::transfer(this->pendingAccount, this->treasuryAccount, amount);
+		this->adjustInterestRate();
+		LOG_EVENT_LAZY(this->logEvent, "epoch settled: " + std::to_string(installments) + " installments");
+		this->logCurrentTreasuryRate();
+		this->logCurrentInterestRate();
+	};
+
+	/*!
+	 * @brief Switching epoch settlement mode on or off
+	 * 
+	 * Switching the mode off settles everything which is still pending.
+	 */
+	void setEpochSettlement(bool epochSettlementArg) {
+		this->epochSettlement = epochSettlementArg;
+		if (!epochSettlementArg) {
+			this->settleEpoch();
+		}
+	};
+
+	bool isEpochSettlement() {
+		return this->epochSettlement;
+	};
+
 	/*!
 	 * @brief Method which allows to reduce current treasury 
 	 * 
@@ -90,23 +163,96 @@ public:
 	 * Needed for testing purpose, do not remove
 	 */
 	void withdraw(double amount) {
+		profiledLock lock_guard1(this->bankMTX);
 		if (this->currentTreasury >= amount) {
 			this->currentTreasury = this->currentTreasury - amount; 
+			ledger::transfer(this->treasuryAccount, ledger::EXTERNAL, amount);
 			this->adjustInterestRate();
 		};
 	};
 
-	std::string getName() {
-		return this->name;
+	/*!
+	 * @brief Method which allows to increase current treasury from outside of the simulation
+	 * 
+	 * Counterpart of bank::withdraw(), both bank::currentTreasury and bank::totalTreasury grow
+	 * (like in localBank::increaseTreasury()) and interest rate is updated.
+	 */
+	void deposit(double amount) {
+		profiledLock lock_guard1(this->bankMTX);
+		this->currentTreasury = this->currentTreasury + amount;
+		ledger::transfer(ledger::EXTERNAL, this->treasuryAccount, amount);
+		this->totalTreasury = this->totalTreasury + amount;
+		this->adjustInterestRate();
+	};
+
+	/*!
+	 * @brief Publishing new parameters snapshot and updating interest rate with it
+	 * 
+	 * **parametersArg** has to stay alive (and unchanged) as long as the bank may use it.
+	 * Readers only load the pointer, see bank::getParameters().
+	 */
+	void publishParameters(const economicParameters* parametersArg) {
+		this->parameters.store(parametersArg, std::memory_order_release);
+		profiledLock lock_guard1(this->bankMTX);
+		this->adjustInterestRate();
 	};
 
+	const economicParameters& getParameters() {
+		return *this->parameters.load(std::memory_order_acquire);
+	};
+
+	/*!
+	 * @brief Comparing bank::currentTreasury with balance of bank.treasuryAccount in ledger
+	 * 
+	 * Every treasury change is posted under bank::bankMTX, so collecting the journal while holding
+	 * the mutex gives exact balance of this bank even when other threads keep posting.
+	 * @return true if both values are equal up to rounding
+	 */
+	bool auditLedger() {
+		profiledLock lock_guard1(this->bankMTX);
+		ledger::collect();
+		return ledger::isEqual(ledger::getBalance(this->treasuryAccount), this->currentTreasury);
+	};
+
+	ledger::accountId getTreasuryAccount() {
+		return this->treasuryAccount;
+	};
+
+	nameTable::entityId getId() {
+		return this->id;
+	};
+
+	/*!
+	 * @brief Returns bank name from nameTable, meant only for human readable output
+	 */
+	const std::string& getName() {
+		return nameTable::getName(this->id);
+	};
+
+	/*!
+	 * @attention takes bank::bankMTX, must not be called by a thread already holding it
+	 */
 	double getCurrentTreasury() {
+		profiledLock lock_guard1(this->bankMTX);
 		return this->currentTreasury;
 	};
+
+	/*!
+	 * @attention takes bank::bankMTX, must not be called by a thread already holding it
+	 */
 	double getTotalTreasury() {
+		profiledLock lock_guard1(this->bankMTX);
 		return this->totalTreasury;
 	};
 
+	double getTotalLoans() {
+		return this->totalLoans;
+	};
+
+	double getTotalValidLoans() {
+		return this->totalValidLoans;
+	};
+
 	virtual double getInterestRate() {
 		return this->interestRate;
 	};
@@ -120,15 +266,25 @@ public:
 	 * 
 	 * Simple logging method. See logging:logEvent for more info
 	 */
-	void logEvent(std::string stringArg) {
-		loggerClass::logEvent(this->name + " event: " + stringArg);
+	void logEvent(const std::string& stringArg) {
+		loggerClass::logEvent(this->id, stringArg);
+	};
+
+	/*!
+	 * @brief Same as logEvent(const std::string&), string is not built in headless mode
+	 */
+	void logEvent(const char* stringArg) {
+		if (loggerClass::isHeadless()) {
+			return;
+		}
+		this->logEvent(std::string(stringArg));
 	};
 
 	/*!
 	 * @brief Method to log info about treasury 
 	 */
 	void logCurrentTreasuryRate() {
-		this->logEvent("treasury rate: "
+		LOG_EVENT_LAZY(this->logEvent, "treasury rate: "
 				+ std::to_string(this->currentTreasury / this->totalTreasury * 100)
 				+ "% (Total treasury: "
 				+ std::to_string(this->totalTreasury)
@@ -138,7 +294,8 @@ public:
 	/*!
 	 * @brief Method to log info about interest rate 
 	 */
-	void logCurrentInterestRate() { this->logEvent("interest rate: "
+	void logCurrentInterestRate() {
+		LOG_EVENT_LAZY(this->logEvent, "interest rate: "
 			+ std::to_string(this->getInterestRate() * 100)
 			+ "%");
 	};
@@ -146,7 +303,8 @@ public:
 	/*!
 	 * @brief Method to log info about number of validated loans 
 	 */
-	void logLoansValidationRate() { this->logEvent("loans validation rate: "
+	void logLoansValidationRate() {
+		LOG_EVENT_LAZY(this->logEvent, "loans validation rate: "
 			+ std::to_string((this->totalValidLoans / this->totalLoans) * 100)
 			+ "%");
 	};
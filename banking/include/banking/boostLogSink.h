@@ -0,0 +1,31 @@
+/*
+ * @brief Boost.Log output of loggerClass
+ * 
+ * Part of the banking_io library, the only place where Boost.Log is used.
+ */
+
+#ifndef LIB_BOOSTLOGSINK_BOOSTLOGSINK_H_
+#define LIB_BOOSTLOGSINK_BOOSTLOGSINK_H_
+
+#include <cstdint>
+#include <string>
+#include "loggerClass.h"
+
+//TODO: Log is not saved in file in directory but in random file in main source folder
+class boostLogSink : public logSink {
+public:
+	/*!
+	 * @brief Method setting up whole logging class.
+	 * 
+	 * Adds file log, sets severity filter and installs boostLogSink with loggerClass::setSink().
+	 */
+	static void logInit();
+
+	void write(const std::string& input) override;
+
+	void writeEntityEvent(const std::string& entityName, const std::string& input) override;
+
+	void writeClientEvent(const std::string& bankName, std::uint32_t clientNumber, const std::string& input) override;
+};
+
+#endif /* LIB_BOOSTLOGSINK_BOOSTLOGSINK_H_ */
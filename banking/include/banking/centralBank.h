@@ -8,9 +8,43 @@
 #define LIB_CENTRALBANK_CENTRALBANK_H_
 
 #include "bank.h"
+#include "loanPolicy.h"
+#include "rateSnapshot.h"
 
 class centralBank : public bank {
 protected:
+	rateSeqlock publishedRate; ///< Interest rate for loan pricing, published whenever it changes
+
+	/*!
+	 * @brief Filling context for loan policies
+	 * 
+	 * @attention caller has to hold bank::bankMTX
+	 */
+	loanPolicyContext policyContext(loan *loanPtr) {
+		return loanPolicyContext {
+			loanPtr,
+			&this->diceBank,
+			this->currentTreasury,
+			this->totalTreasury,
+			this->interestRate,
+			false,
+			0
+		};
+	};
+
+	/*!
+	 * @brief Bookkeeping of granted loan
+	 * 
+	 * @attention caller has to hold bank::bankMTX
+	 */
+	void commitApprovedLoan(loan *loanPtr);
+
+	/*!
+	 * @brief Bookkeeping of rejected loan
+	 * 
+	 * @attention caller has to hold bank::bankMTX
+	 */
+	void commitRejectedLoan();
 
 public:
 	/*!
@@ -35,10 +69,28 @@ public:
 	 * @brief Method to adjust interest rate based on treasury to total treasury ratio.
 	 * 
 	 * Method adjust interest rate based on (current treasury / total treasury) ratio.
-	 * See CENTRAL_BANK::INTEREST_TO_TREASURY_RATE
+	 * See CENTRAL_BANK::INTEREST_TO_TREASURY_RATE. Changed rate is published as a new version for loan pricing.
 	 */
 	void adjustInterestRate() override;
 
+	/*!
+	 * @brief Reading the last published interest rate without lock, returns its version
+	 */
+	std::uint64_t readPublishedRate(double& rateOut) const {
+		return this->publishedRate.read(rateOut);
+	};
+
+	const rateSeqlock* getPublishedRate() const {
+		return &this->publishedRate;
+	};
+
+	/*!
+	 * @brief Returns number of interest rate publications so far
+	 */
+	std::uint64_t getRateVersion() const {
+		return this->publishedRate.getVersion();
+	};
+
 };
 
 #endif /* LIB_CENTRALBANK_CENTRALBANK_H_ */
@@ -0,0 +1,96 @@
+/*
+ * @brief Routing of centrally generated Local Clients to Local Banks
+ *
+ * Router keeps a compact index of all Local Banks: cached interest rate, open flag and the nearest open bank
+ * per bank and a table of the best-rate candidates. clientRouter::route() only reads these tables (atomics, no lock, constant
+ * time), clientRouter::refresh() rebuilds them from the banks in a single O(banks) pass and is meant to be
+ * called by one thread between batches of routed clients (every tick in simulationEngine). Policies:
+ * - **region** banks are split into ROUTING::REGIONS contiguous regions, client lives in a region chosen
+ * by hash of its number and is spread over open banks of that region
+ * - **rate** client goes to one of the open banks not paying their own loan with the lowest
+ * bank::getInterestRate() (all open banks if every one of them is paying), ties are spread by client number
+ * - **hash** jump consistent hash of the client number, so adding banks moves only 1 / banks of clients
+ *
+ * Failed Local Banks (economicParameters::isLocalBankFailed()) never receive clients.
+ */
+
+#ifndef LIB_CLIENTROUTER_CLIENTROUTER_H_
+#define LIB_CLIENTROUTER_CLIENTROUTER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include "economicParameters.h"
+#include "localBank.h"
+#include "../../constants.h"
+
+class clientRouter {
+
+public:
+	enum class policy {
+		REGION, ///< Hash of client number to region, spread inside the region
+		RATE, ///< The lowest cached interest rate
+		HASH ///< Jump consistent hash over all banks
+	};
+
+	static constexpr std::uint32_t NO_BANK {std::numeric_limits<std::uint32_t>::max()}; ///< Every Local Bank failed
+
+private:
+	policy routingPolicy; ///< Policy of the router
+	std::vector<localBank*> banks; ///< Routed Local Banks, index in this vector is the bank index
+	std::uint32_t regionsAmount; ///< Number of regions of **region** policy
+	std::unique_ptr<std::atomic<double>[]> cachedRates; ///< Interest rate of every bank at the last refresh
+	std::unique_ptr<std::atomic<bool>[]> openBanks; ///< False for failed banks
+	std::unique_ptr<std::atomic<std::uint32_t>[]> nextOpenBanks; ///< The first open bank from this index on, wrapping to the lowest open one
+	std::unique_ptr<std::atomic<std::uint32_t>[]> candidates; ///< Indexes of the best banks of **rate** policy
+	std::atomic<std::uint32_t> candidatesAmount; ///< Number of valid entries in **candidates**
+	std::atomic<std::uint32_t> openBanksAmount; ///< Number of banks which did not fail
+	std::vector<bool> payingBanks; ///< Banks paying their own loan at the last refresh, used only by the refreshing thread
+
+	clientRouter(policy policyArg, std::vector<localBank*> banksArg);
+
+public:
+	/*!
+	 * @brief Creating router of **banksArg** with **region**, **rate** or **hash** policy
+	 *
+	 * @return nullptr if policy name is unknown or there is no bank
+	 */
+	static std::unique_ptr<clientRouter> create(const std::string& policyName, std::vector<localBank*> banksArg);
+
+	/*!
+	 * @brief Returns index of the Local Bank of client **clientNumber**, NO_BANK if every bank failed
+	 *
+	 * Lock-free, safe to call from many threads, also while clientRouter::refresh() runs (then the client
+	 * may still go to a bank chosen by the previous refresh).
+	 */
+	std::uint32_t route(std::uint32_t clientNumber) const;
+
+	/*!
+	 * @brief Rebuilding cached rates, open flags, nearest open banks and candidates from the banks and **parameters**
+	 *
+	 * @attention only one thread may refresh at a time
+	 */
+	void refresh(const economicParameters& parameters);
+
+	localBank* getBank(std::uint32_t index) const {
+		return this->banks[index];
+	};
+
+	std::size_t getBanksAmount() const {
+		return this->banks.size();
+	};
+
+	double getCachedRate(std::uint32_t index) const {
+		return this->cachedRates[index].load(std::memory_order_relaxed);
+	};
+
+	/*!
+	 * @brief Jump consistent hash (Lamping, Veach) of **key** into [0, **buckets**)
+	 */
+	static std::uint32_t jumpHash(std::uint64_t key, std::uint32_t buckets);
+};
+
+#endif /* LIB_CLIENTROUTER_CLIENTROUTER_H_ */
@@ -0,0 +1,234 @@
+/*
+ * @brief Performance oriented variant of the bank / client hierarchy
+ *
+ * Same money flow as localClient -> localBank -> centralBank but without virtual calls:
+ * common bank code is shared through CRTP (compactBankBase), names are interned ids (see nameTable),
+ * loans are stored by value and fields touched by every installment are grouped in one cache line
+ * (bankHotState) while statistics live in bankColdStats. There is no per installment logging.
+ */
+
+#ifndef LIB_COMPACTBANK_COMPACTBANK_H_
+#define LIB_COMPACTBANK_COMPACTBANK_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "loan.h"
+#include "dice.h"
+#include "nameTable.h"
+#include "../../constants.h"
+
+/*!
+ * @brief Fields used on every installment, kept in a single cache line
+ */
+struct alignas(64) bankHotState {
+	mutable std::mutex bankMTX; ///< Mutex protecting the whole bank, getters take it too
+	double currentTreasury; ///< The current value of treasury
+	double totalTreasury; ///< The total value of treasury
+	double interestRate; ///< Current interest rate (spread for Local Bank)
+};
+
+/*!
+ * @brief Statistics which are not needed on the hot path
+ */
+struct bankColdStats {
+	double totalLoans {0}; ///< Number of processed loan applications
+	double totalValidLoans {0}; ///< Number of granted loan applications
+	std::uint64_t receivedInstallments {0}; ///< Number of received installments
+};
+
+template<class Derived>
+class compactBankBase {
+
+protected:
+	bankHotState hot; ///< Hot fields, see bankHotState
+	nameTable::entityId id; ///< Id of the bank name in nameTable
+	bankColdStats cold; ///< Cold statistics, see bankColdStats
+
+	compactBankBase(const std::string& nameArg, double totalTreasuryArg, double interestRateArg) :
+		id(nameTable::intern(nameArg))
+	{
+		this->hot.currentTreasury = totalTreasuryArg;
+		this->hot.totalTreasury = totalTreasuryArg;
+		this->hot.interestRate = interestRateArg;
+	};
+
+	Derived& derived() {
+		return static_cast<Derived&>(*this);
+	};
+
+public:
+	/*!
+	 * @brief Same as bank::receivePayment(), interest rate is adjusted by Derived::adjustInterestRate()
+	 */
+	void receivePayment(loan& loanArg) {
+		std::lock_guard<std::mutex> lock_guard1(this->hot.bankMTX);
+		this->hot.currentTreasury = this->hot.currentTreasury + loanArg.getSingleInstallmentValue();
+		this->derived().adjustInterestRate();
+		this->cold.receivedInstallments++;
+	};
+
+	nameTable::entityId getId() const {
+		return this->id;
+	};
+
+	const std::string& getName() const {
+		return nameTable::getName(this->id);
+	};
+
+	double getCurrentTreasury() const {
+		std::lock_guard<std::mutex> lock_guard1(this->hot.bankMTX);
+		return this->hot.currentTreasury;
+	};
+
+	double getTotalTreasury() const {
+		std::lock_guard<std::mutex> lock_guard1(this->hot.bankMTX);
+		return this->hot.totalTreasury;
+	};
+
+	std::uint64_t getReceivedInstallments() const {
+		std::lock_guard<std::mutex> lock_guard1(this->hot.bankMTX);
+		return this->cold.receivedInstallments;
+	};
+};
+
+class compactCentralBank : public compactBankBase<compactCentralBank> {
+
+	friend class compactBankBase<compactCentralBank>;
+
+protected:
+	/*!
+	 * @brief Same as centralBank::adjustInterestRate() without logging
+	 *
+	 * @attention caller has to hold bankHotState::bankMTX
+	 */
+	void adjustInterestRate() {
+		for (int i = 0; i < 10; i++) {
+			if (this->hot.currentTreasury / this->hot.totalTreasury <= CENTRAL_BANK::INTEREST_TO_TREASURY_RATE[0][i]) {
+				this->hot.interestRate = CENTRAL_BANK::INTEREST_TO_TREASURY_RATE[1][i];
+				break;
+			}
+		}
+	};
+
+public:
+	compactCentralBank() :
+		compactBankBase(CENTRAL_BANK::NAME, CENTRAL_BANK::STARTING_TREASURY, CENTRAL_BANK::INTEREST_TO_TREASURY_RATE[1][9])
+	{
+		this->adjustInterestRate();
+	};
+
+	double getInterestRate() const {
+		std::lock_guard<std::mutex> lock_guard1(this->hot.bankMTX);
+		return this->hot.interestRate;
+	};
+
+	/*!
+	 * @brief Same as centralBank::loanProcessingMethod() without logging
+	 */
+	void loanProcessingMethod(loan& loanArg) {
+		std::lock_guard<std::mutex> lock_guard2(this->hot.bankMTX);
+		this->cold.totalLoans++;
+		if (this->hot.currentTreasury > loanArg.getStartingValue()) {
+			loanArg.validateLoan();
+			loanArg.setAsReadyForPayment();
+			this->cold.totalValidLoans++;
+			this->hot.currentTreasury = this->hot.currentTreasury - loanArg.getStartingValue();
+			this->hot.totalTreasury = this->hot.totalTreasury + loanArg.getCost();
+			this->adjustInterestRate();
+		}
+	};
+};
+
+class compactLocalBank : public compactBankBase<compactLocalBank> {
+
+	friend class compactBankBase<compactLocalBank>;
+
+protected:
+	compactCentralBank* masterBankPtr; ///< Pointer to Central Bank
+	dice diceBank; ///< Dice used for loan validation
+
+	/*!
+	 * @brief Local Bank interest rate spread never changes
+	 */
+	void adjustInterestRate() {};
+
+public:
+	compactLocalBank(const std::string& nameArg, compactCentralBank* centralBankPtr) :
+		compactBankBase(nameArg, LOCAL_BANK::STARTING_TREASURY, LOCAL_BANK::INTEREST_RATE),
+		masterBankPtr(centralBankPtr),
+		diceBank(BANK::DICE_SIZE)
+	{};
+
+	/*!
+	 * @brief Spread of Local Bank never changes, only Central Bank rate is read under its lock
+	 */
+	double getInterestRate() const {
+		return this->hot.interestRate + this->masterBankPtr->getInterestRate();
+	};
+
+	/*!
+	 * @brief Simplified localBank::loanProcessingMethod()
+	 *
+	 * Uses the same dice rule, loans which do not fit in treasury are not granted
+	 * (compact variant does not borrow from Central Bank).
+	 */
+	void loanProcessingMethod(loan& loanArg) {
+		std::lock_guard<std::mutex> lock_guard2(this->hot.bankMTX);
+		this->cold.totalLoans++;
+		if ((this->diceBank.roll() + static_cast<int>(loanArg.getStartingValue()) % 3) >= LOAN_POLICY::DICE_THRESHOLD
+				&& this->hot.currentTreasury > loanArg.getStartingValue()) {
+			loanArg.setAsReadyForPayment();
+			this->cold.totalValidLoans++;
+			this->hot.currentTreasury = this->hot.currentTreasury - loanArg.getStartingValue();
+			this->hot.totalTreasury = this->hot.totalTreasury + loanArg.getCost();
+		}
+	};
+
+	/*!
+	 * @brief Paying single installment of **loanArg** to Central Bank
+	 */
+	void payToCentralBank(loan& loanArg) {
+		{
+			std::lock_guard<std::mutex> lock_guard1(this->hot.bankMTX);
+			this->hot.currentTreasury = this->hot.currentTreasury - loanArg.getSingleInstallmentValue();
+		}
+		this->masterBankPtr->receivePayment(loanArg);
+		loanArg.payAndUpdate();
+	};
+};
+
+class compactLocalClient {
+
+protected:
+	nameTable::entityId id; ///< Id of the client name in nameTable
+	compactLocalBank* masterBankPtr; ///< Pointer to Local Bank
+	loan clientLoan; ///< Client loan stored by value
+
+public:
+	compactLocalClient(nameTable::entityId idArg, compactLocalBank* localBankPtr, double loanValueArg, int instalmentsAmountArg) :
+		id(idArg),
+		masterBankPtr(localBankPtr),
+		clientLoan(loanValueArg, instalmentsAmountArg, localBankPtr->getInterestRate())
+	{};
+
+	loan& getLoan() {
+		return this->clientLoan;
+	};
+
+	nameTable::entityId getId() const {
+		return this->id;
+	};
+
+	/*!
+	 * @brief Same as localClient::paymentMethod()
+	 */
+	void paymentMethod() {
+		if (this->clientLoan.isReadyToBePayed()) {
+			this->masterBankPtr->receivePayment(this->clientLoan);
+			this->clientLoan.payAndUpdate();
+		}
+	};
+};
+
+#endif /* LIB_COMPACTBANK_COMPACTBANK_H_ */
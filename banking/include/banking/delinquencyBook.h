@@ -0,0 +1,123 @@
+/*
+ * @brief Aging buckets of delinquent loans of a single bank
+ *
+ * Loan becomes delinquent when its payer misses an installment. Every further consecutive miss ages it
+ * by one bucket (30, 60 and 90+ days past due, one installment period is LOAN::DAYS_PER_INSTALMENT days)
+ * and after LOAN::WRITE_OFF_MISSED_INSTALMENTS consecutive misses the loan is written off. Paid installment
+ * cures the loan. Loans age on their own due dates (payment attempts), so advancing time never sweeps
+ * the delinquent loans: every transition moves one loan between two buckets and updates per-bucket totals,
+ * which lending decisions read in O(1). Value left of a delinquent loan does not change until it is cured,
+ * so buckets keep only totals and no per-loan entries.
+ * Not thread safe, owner bank guards it with bank::bankMTX.
+ */
+
+#ifndef LIB_DELINQUENCYBOOK_DELINQUENCYBOOK_H_
+#define LIB_DELINQUENCYBOOK_DELINQUENCYBOOK_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "../../constants.h"
+
+class delinquencyBook {
+
+public:
+	/*!
+	 * @brief Totals of a single aging bucket
+	 */
+	struct bucket {
+		std::uint64_t loans {0}; ///< Number of loans in the bucket
+		double amount {0}; ///< Sum of values left of loans in the bucket
+	};
+
+private:
+	std::array<bucket, LOAN::DELINQUENCY_BUCKETS> buckets {}; ///< Bucket i holds loans (i + 1) * 30 days past due, the last one also older
+	std::uint64_t missedInstalments {0}; ///< Number of all missed installments
+	std::uint64_t curedLoans {0}; ///< Number of delinquent loans which were paid again
+	std::uint64_t writtenOffLoans {0}; ///< Number of written off loans
+	double writtenOffAmount {0}; ///< Sum of values left of written off loans
+
+	/*!
+	 * @brief Returns bucket of loan with **missed** consecutive missed installments (at least 1)
+	 */
+	static std::size_t bucketIndex(int missed) {
+		return static_cast<std::size_t>(std::min(missed, LOAN::DELINQUENCY_BUCKETS) - 1);
+	};
+
+	void remove(int missed, double amount) {
+		bucket& previous = this->buckets[delinquencyBook::bucketIndex(missed)];
+		previous.loans--;
+		previous.amount = previous.amount - amount;
+	};
+
+public:
+	/*!
+	 * @brief Loan with **amount** left missed its **missed**-th consecutive installment and stays on the books
+	 */
+	void recordMissed(int missed, double amount) {
+		this->missedInstalments++;
+		if (missed > 1) {
+			this->remove(missed - 1, amount);
+		}
+		bucket& current = this->buckets[delinquencyBook::bucketIndex(missed)];
+		current.loans++;
+		current.amount = current.amount + amount;
+	};
+
+	/*!
+	 * @brief Loan with **amount** left and **missed** consecutive missed installments was paid again
+	 */
+	void recordCured(int missed, double amount) {
+		this->remove(missed, amount);
+		this->curedLoans++;
+	};
+
+	/*!
+	 * @brief Loan with **amount** left missed its **missed**-th consecutive installment and is written off
+	 */
+	void recordWrittenOff(int missed, double amount) {
+		this->missedInstalments++;
+		if (missed > 1) {
+			this->remove(missed - 1, amount);
+		}
+		this->writtenOffLoans++;
+		this->writtenOffAmount = this->writtenOffAmount + amount;
+	};
+
+	/*!
+	 * @brief Returns totals of loans **daysPastDue** (30, 60, 90...) days past due
+	 */
+	const bucket& getBucket(int daysPastDue) const {
+		return this->buckets[delinquencyBook::bucketIndex(std::max(1, daysPastDue / LOAN::DAYS_PER_INSTALMENT))];
+	};
+
+	/*!
+	 * @brief Returns value left of all loans at least **daysPastDue** days past due
+	 */
+	double getDelinquentAmount(int daysPastDue) const {
+		double amount {0};
+		for (std::size_t i = delinquencyBook::bucketIndex(std::max(1, daysPastDue / LOAN::DAYS_PER_INSTALMENT));
+				i < this->buckets.size(); i++) {
+			amount = amount + this->buckets[i].amount;
+		}
+		return amount;
+	};
+
+	std::uint64_t getMissedInstalments() const {
+		return this->missedInstalments;
+	};
+
+	std::uint64_t getCuredLoans() const {
+		return this->curedLoans;
+	};
+
+	std::uint64_t getWrittenOffLoans() const {
+		return this->writtenOffLoans;
+	};
+
+	double getWrittenOffAmount() const {
+		return this->writtenOffAmount;
+	};
+};
+
+#endif /* LIB_DELINQUENCYBOOK_DELINQUENCYBOOK_H_ */
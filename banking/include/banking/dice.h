@@ -7,12 +7,102 @@
 #ifndef LIB_DICE_DICE_H_
 #define LIB_DICE_DICE_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
 class dice {
 
 private:
 	int size; ///< number if sides of the dice
 
+	static thread_local std::minstd_rand* threadEngine; ///< Generator of the calling thread, nullptr means **rand()**
+
+public:
+	class tape;
+
+private:
+	static thread_local tape* threadTape; ///< Tape of the calling thread, nullptr if rolls are neither recorded nor replayed
+
+	/*!
+	 * @brief Single roll in range 1 - **dice.size** from thread generator or **rand()**
+	 */
+	int draw() const;
+
 public:
+	/*!
+	 * @brief Deterministic dice rolls in the calling thread
+	 * 
+	 * While instance exists all dice rolled in the creating thread use its own generator seeded
+	 * with **seed** instead of shared **rand()**, so the same seed gives the same rolls regardless
+	 * of other threads. Previous generator of the thread is restored on destruction.
+	 */
+	class threadSeed {
+
+	private:
+		std::minstd_rand engine; ///< Generator used while instance exists
+		std::minstd_rand* previousEngine; ///< Generator restored on destruction
+
+	public:
+		explicit threadSeed(unsigned seed);
+		~threadSeed();
+		threadSeed(const threadSeed&) = delete;
+		threadSeed& operator=(const threadSeed&) = delete;
+	};
+
+	/*!
+	 * @brief Recording or replaying dice rolls of the calling thread
+	 * 
+	 * While recording tape exists every roll in the creating thread is drawn as usual and appended to the tape.
+	 * While replaying tape exists rolls are taken from the tape instead; when the tape runs out (replayed code
+	 * asked for more rolls than were recorded) rolls are drawn as usual and counted as misses.
+	 * Rolls are stored as single bytes, so only dice with up to 255 sides can be recorded.
+	 * Previous tape of the thread is restored on destruction.
+	 */
+	class tape {
+
+	private:
+		bool recording; ///< True for recording tape
+		std::vector<std::uint8_t> recorded; ///< Rolls drawn while recording
+		const std::uint8_t* replayed; ///< Rolls to replay, not owned
+		std::size_t replayedAmount; ///< Number of rolls in **replayed**
+		std::size_t position; ///< Next replayed roll
+		std::uint64_t misses; ///< Rolls asked for after the replayed ones ran out
+		tape* previousTape; ///< Tape restored on destruction
+
+		friend class dice;
+
+	public:
+		/*!
+		 * @brief Recording tape
+		 */
+		tape();
+
+		/*!
+		 * @brief Replaying **rollsAmount** rolls from **rolls**, which has to outlive the tape
+		 */
+		tape(const std::uint8_t* rolls, std::size_t rollsAmount);
+
+		~tape();
+		tape(const tape&) = delete;
+		tape& operator=(const tape&) = delete;
+
+		const std::vector<std::uint8_t>& getRecorded() const {
+			return this->recorded;
+		};
+
+		std::uint64_t getMisses() const {
+			return this->misses;
+		};
+
+		/*!
+		 * @brief Returns number of replayed rolls which were not used
+		 */
+		std::size_t getUnused() const {
+			return this->replayedAmount - this->position;
+		};
+	};
 
 	dice();
 
@@ -23,11 +113,18 @@ public:
 	dice(int size);
 
 	/*!
-	 * Method returns integer number between 1 and **dice.size** based on **rand()** 
+	 * Method returns integer number between 1 and **dice.size** based on **rand()** (see dice::threadSeed)
 	 */
 	int roll();
 
-	virtual ~dice();
+	/*!
+	 * @brief Rolling the dice **rollsAmount** times at once
+	 * 
+	 * Results are written to **rollsOut** which must have room for **rollsAmount** values
+	 */
+	void rollBatch(int* rollsOut, std::size_t rollsAmount);
+
+	~dice();
 };
 
 #endif /* LIB_DICE_DICE_H_ */
@@ -0,0 +1,45 @@
+/*
+ * @brief Immutable snapshot of external economic parameters
+ *
+ * Parameters which economicScenario shocks can change during a run. A snapshot is never modified after
+ * it is published (see bank::publishParameters()), readers only load a pointer to it, so shocks are
+ * visible to all threads without any lock on the hot path. Default snapshot reproduces constants.h.
+ */
+
+#ifndef LIB_ECONOMICPARAMETERS_ECONOMICPARAMETERS_H_
+#define LIB_ECONOMICPARAMETERS_ECONOMICPARAMETERS_H_
+
+#include <cstdint>
+#include <vector>
+#include "../../constants.h"
+
+struct economicParameters {
+	std::uint64_t epoch {0}; ///< Tick in which the snapshot was published
+	double loanValueMultiplier {LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER}; ///< Replaces LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER
+	double missedPaymentRate {LOCAL_CLIENT::MISSED_PAYMENT_RATE}; ///< Replaces LOCAL_CLIENT::MISSED_PAYMENT_RATE
+	/*!
+	 * @brief Central Bank interest rate set from outside, negative value means rate follows treasury
+	 */
+	double interestRateOverride {-1};
+	std::vector<bool> failedLocalBanks; ///< Local Banks (by index) which do not accept new clients any more
+	bool allLocalBanksFailed {false}; ///< No Local Bank accepts new clients any more
+
+	bool hasInterestRateOverride() const {
+		return this->interestRateOverride >= 0;
+	};
+
+	bool isLocalBankFailed(std::size_t localBankIndex) const {
+		return this->allLocalBanksFailed
+				|| (localBankIndex < this->failedLocalBanks.size() && this->failedLocalBanks[localBankIndex]);
+	};
+
+	/*!
+	 * @brief Snapshot used by banks which never got any other
+	 */
+	static const economicParameters* defaults() {
+		static const economicParameters defaultParameters {};
+		return &defaultParameters;
+	};
+};
+
+#endif /* LIB_ECONOMICPARAMETERS_ECONOMICPARAMETERS_H_ */
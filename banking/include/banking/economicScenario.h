@@ -0,0 +1,99 @@
+/*
+ * @brief Time series of external shocks applied to a simulation run
+ *
+ * Scenario file is loaded once and indexed by simulated tick. Every line schedules one shock:
+ * **<tick> <shock> <target> <value>**, lines starting with # are comments. Supported shocks:
+ * - **rate central <rate>** overrides Central Bank interest rate, negative rate goes back to treasury based rate
+ * - **inject <target> <amount>** adds amount to treasury (negative amount withdraws it)
+ * - **demand all <multiplier>** replaces LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER for new Local Clients
+ * - **fail <target> 0** Local Bank stops accepting new Local Clients
+ * - **delinquency all <rate>** replaces LOCAL_CLIENT::MISSED_PAYMENT_RATE (probability of a missed installment)
+ *
+ * Target is **central**, **local<N>** (Local Bank number N, counted from 1) or **all** (all Local Banks).
+ * Parameter shocks of a tick are folded into a single new economicParameters snapshot (one epoch per tick),
+ * older snapshots stay alive with the scenario so banks can keep reading them without locks.
+ */
+
+#ifndef LIB_ECONOMICSCENARIO_ECONOMICSCENARIO_H_
+#define LIB_ECONOMICSCENARIO_ECONOMICSCENARIO_H_
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "economicParameters.h"
+
+/*!
+ * @brief Single scheduled shock
+ */
+struct scenarioShock {
+	enum class type {
+		INTEREST_RATE, ///< Central Bank interest rate override
+		TREASURY_INJECTION, ///< Money added to (or taken from) treasury
+		DEMAND, ///< Loan value multiplier of new Local Clients
+		BANK_FAILURE, ///< Local Bank stops accepting new Local Clients
+		DELINQUENCY ///< Probability that Local Client misses an installment
+	};
+
+	static constexpr int CENTRAL_BANK_TARGET {-1}; ///< Target meaning Central Bank
+	static constexpr int ALL_LOCAL_BANKS_TARGET {-2}; ///< Target meaning every Local Bank
+
+	std::uint64_t tick; ///< Tick in which the shock is applied
+	type shockType; ///< Kind of the shock
+	int target; ///< Local Bank index (from 0), CENTRAL_BANK_TARGET or ALL_LOCAL_BANKS_TARGET
+	double value; ///< Rate, amount or multiplier, unused for BANK_FAILURE
+};
+
+class economicScenario {
+
+private:
+	std::vector<scenarioShock> shocks; ///< All shocks sorted by tick
+	std::size_t nextShock; ///< Index of the first shock not applied yet
+	std::vector<std::unique_ptr<const economicParameters>> snapshots; ///< All published snapshots, the last one is current
+
+	economicScenario(std::vector<scenarioShock> shocksArg);
+
+public:
+	/*!
+	 * @brief Parsing scenario from **input**
+	 *
+	 * @return nullptr if any line is malformed, **errorOut** describes the first error
+	 */
+	static std::unique_ptr<economicScenario> parse(std::istream& input, std::string& errorOut);
+
+	/*!
+	 * @brief Loading scenario file
+	 *
+	 * @return nullptr if the file cannot be read or is malformed, **errorOut** describes the error
+	 */
+	static std::unique_ptr<economicScenario> load(const std::string& fileName, std::string& errorOut);
+
+	/*!
+	 * @brief Returns shocks scheduled up to **tick** and not returned yet, in file order
+	 *
+	 * If any of them changes parameters, new snapshot is created and returned by economicScenario::getParameters().
+	 * Ticks have to be non-decreasing between calls.
+	 */
+	std::vector<scenarioShock> advance(std::uint64_t tick);
+
+	/*!
+	 * @brief Returns current snapshot, valid as long as the scenario exists
+	 */
+	const economicParameters* getParameters() const {
+		return this->snapshots.back().get();
+	};
+
+	/*!
+	 * @brief Returns true if no shock is left
+	 */
+	bool isFinished() const {
+		return this->nextShock == this->shocks.size();
+	};
+
+	const std::vector<scenarioShock>& getShocks() const {
+		return this->shocks;
+	};
+};
+
+#endif /* LIB_ECONOMICSCENARIO_ECONOMICSCENARIO_H_ */
@@ -0,0 +1,128 @@
+/*
+ * @brief Double-entry journal of all money transfers
+ *
+ * Opt-in auditing mode. Every change of a bank treasury is posted to the journal by the code doing
+ * the change, every transfer has two legs (money out of one account, money into another) so the sum
+ * of all account balances stays zero. Postings go to append-only per-thread buffers which are
+ * consumed by ledger::collect() (for example from ledgerAuditor thread), so recording never takes
+ * a lock shared with other threads. When auditing is disabled posting costs a single flag check.
+ */
+
+#ifndef LIB_LEDGER_LEDGER_H_
+#define LIB_LEDGER_LEDGER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "../../constants.h"
+
+class ledger {
+
+public:
+	using accountId = std::uint32_t;
+
+	static constexpr accountId EXTERNAL {0}; ///< Account of everything outside the banks (Local Clients)
+
+	/*!
+	 * @brief Single leg of a transfer
+	 */
+	struct posting {
+		accountId account; ///< Account the money goes into (positive amount) or out of (negative amount)
+		double amount; ///< Signed amount
+	};
+
+private:
+	static std::atomic<bool> enabled; ///< Global auditing switch
+
+public:
+	static bool isEnabled() {
+		return enabled.load(std::memory_order_relaxed);
+	};
+
+	/*!
+	 * @brief Enabling or disabling recording of new postings
+	 *
+	 * @attention banks post their opening balance when created, so auditing should be enabled before banks are created
+	 */
+	static void setEnabled(bool enabledArg) {
+		enabled.store(enabledArg, std::memory_order_relaxed);
+	};
+
+	/*!
+	 * @brief Returns new unique account id
+	 */
+	static accountId openAccount();
+
+	/*!
+	 * @brief Appending single leg to the buffer of the calling thread
+	 *
+	 * Positive **amount** is money coming into **account**.
+	 */
+	static void post(accountId account, double amount) {
+		if (ledger::isEnabled()) {
+			ledger::append(posting {account, amount});
+		}
+	};
+
+	/*!
+	 * @brief Posting both legs of a transfer of **amount** from **fromAccount** to **toAccount**
+	 */
+	static void transfer(accountId fromAccount, accountId toAccount, double amount) {
+		if (ledger::isEnabled()) {
+			ledger::append(posting {fromAccount, -amount});
+			ledger::append(posting {toAccount, amount});
+		}
+	};
+
+	/*!
+	 * @brief Appending posting to the buffer of the calling thread without checking ledger::isEnabled()
+	 */
+	static void append(const posting& postingArg);
+
+	/*!
+	 * @brief Applying all postings published so far by all threads to account balances
+	 *
+	 * Safe to call while other threads post. Journals of exited threads are freed once all their postings are applied.
+	 * @return number of applied postings
+	 */
+	static std::uint64_t collect();
+
+	/*!
+	 * @brief Returns number of per-thread journals kept by the ledger (threads still running or not fully collected)
+	 */
+	static std::size_t getJournalsAmount();
+
+	/*!
+	 * @brief Returns balance of **account** computed by ledger::collect() calls so far
+	 */
+	static double getBalance(accountId account);
+
+	/*!
+	 * @brief Returns sum of all account balances, zero (up to rounding) when no transfer is in progress
+	 */
+	static double getImbalance();
+
+	/*!
+	 * @brief Returns true if ledger::getImbalance() is zero up to LEDGER::RELATIVE_TOLERANCE of all balances
+	 */
+	static bool isBalanced();
+
+	/*!
+	 * @brief Returns number of postings applied by ledger::collect() so far
+	 */
+	static std::uint64_t getCollectedPostings();
+
+	/*!
+	 * @brief Returns true if **expected** and **actual** differ by no more than LEDGER::RELATIVE_TOLERANCE
+	 */
+	static bool isEqual(double expected, double actual);
+
+	/*!
+	 * @brief Collecting and forgetting all postings and balances
+	 *
+	 * @attention has to be called when no other thread posts
+	 */
+	static void clear();
+};
+
+#endif /* LIB_LEDGER_LEDGER_H_ */
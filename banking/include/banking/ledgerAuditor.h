@@ -0,0 +1,63 @@
+/*
+ * @brief Background verification of ledger balance
+ *
+ * Thread which periodically collects the ledger journal and compares ledger balance of every bank
+ * with its treasury (see bank::auditLedger()). Each bank is locked only for its own check, so the
+ * audit never stops the whole simulation.
+ */
+
+#ifndef LIB_LEDGERAUDITOR_LEDGERAUDITOR_H_
+#define LIB_LEDGERAUDITOR_LEDGERAUDITOR_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bank.h"
+#include "ledger.h"
+
+class ledgerAuditor {
+
+private:
+	std::vector<bank*> banks; ///< Audited banks
+	std::chrono::milliseconds interval; ///< Pause between two audit passes
+	std::uint64_t passes; ///< Number of finished audit passes
+	std::uint64_t failures; ///< Number of bank checks which found a mismatch
+	bool stopRequested; ///< Set by the destructor, protected by **stopMTX**
+	std::mutex stopMTX; ///< Protects **stopRequested**, **passes** and **failures**
+	std::condition_variable stopCondition; ///< Wakes the auditor thread when stop is requested
+	std::thread auditorThread; ///< Thread running ledgerAuditor::run()
+
+	void run();
+
+public:
+	/*!
+	 * @brief Starting auditor thread checking **banksArg** every **intervalArg**
+	 *
+	 * @attention ledger has to be enabled (see ledger::setEnabled()) before the banks were created
+	 */
+	ledgerAuditor(const std::vector<bank*>& banksArg, std::chrono::milliseconds intervalArg);
+
+	/*!
+	 * @brief Stopping and joining auditor thread
+	 */
+	~ledgerAuditor();
+
+	ledgerAuditor(const ledgerAuditor&) = delete;
+	ledgerAuditor& operator=(const ledgerAuditor&) = delete;
+
+	/*!
+	 * @brief Single audit pass over all banks, mismatches are logged
+	 *
+	 * @return number of banks whose ledger balance differs from treasury
+	 */
+	int auditPass();
+
+	std::uint64_t getPasses();
+
+	std::uint64_t getFailures();
+};
+
+#endif /* LIB_LEDGERAUDITOR_LEDGERAUDITOR_H_ */
@@ -2,16 +2,32 @@
  * @brief class simulating simple loan
  * 
  * Class responsibility is to simulate simple loan which does change its costs during its life cycle. 
+ * Loan interest rate is the rate for the whole loan, every installment period uses rate / starting installments.
+ * Installments follow the amortization schedule of the loan. Variable-rate loans (see loan::setRateReference())
+ * are repriced lazily by the paying thread: a payment only compares the reference rate version with the version
+ * the loan was priced at, remaining schedule is recomputed only when the rate moved to another LOAN::RATE_BUCKET.
  */
 
 #ifndef LIB_LIGHTLOAN_LIGHTLOAN_H_
 #define LIB_LIGHTLOAN_LIGHTLOAN_H_
 
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <mutex>
 #include <condition_variable>
 #include "loggerClass.h"
+#include "rateSnapshot.h"
+
+/*!
+ * @brief How installments of a loan are calculated
+ */
+enum class amortization {
+	EQUAL, ///< Equal installments, interest of the whole period on starting value
+	ANNUITY, ///< Equal installments, interest on value left, growing principal part
+	DECLINING ///< Equal principal parts, interest on value left, installments decrease
+};
 
 class loan {
 protected:
@@ -21,6 +37,33 @@ protected:
 	double singleInstalmentValue {0}; ///< Value of single loan installment
 	int startingInstalmentAmount {0}; ///< Amount of installments
 	int instalmentAmountLeft {0}; ///< Amount of installments left to be payed
+	double interestRate {0}; ///< Interest rate the loan was priced at
+	/*!
+	 * @brief Version of Central Bank rate the loan was priced at (see rateSeqlock), 0 if unknown
+	 *
+	 * Variable-rate loan keeps here the last reference rate version it checked.
+	 */
+	std::uint64_t rateVersion {0};
+	amortization schedule {amortization::EQUAL}; ///< How installments are calculated
+	double principalLeft {0}; ///< Part of loan.startingValue which is not payed yet
+	double singleInstalmentPrincipal {0}; ///< Part of the next installment which pays loan.principalLeft
+	const rateSeqlock* rateReference {nullptr}; ///< Rate followed by variable-rate loan, nullptr for fixed rate
+	double rateMargin {0}; ///< Interest rate minus reference rate, kept when the loan is repriced
+	std::int64_t rateBucket {0}; ///< LOAN::RATE_BUCKET of the reference rate the loan is priced at
+	int repricingsAmount {0}; ///< Number of times the remaining schedule was recomputed for a new rate
+	int missedInstalments {0}; ///< Consecutive installments missed by the payer, see delinquencyBook
+
+	/*!
+	 * @brief Recomputing loan.valueLeft, costs and next installment from loan.principalLeft and current rate
+	 */
+	void recomputeSchedule();
+
+	/*!
+	 * @brief Checking reference rate of variable-rate loan, repricing the loan if its bucket changed
+	 *
+	 * @return true if remaining schedule was recomputed
+	 */
+	bool followReferenceRate();
 	/*!
 	 * @brief Loan validation status
 	 * 
@@ -29,15 +72,17 @@ protected:
 	 * If remains false then loan should be deleted.
 	 * If set to true then loan should be check if it is ready for payment
 	 */
-	bool validated {false};
+	std::atomic<bool> validated {false};
 	/*!
 	 * @brief Loan payment readiness status
 	 * 
 	 * After loan is validated, it is waiting to be ready to be payed. 
 	 * This behavior is required for example when localBank accepted loan application 
 	 * from localClient but does not have enough money in treasury to grant the loan.
+	 * Set by bank thread and polled by client thread: release store in loan::setAsReadyForPayment()
+	 * pairs with acquire load in loan::isReadyToBePayed(), so the payer sees all bank writes made before granting.
 	 */
-	bool paymentReadiness {false};
+	std::atomic<bool> paymentReadiness {false};
 
 public:
 	/*!
@@ -46,31 +91,58 @@ public:
 	 * @param loanValueArg should be supplied by **client**
 	 * @param instalmentAmountArg should be supplied by **client**
 	 * @param interestRateArg should be supplied by **bank**
+	 * @param rateVersionArg version of Central Bank rate used in **interestRateArg**, see rateSnapshot
+	 * @param scheduleArg amortization of the loan
+	 */
+	loan(double loanValueArg, int instalmentsAmountArg, double interestRateArg, std::uint64_t rateVersionArg = 0,
+			amortization scheduleArg = amortization::EQUAL);
+
+	/*!
+	 * @brief Copying loan, status flags are copied by value
+	 * 
+	 * @attention source loan must not be modified by another thread while it is copied
 	 */
-	loan(double loanValueArg, int instalmentsAmountArg, double interestRateArg);
+	loan(const loan& other);
+
+	loan& operator=(const loan& other);
 
 	virtual ~loan();
 
 	/*!
-	 * The value is equal to (startingValue + cost) / startingInstalmentAmount.
+	 * @brief Parsing **equal**, **annuity** or **declining**, returns false on unknown name
+	 */
+	static bool parseSchedule(const std::string& scheduleName, amortization& scheduleOut);
+
+	/*!
+	 * @brief Calculating the next installment
+	 *
+	 * For amortization::EQUAL the value is equal to (startingValue + cost) / startingInstalmentAmount.
 	 */
 	void setSingleInstalmentValue();
 
+	/*!
+	 * @brief Making the loan variable-rate
+	 *
+	 * From now on loan.interestRate is **referenceArg** rate plus the current margin over **referenceRateArg**
+	 * (the reference rate the loan was priced with). Has to be called before the first payment.
+	 */
+	void setRateReference(const rateSeqlock* referenceArg, double referenceRateArg);
+
 	/*!
 	 * @brief Method responsible for paying single loan installment.
 	 * 
 	 * This method updates loan variables when client (localBank or localClient)
-	 *  is paying single installment.
+	 *  is paying single installment. Next installment of variable-rate loan uses the current reference rate.
 	 *  @attention if last installment amount is payed then loan.validated and loan.paymentReadiness are set to false
 	 */
 	bool payAndUpdate();
 
 	void validateLoan() {
-		this->validated = true;
+		this->validated.store(true, std::memory_order_release);
 	};
 
 	bool isLoanValid() {
-		return this->validated;
+		return this->validated.load(std::memory_order_acquire);
 	};
 
 	double getStartingValue() {
@@ -97,12 +169,62 @@ public:
 		return this->cost;
 	};
 
+	double getInterestRate() {
+		return this->interestRate;
+	};
+
+	std::uint64_t getRateVersion() {
+		return this->rateVersion;
+	};
+
+	amortization getSchedule() {
+		return this->schedule;
+	};
+
+	double getPrincipalLeft() {
+		return this->principalLeft;
+	};
+
+	bool isVariableRate() {
+		return this->rateReference != nullptr;
+	};
+
+	int getRepricingsAmount() {
+		return this->repricingsAmount;
+	};
+
+	int getMissedInstalments() {
+		return this->missedInstalments;
+	};
+
+	/*!
+	 * @brief Registering installment missed by the payer, returns number of consecutive missed installments
+	 */
+	int missInstalment() {
+		return ++this->missedInstalments;
+	};
+
+	/*!
+	 * @brief Clearing missed installments after the payer paid again
+	 */
+	void cure() {
+		this->missedInstalments = 0;
+	};
+
+	/*!
+	 * @brief Closing the loan without payment of the value left, loan.validated and loan.paymentReadiness are set to false
+	 */
+	void writeOff() {
+		this->validated.store(false, std::memory_order_release);
+		this->paymentReadiness.store(false, std::memory_order_release);
+	};
+
 	bool isReadyToBePayed() {
-		return this->paymentReadiness;
+		return this->paymentReadiness.load(std::memory_order_acquire);
 	};
 
 	void setAsReadyForPayment() {
-		this->paymentReadiness = true;
+		this->paymentReadiness.store(true, std::memory_order_release);
 	};
 
 //	void coutEvent(std::string stringArg) {
@@ -114,7 +236,10 @@ public:
 	 * 
 	 * Simple logging method. See logging:logEvent for more info
 	 */
-	void logEvent(std::string stringArg) {
+	void logEvent(const std::string& stringArg) {
+		if (loggerClass::isHeadless()) {
+			return;
+		}
 		loggerClass::logEvent("Loan event: " + stringArg);
 	};
 
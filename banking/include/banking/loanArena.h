@@ -0,0 +1,99 @@
+/*
+ * @brief Node-local storage of Local Client loans of a single Local Bank
+ *
+ * Loans are constructed in blocks of chunks of NUMA::ARENA_CHUNK_LOANS loans allocated on one NUMA node
+ * (see numaTopology::allocateOnNode()), so loan state of a bank stays next to its treasury and the threads
+ * serving it. Every block starts on its own cache line, loans of clients paying from different threads do
+ * not share lines. Released blocks are reused, chunks are freed only with the arena, which has to outlive
+ * all loans created in it. Thread safe.
+ */
+
+#ifndef LIB_LOANARENA_LOANARENA_H_
+#define LIB_LOANARENA_LOANARENA_H_
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include "loan.h"
+#include "profiledMutex.h"
+#include "../../constants.h"
+
+class loanArena {
+
+private:
+	static_assert(alignof(loan) <= NUMA::ARENA_BLOCK_ALIGNMENT, "loan blocks would be misaligned");
+
+	static constexpr std::size_t BLOCK_SIZE {(sizeof(loan) + NUMA::ARENA_BLOCK_ALIGNMENT - 1)
+			/ NUMA::ARENA_BLOCK_ALIGNMENT * NUMA::ARENA_BLOCK_ALIGNMENT}; ///< Size of a single loan block
+
+	/*!
+	 * @brief Released block, its memory holds the link to the next released block
+	 */
+	struct freeBlock {
+		freeBlock* next;
+	};
+
+	int node; ///< NUMA node of all chunks
+	profiledMutex arenaMTX {"loanArena mtx"}; ///< Guards **chunks**, **freeBlocks** and **usedBlocks**
+	std::vector<void*> chunks; ///< All allocated chunks
+	freeBlock* freeBlocks {nullptr}; ///< Blocks ready for reuse
+	std::size_t usedBlocks {0}; ///< Number of loans living in the arena
+
+	/*!
+	 * @brief Returns memory of one block, new chunk is allocated when no block is free
+	 *
+	 * @throw std::bad_alloc if chunk cannot be allocated
+	 */
+	void* allocateBlock();
+
+	void releaseBlock(void* block);
+
+public:
+	explicit loanArena(int nodeArg);
+	~loanArena();
+
+	loanArena(const loanArena&) = delete;
+	loanArena& operator=(const loanArena&) = delete;
+
+	/*!
+	 * @brief Constructing loan from **args** (loan constructor arguments) in a node-local block
+	 */
+	template<class... Args>
+	loan* create(Args&&... args) {
+		void* block = this->allocateBlock();
+		try {
+			return new (block) loan(std::forward<Args>(args)...);
+		} catch (...) {
+			this->releaseBlock(block);
+			throw;
+		}
+	};
+
+	/*!
+	 * @brief Destroying **loanPtr** created by loanArena::create() of this arena, nullptr is ignored
+	 */
+	void destroy(loan* loanPtr) {
+		if (loanPtr == nullptr) {
+			return;
+		}
+		loanPtr->~loan();
+		this->releaseBlock(loanPtr);
+	};
+
+	int getNode() const {
+		return this->node;
+	};
+
+	std::size_t getChunksAmount() {
+		profiledLock lock_guard1(this->arenaMTX);
+		return this->chunks.size();
+	};
+
+	std::size_t getUsedBlocks() {
+		profiledLock lock_guard1(this->arenaMTX);
+		return this->usedBlocks;
+	};
+};
+
+#endif /* LIB_LOANARENA_LOANARENA_H_ */
@@ -0,0 +1,130 @@
+/*
+ * @brief Loan approval policies
+ *
+ * Policies deciding whether loan application should be approved. Every policy is a struct with
+ * a single static **approve** method taking loanPolicyContext, so a chosen combination
+ * (see policyChain) is resolved and inlined at compile time by policyLocalBank and policyCentralBank.
+ */
+
+#ifndef LIB_LOANPOLICY_LOANPOLICY_H_
+#define LIB_LOANPOLICY_LOANPOLICY_H_
+
+#include "loan.h"
+#include "dice.h"
+#include "../../constants.h"
+
+/*!
+ * @brief Everything a policy may look at when deciding about a loan
+ *
+ * Filled by the bank while holding bank::bankMTX.
+ */
+struct loanPolicyContext {
+	loan* loanPtr; ///< Loan application
+	dice* diceBank; ///< Dice of the bank processing the application
+	double currentTreasury; ///< Current treasury of the bank
+	double totalTreasury; ///< Total treasury of the bank
+	double interestRate; ///< Interest rate offered to the applicant
+	bool hasOwnLoan; ///< True if the bank itself is paying a Central Bank loan
+	double delinquencyRatio; ///< Value left of loans LOAN_POLICY::RISK_DAYS_PAST_DUE past due divided by total treasury
+};
+
+/*!
+ * @brief Dice roll plus (loan value % 3) has to reach LOAN_POLICY::DICE_THRESHOLD
+ */
+struct diceThresholdPolicy {
+	static bool approve(const loanPolicyContext& context) {
+		return (context.diceBank->roll() + static_cast<int>(context.loanPtr->getStartingValue()) % 3)
+				>= LOAN_POLICY::DICE_THRESHOLD;
+	};
+};
+
+/*!
+ * @brief Bank does not lend while it is paying its own Central Bank loan
+ */
+struct noOwnLoanPolicy {
+	static bool approve(const loanPolicyContext& context) {
+		return !context.hasOwnLoan;
+	};
+};
+
+/*!
+ * @brief Bank lends only if it has more treasury than loan value
+ */
+struct treasuryFeasibilityPolicy {
+	static bool approve(const loanPolicyContext& context) {
+		return context.currentTreasury > context.loanPtr->getStartingValue();
+	};
+};
+
+/*!
+ * @brief Deterministic credit score based on loan size and length
+ *
+ * Bigger loans lower the score, more installments (smaller single installment) raise it.
+ */
+struct creditScoringPolicy {
+	static double score(const loanPolicyContext& context) {
+		return LOAN_POLICY::CREDIT_BASE_SCORE
+				- context.loanPtr->getStartingValue() / LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER * LOAN_POLICY::CREDIT_SCORE_PER_VALUE_STEP
+				+ context.loanPtr->getStartingInstalmentsAmount() * LOAN_POLICY::CREDIT_SCORE_PER_INSTALLMENT;
+	};
+
+	static bool approve(const loanPolicyContext& context) {
+		return creditScoringPolicy::score(context) >= LOAN_POLICY::CREDIT_MINIMAL_SCORE;
+	};
+};
+
+/*!
+ * @brief Treasury ratio after granting the loan has to stay above LOAN_POLICY::MINIMAL_TREASURY_RATIO
+ */
+struct treasuryRatioPolicy {
+	static bool approve(const loanPolicyContext& context) {
+		return (context.currentTreasury - context.loanPtr->getStartingValue())
+				>= context.totalTreasury * LOAN_POLICY::MINIMAL_TREASURY_RATIO;
+	};
+};
+
+/*!
+ * @brief Applicant resigns more often when interest rate is high
+ *
+ * Dice roll has to be bigger than interest rate scaled by BANK::DICE_SIZE and LOAN_POLICY::DEMAND_SENSITIVITY
+ */
+struct interestSensitiveDemandPolicy {
+	static bool approve(const loanPolicyContext& context) {
+		return context.diceBank->roll() > context.interestRate * BANK::DICE_SIZE * LOAN_POLICY::DEMAND_SENSITIVITY;
+	};
+};
+
+/*!
+ * @brief Bank stops lending while too much of its money is in seriously delinquent loans
+ *
+ * See delinquencyBook, ratio is kept up to date by the bank so the check is O(1).
+ */
+struct delinquencyRiskPolicy {
+	static bool approve(const loanPolicyContext& context) {
+		return context.delinquencyRatio <= LOAN_POLICY::MAXIMAL_DELINQUENCY_RATIO;
+	};
+};
+
+/*!
+ * @brief Combination of policies, loan is approved only if all of them approve it
+ *
+ * Policies are evaluated left to right and evaluation stops at the first rejection.
+ */
+template<class... Policies>
+struct policyChain {
+	static bool approve(const loanPolicyContext& context) {
+		return (Policies::approve(context) && ...);
+	};
+};
+
+/*!
+ * @brief Rule used by localBank::loanValidationMethod()
+ */
+using defaultLocalBankPolicy = policyChain<diceThresholdPolicy, noOwnLoanPolicy, delinquencyRiskPolicy>;
+
+/*!
+ * @brief Rule used by centralBank::loanProcessingMethod()
+ */
+using defaultCentralBankPolicy = treasuryFeasibilityPolicy;
+
+#endif /* LIB_LOANPOLICY_LOANPOLICY_H_ */
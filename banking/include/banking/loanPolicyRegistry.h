@@ -0,0 +1,117 @@
+/*
+ * @brief Runtime registry of loan policy combinations
+ * 
+ * Maps policy name to a factory creating policyLocalBank / policyCentralBank specialized
+ * for that policy, so the policy can be picked at runtime while every loan is still
+ * processed by compile time specialized code.
+ */
+
+#ifndef LIB_LOANPOLICYREGISTRY_LOANPOLICYREGISTRY_H_
+#define LIB_LOANPOLICYREGISTRY_LOANPOLICYREGISTRY_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <vector>
+#include "policyBank.h"
+
+/*!
+ * @brief Tag passed to loanPolicyRegistry::visitLocalBankType(), **type** is the concrete Local Bank class
+ */
+template<class Bank>
+struct localBankType {
+	using type = Bank;
+};
+
+class loanPolicyRegistry {
+
+public:
+	using diceLocalBank = policyLocalBank<defaultLocalBankPolicy>; ///< Local Bank registered as "dice"
+	using creditScoringLocalBank = policyLocalBank<
+			policyChain<noOwnLoanPolicy, creditScoringPolicy, delinquencyRiskPolicy>>; ///< Local Bank registered as "creditScoring"
+	using treasuryRatioLocalBank = policyLocalBank<
+			policyChain<noOwnLoanPolicy, treasuryRatioPolicy, diceThresholdPolicy, delinquencyRiskPolicy>>; ///< Local Bank registered as "treasuryRatio"
+	using interestSensitiveLocalBank = policyLocalBank<
+			policyChain<noOwnLoanPolicy, interestSensitiveDemandPolicy, delinquencyRiskPolicy>>; ///< Local Bank registered as "interestSensitive"
+	/*!
+	 * @brief Local Bank classes created by built-in policies, see visitLocalBankType()
+	 */
+	using builtInLocalBanks = std::tuple<localBank, diceLocalBank, creditScoringLocalBank, treasuryRatioLocalBank, interestSensitiveLocalBank>;
+
+	using localBankFactory = std::function<std::unique_ptr<localBank>(std::string, centralBank*)>;
+	using centralBankFactory = std::function<std::unique_ptr<centralBank>()>;
+
+private:
+	static std::map<std::string, localBankFactory>& localBankFactories();
+	static std::map<std::string, centralBankFactory>& centralBankFactories();
+
+	template<class Function, class... Banks>
+	static void visitLocalBankType(const localBank* localBankPtr, Function&& function, std::tuple<Banks...>*) {
+		bool visited = ((localBankPtr != nullptr && typeid(*localBankPtr) == typeid(Banks)
+				&& (function(localBankType<Banks>()), true)) || ...);
+		if (!visited) {
+			function(localBankType<localBank>());
+		}
+	};
+
+public:
+	/*!
+	 * @brief Registering **Policy** for Local Banks under **policyName**
+	 * 
+	 * Already registered name is overwritten.
+	 */
+	template<class Policy>
+	static void registerLocalBankPolicy(const std::string& policyName) {
+		localBankFactories()[policyName] = [](std::string nameArg, centralBank* centralBankPtr) {
+			return std::unique_ptr<localBank>(new policyLocalBank<Policy>(nameArg, centralBankPtr));
+		};
+	};
+
+	/*!
+	 * @brief Registering **Policy** for Central Bank under **policyName**
+	 * 
+	 * Already registered name is overwritten.
+	 */
+	template<class Policy>
+	static void registerCentralBankPolicy(const std::string& policyName) {
+		centralBankFactories()[policyName] = []() {
+			return std::unique_ptr<centralBank>(new policyCentralBank<Policy>());
+		};
+	};
+
+	/*!
+	 * @brief Creating Local Bank using policy registered as **policyName**
+	 * 
+	 * @return nullptr if **policyName** is not registered
+	 */
+	static std::unique_ptr<localBank> createLocalBank(const std::string& policyName, std::string nameArg, centralBank* centralBankPtr);
+
+	/*!
+	 * @brief Creating Central Bank using policy registered as **policyName**
+	 * 
+	 * @return nullptr if **policyName** is not registered
+	 */
+	static std::unique_ptr<centralBank> createCentralBank(const std::string& policyName);
+
+	/*!
+	 * @brief Calling **function** once with localBankType tag of the concrete class of **localBankPtr**
+	 * 
+	 * Lets callers instantiate their loan processing loop on the concrete class once per run, so every
+	 * loan goes through the final (inlined) policyLocalBank methods instead of virtual calls. Classes which
+	 * are not in builtInLocalBanks (policies registered with registerLocalBankPolicy()) and nullptr are
+	 * visited as localBank.
+	 */
+	template<class Function>
+	static void visitLocalBankType(const localBank* localBankPtr, Function&& function) {
+		visitLocalBankType(localBankPtr, function, static_cast<builtInLocalBanks*>(nullptr));
+	};
+
+	static std::vector<std::string> getLocalBankPolicyNames();
+
+	static std::vector<std::string> getCentralBankPolicyNames();
+};
+
+#endif /* LIB_LOANPOLICYREGISTRY_LOANPOLICYREGISTRY_H_ */
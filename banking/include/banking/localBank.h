@@ -6,10 +6,17 @@
 
 #ifndef LIB_LOCALBANK_LOCALBANK_H_
 #define LIB_LOCALBANK_LOCALBANK_H_
+#include <algorithm>
 #include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include "bank.h"
 #include "client.h"
 #include "centralBank.h"
+#include "loanPolicy.h"
+#include "delinquencyBook.h"
+#include "loanArena.h"
 
 class localBank : public bank, public client {
 
@@ -25,10 +32,65 @@ protected:
 	double amountNeededForLoans;
 	centralBank* masterBankPtr; ///< Pointer to Central Bank
 	std::vector<loan*> waitingLoans; ///< Vector of validated loans 
+	amortization loanSchedule {amortization::EQUAL}; ///< Amortization of loans offered to Local Clients
+	bool variableRateLoans {false}; ///< If true Local Client loans follow Central Bank rate
+	delinquencyBook delinquentLoans; ///< Aging buckets of Local Client loans with missed installments, guarded by bank::bankMTX
+	int numaNode {-1}; ///< NUMA node the bank is placed on, -1 if it is not placed
+	std::unique_ptr<loanArena> clientLoanArena; ///< Node-local storage of Local Client loans, nullptr if the bank is not placed
+
+	/*!
+	 * @brief Returns value left of loans LOAN_POLICY::RISK_DAYS_PAST_DUE past due divided by total treasury
+	 *
+	 * @attention caller has to hold bank::bankMTX
+	 */
+	double delinquencyRatio() {
+		return this->delinquentLoans.getDelinquentAmount(LOAN_POLICY::RISK_DAYS_PAST_DUE) / this->totalTreasury;
+	};
+
+	/*!
+	 * @brief Filling context for loan policies
+	 * 
+	 * @attention caller has to hold bank::bankMTX
+	 */
+	loanPolicyContext policyContext(loan *loanPtr) {
+		return loanPolicyContext {
+			loanPtr,
+			&this->diceBank,
+			this->currentTreasury,
+			this->totalTreasury,
+			this->interestRate + this->masterBankPtr->bank::getInterestRate(),
+			this->clientLoanPtr->isLoanValid(),
+			this->delinquencyRatio()
+		};
+	};
+
+	/*!
+	 * @brief Bookkeeping of approved loan
+	 * 
+	 * Loan is granted from treasury or, if treasury is too small, added to localBank.waitingLoans.
+	 * @attention caller has to hold bank::bankMTX
+	 */
+	void commitApprovedLoan(loan *loanPtr);
+
+	/*!
+	 * @brief Bookkeeping of rejected loan
+	 * 
+	 * @attention caller has to hold bank::bankMTX
+	 */
+	void commitRejectedLoan();
+
+	/*!
+	 * @brief Bookkeeping of a batch of applications, **valid**[i] is 1 for approved **loanPtrs**[i]
+	 * 
+	 * Approved loans are granted from treasury in application order as long as treasury allows
+	 * (the accepted prefix, see localBank::countFeasible()), remaining approved loans go to localBank.waitingLoans.
+	 * @attention caller has to hold bank::bankMTX
+	 */
+	void commitBatch(const std::vector<loan*>& loanPtrs, const std::uint8_t* valid);
 
 public:
 	localBank();
-	localBank(std::string nameArg, centralBank* masterBankPtr);
+	localBank(const std::string& nameArg, centralBank* masterBankPtr);
 
 	~localBank();
 
@@ -45,6 +107,20 @@ public:
 	 */
 	void loanProcessingMethod(loan *loanPtr) override;
 
+	/*!
+	 * @brief Processing many loan applications at once
+	 * 
+	 * Batch version of localBank::loanProcessingMethod(). All dice rolls are drawn in bulk,
+	 * validation and treasury feasibility are evaluated by plain loops over contiguous arrays
+	 * (see localBank::validateBatch() and localBank::countFeasible()) and everything is committed
+	 * in one locked section with one summary log line.
+	 * 
+	 * Validated loans are granted from treasury in application order as long as treasury allows
+	 * (the accepted prefix), remaining validated loans go to localBank.waitingLoans.
+	 * Overridden by policyLocalBank, which validates every loan with its policy instead of the dice kernel.
+	 */
+	virtual void loanProcessingBatch(const std::vector<loan*>& loanPtrs);
+
 	/*!
 	 * @brief Applying for new loan
 	 * 
@@ -63,11 +139,28 @@ public:
 	 */
 	virtual bool loanValidationMethod(loan *loanPtr);
 
+	/*!
+	 * @brief Validation kernel used by localBank::loanProcessingBatch()
+	 * 
+	 * Sets **validOut**[i] to 1 if dice roll and loan value pass the same rule
+	 * as in localBank::loanValidationMethod(), otherwise to 0.
+	 */
+	static void validateBatch(const int* rolls, const double* values, std::uint8_t* validOut, std::size_t loansAmount);
+
+	/*!
+	 * @brief Treasury feasibility kernel used by localBank::loanProcessingBatch()
+	 * 
+	 * **cumulativeValues** has to be non-decreasing (inclusive prefix sum of validated loan values).
+	 * Returns amount of leading loans which can be granted from **treasury**.
+	 */
+	static std::size_t countFeasible(const double* cumulativeValues, std::size_t loansAmount, double treasury);
+
 	/*!
 	 * @brief Local Bank payment method
 	 * 
 	 * Payment method reduces current treasure by one Local Bank loan 
-	 * installment amount and updates the loan data
+	 * installment amount and updates the loan data.
+	 * Whole payment is done under bank::bankMTX (Central Bank lock is taken inside it).
 	 */
 	void paymentMethod() override;
 	
@@ -107,6 +200,87 @@ public:
 		return (this->interestRate + this->masterBankPtr->getInterestRate());
 	};
 
+	/*!
+	 * @brief Registering installment of **loanPtr** missed by its Local Client
+	 *
+	 * Loan ages by one delinquencyBook bucket. After LOAN::WRITE_OFF_MISSED_INSTALMENTS consecutive misses
+	 * it is written off: value left is removed from bank::totalTreasury and the loan is closed (loan::writeOff()).
+	 * Called by the paying thread.
+	 * @return true if the loan was written off
+	 */
+	bool reportMissedPayment(loan* loanPtr);
+
+	/*!
+	 * @brief Registering that Local Client of delinquent **loanPtr** pays again, called before the installment is paid
+	 */
+	void reportCuredLoan(loan* loanPtr);
+
+	/*!
+	 * @brief Returns copy of delinquency aging buckets
+	 */
+	delinquencyBook getDelinquencyBook() {
+		profiledLock lock_guard1(this->bankMTX);
+		return this->delinquentLoans;
+	};
+
+	/*!
+	 * @brief Setting amortization and rate type of loans offered to new Local Clients
+	 *
+	 * @attention has to be called before Local Clients are created
+	 */
+	void setLoanTerms(amortization scheduleArg, bool variableRateArg) {
+		this->loanSchedule = scheduleArg;
+		this->variableRateLoans = variableRateArg;
+	};
+
+	/*!
+	 * @brief Placing the bank on NUMA node **nodeArg** (see numaTopology), loans of new Local Clients are created in node-local loanArena
+	 *
+	 * @attention has to be called before Local Clients are created, the bank has to outlive them
+	 */
+	void setNumaNode(int nodeArg) {
+		this->numaNode = nodeArg;
+		this->clientLoanArena.reset(new loanArena(nodeArg));
+	};
+
+	int getNumaNode() const {
+		return this->numaNode;
+	};
+
+	/*!
+	 * @brief Returns storage of Local Client loans, nullptr if loans are allocated on the heap
+	 */
+	loanArena* getLoanArena() const {
+		return this->clientLoanArena.get();
+	};
+
+	amortization getLoanSchedule() const {
+		return this->loanSchedule;
+	};
+
+	bool isVariableRateLoans() const {
+		return this->variableRateLoans;
+	};
+
+	/*!
+	 * @brief Rate followed by variable-rate Local Client loans (published Central Bank rate)
+	 */
+	const rateSeqlock* getRateReference() const {
+		return this->masterBankPtr->getPublishedRate();
+	};
+
+	/*!
+	 * @brief Rate for loan pricing: published Central Bank rate and its version plus Local Bank spread
+	 *
+	 * Same value as localBank::getInterestRate() without locks and virtual calls.
+	 */
+	rateSnapshot getRateSnapshot() const {
+		rateSnapshot snapshot;
+		snapshot.version = this->masterBankPtr->readPublishedRate(snapshot.centralRate);
+		snapshot.spread = this->interestRate.load(std::memory_order_relaxed);
+		return snapshot;
+	};
+
 	/*!
 	 * @brief Method which determines if Local Bank should ask for loan
 	 * 
@@ -114,7 +288,7 @@ public:
 	 * is bigger than fixed value LOCAL_BANK::THRESHOLD_FOR_LOAN
 	 */
 	bool shouldApplyForLoan() {
-		std::lock_guard<std::mutex> lock_guard2(this->bankMTX);
+		profiledLock lock_guard2(this->bankMTX);
 		return (this->amountNeededForLoans >= this->neededAmountThreshold);
 	};
 
@@ -122,23 +296,42 @@ public:
 	 * @brief Method increasing treasury when Central Bank grants loan to Local Bank
 	 */
 	void increaseTreasury() {
-		std::lock_guard<std::mutex> lock_guard2(this->bankMTX);
+		profiledLock lock_guard2(this->bankMTX);
 		this->currentTreasury = this->currentTreasury + this->amountNeededForLoans;
+		ledger::transfer(ledger::EXTERNAL, this->treasuryAccount, this->amountNeededForLoans);
 		this->totalTreasury = this->totalTreasury + this->amountNeededForLoans;
 		this->amountNeededForLoans = 0;
 	};
 
+	/*!
+	 * @brief Returns true if **loanPtr** was validated but still waits in localBank.waitingLoans for Central Bank money
+	 */
+	bool isLoanWaiting(const loan *loanPtr) {
+		profiledLock lock_guard2(this->bankMTX);
+		return std::find(this->waitingLoans.begin(), this->waitingLoans.end(), loanPtr) != this->waitingLoans.end();
+	};
+
 	centralBank* getMasterBankPtr() {
 		return masterBankPtr;
 	};
 
-	std::string getName() {
-		return this->name;
+	/*!
+	 * @brief Returns true while Local Bank is paying Central Bank loan
+	 * 
+	 * Local Bank loan is replaced by localBank::generateLoan() from Local Client threads, so it is
+	 * checked under bank::bankMTX instead of through client::getLoanPtr()
+	 */
+	bool isPayingLoan() {
+		profiledLock lock_guard2(this->bankMTX);
+		return this->clientLoanPtr->isReadyToBePayed();
 	};
 
-	double getCurrentTreasury() {
-		return this->currentTreasury;
-	};
+	/*!
+	 * @brief Removing **loanPtr** from localBank.waitingLoans when its client resigns
+	 * 
+	 * @return false if loan is not waiting (it was granted in the meantime or never added)
+	 */
+	bool cancelWaitingLoan(loan *loanPtr);
 
 	/*!
 	 * @brief setter needed for tests
@@ -7,27 +7,49 @@
 #ifndef LIB_LOCALCLIENT_LOCALCLIENT_H_
 #define LIB_LOCALCLIENT_LOCALCLIENT_H_
 
+#include <cstdint>
+#include <limits>
 #include <mutex>
 #include "client.h"
+#include "profiledMutex.h"
 #include "localBank.h"
 
 class localClient : public client {
 
 protected:
-	std::string name; ///< Name needed for logs
+	nameTable::entityId nameId; ///< Id of the client name in nameTable, localClient::NO_NAME if client is identified by number only
+	std::uint32_t clientNumber; ///< Number of the client, used in logs when client has no name
 	localBank* masterBankPtr; ///< Pointer to Local Bank
-	std::mutex mtx; ///< Mutex
+	profiledMutex mtx {"localClient mtx"}; ///< Mutex
+	loanArena* loanArenaPtr {nullptr}; ///< Arena of client::clientLoanPtr (see localBank::getLoanArena()), nullptr if it is on the heap
+
+	localClient(nameTable::entityId nameIdArg, std::uint32_t clientNumberArg, localBank* localBankPtr);
+
+	/*!
+	 * @brief Rolling whether the next installment is missed, see economicParameters::missedPaymentRate
+	 *
+	 * No dice is rolled while the rate is 0.
+	 */
+	bool missesInstallment();
 
 public:
+	static constexpr nameTable::entityId NO_NAME {std::numeric_limits<nameTable::entityId>::max()}; ///< nameId of clients without name
+
 	/*!
 	 * @Constructor
 	 * 
-	 * Creating new local CLient also generate and create new loan
+	 * Creating new local CLient also generate and create new loan. Client is identified
+	 * by **clientNumberArg** and its Local Bank, no name is stored.
 	 * @see localClient::generateTotalInstalmentsAmount()
 	 * @see localClient::generateTotalLoanValue()
 	 * @see localClient::generateLoan()
 	 */
-	localClient(std::string nameArg, localBank* localBankPtr);
+	localClient(std::uint32_t clientNumberArg, localBank* localBankPtr);
+
+	/*!
+	 * @brief Creating named Local Client, **nameArg** is interned in nameTable
+	 */
+	localClient(const std::string& nameArg, localBank* localBankPtr);
 
 	~localClient();
 
@@ -35,19 +57,52 @@ public:
 		return masterBankPtr;
 	};
 
-	void coutEvent(std::string stringArg) {
-		std::cout << this->name << " event: " << stringArg << std::endl;
+	std::uint32_t getClientNumber() {
+		return clientNumber;
+	};
+
+	/*!
+	 * @brief Rendering client name, meant only for human readable output
+	 */
+	std::string getName() {
+		if (this->nameId != NO_NAME) {
+			return nameTable::getName(this->nameId);
+		}
+		return this->masterBankPtr->getName() + "-Local Client-" + std::to_string(this->clientNumber);
+	};
+
+	void coutEvent(const std::string& stringArg) {
+		if (loggerClass::isHeadless()) {
+			return;
+		}
+		std::cout << this->getName() << " event: " << stringArg << std::endl;
 	};
 
-	void logEvent(std::string stringArg) {
-		loggerClass::logEvent(this->name + " event: " + stringArg);
+	void logEvent(const std::string& stringArg) {
+		if (this->nameId != NO_NAME) {
+			loggerClass::logEvent(this->nameId, stringArg);
+		} else {
+			loggerClass::logClientEvent(this->masterBankPtr->getId(), this->clientNumber, stringArg);
+		}
+	};
+
+	/*!
+	 * @brief Same as logEvent(const std::string&), string is not built in headless mode
+	 */
+	void logEvent(const char* stringArg) {
+		if (loggerClass::isHeadless()) {
+			return;
+		}
+		this->logEvent(std::string(stringArg));
 	};
 
 	/*!
 	 * @Local Client payment method
 	 * 
 	 * Local Client is the point where money is simulation in produced. 
-	 * Local Client is adding money to the simulation by paying loan costs
+	 * Local Client is adding money to the simulation by paying loan costs.
+	 * Installment may be missed (see localBank::reportMissedPayment()), missed installments are not
+	 * payed later, the loan is paid off with the following installments or written off.
 	 */
 	void paymentMethod() override;
 
@@ -63,6 +118,8 @@ public:
 
 	/*!
 	 * @brief Generating new loan based on client data and Local Bank interest rate
+	 *
+	 * Rate is taken from localBank::getRateSnapshot(), loan keeps its version.
 	 */
 	void generateLoan() override;
 };
@@ -1,30 +1,49 @@
 /*
  * @brief Simple logging class
  * 
- * Logging class based on boost/log library. Thread safe.
+ * Thin logging interface of the banking core. Events are formatted by the installed logSink
+ * (see loggerClass::setSink()), the Boost.Log backend lives in the banking_io library
+ * (see boostLogSink), so the core does not depend on any logging library. Thread safe.
  */
 
 #ifndef LOGGING_INCLUDE_LOGGING_LOGGING_H_
 #define LOGGING_INCLUDE_LOGGING_LOGGING_H_
 
-#include <boost/log/core/core.hpp>
-#include <boost/log/core.hpp>
-#include <boost/log/expressions.hpp>
-#include <boost/log/sinks/text_file_backend.hpp>
-#include <boost/log/sources/record_ostream.hpp>
-#include <boost/log/sources/severity_logger.hpp>
-#include <boost/log/trivial.hpp>
-#include <boost/log/utility/setup/common_attributes.hpp>
-#include <boost/log/utility/setup/console.hpp>
-#include <boost/log/utility/setup/file.hpp>
-#include <iostream>
-#include <fstream>
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include "nameTable.h"
+
+/*!
+ * @brief Output of loggerClass events
+ * 
+ * Methods can be called from many threads at once.
+ */
+class logSink {
+public:
+	virtual ~logSink() {};
+
+	/*!
+	 * @brief Writing plain event
+	 */
+	virtual void write(const std::string& input) = 0;
+
+	/*!
+	 * @brief Writing "<entityName> event: <input>"
+	 */
+	virtual void writeEntityEvent(const std::string& entityName, const std::string& input) = 0;
+
+	/*!
+	 * @brief Writing "<bankName>-Local Client-<clientNumber> event: <input>"
+	 */
+	virtual void writeClientEvent(const std::string& bankName, std::uint32_t clientNumber, const std::string& input) = 0;
+};
 
-//TODO: Log is not saved in file in directory but in random file in main source folder
 class loggerClass {
 private:
-	std::string fileName; ///< Name of the log file.
+	static std::atomic<bool> headless; ///< If true no event is logged, see loggerClass::setHeadless()
+	static std::atomic<std::uint64_t> eventCount; ///< Number of events not skipped in headless mode
+	static std::atomic<logSink*> sink; ///< Output of events, nullptr drops them
 
 public:
 
@@ -33,16 +52,61 @@ public:
 	virtual ~loggerClass();
 
 	/*!
-	 * @brief Method setting up whole logging class.
+	 * @brief Installing output of all events
+	 * 
+	 * **sinkArg** is not owned and has to outlive logging, nullptr drops events (they are still counted).
+	 * Boost.Log output is installed by boostLogSink::logInit().
 	 */
-	static void logInit();
+	static void setSink(logSink* sinkArg) {
+		sink.store(sinkArg, std::memory_order_release);
+	};
+
+	static logSink* getSink() {
+		return sink.load(std::memory_order_acquire);
+	};
 
 	/*!
 	 * @brief Simple logging method
 	 * 
-	 * Method to log desired info to output set by logging::logInit().
+	 * Method to log desired info to output set by loggerClass::setSink().
 	 */
-	static void logEvent(std::string input);
+	static void logEvent(const std::string& input);
+
+	/*!
+	 * @brief Logging event of an entity
+	 * 
+	 * Logs "<entity name> event: <input>". Entity name is taken from nameTable
+	 * and streamed directly, without building temporary strings.
+	 */
+	static void logEvent(nameTable::entityId entityIdArg, const std::string& input);
+
+	/*!
+	 * @brief Logging event of a Local Client identified by its bank and number
+	 * 
+	 * Logs "<bank name>-Local Client-<clientNumber> event: <input>".
+	 */
+	static void logClientEvent(nameTable::entityId bankIdArg, std::uint32_t clientNumber, const std::string& input);
+
+	/*!
+	 * @brief Switching headless mode
+	 * 
+	 * In headless mode all logEvent methods return immediately and nothing is written.
+	 * Meant for throughput runs where only end of run statistics are wanted.
+	 */
+	static void setHeadless(bool headlessArg) {
+		headless.store(headlessArg, std::memory_order_relaxed);
+	};
+
+	static bool isHeadless() {
+		return headless.load(std::memory_order_relaxed);
+	};
+
+	/*!
+	 * @brief Returns number of events logged so far (events skipped in headless mode are not counted)
+	 */
+	static std::uint64_t getEventCount() {
+		return eventCount.load(std::memory_order_relaxed);
+	};
 
 	/*!
 	 * @brief Test method used in debugging
@@ -50,4 +114,16 @@ public:
 	static void logTest();
 };
 
+/*!
+ * @brief Logging **message** with **logMethod** (e.g. this->logEvent), **message** is not even built in headless mode
+ * 
+ * Use it for events formatted from numbers, so throughput runs do not pay for strings nobody reads.
+ */
+#define LOG_EVENT_LAZY(logMethod, message) \
+	do { \
+		if (!loggerClass::isHeadless()) { \
+			logMethod(message); \
+		} \
+	} while (0)
+
 #endif /* LOGGING_INCLUDE_LOGGING_LOGGING_H_ */
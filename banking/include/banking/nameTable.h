@@ -0,0 +1,37 @@
+/*
+ * @brief Table of interned entity names
+ * 
+ * Every name is stored once and referred to by compact integer id. Names are needed only
+ * when rendering human readable output, hot code keeps ids.
+ */
+
+#ifndef LIB_NAMETABLE_NAMETABLE_H_
+#define LIB_NAMETABLE_NAMETABLE_H_
+
+#include <cstdint>
+#include <string>
+
+class nameTable {
+
+public:
+	using entityId = std::uint32_t;
+
+	/*!
+	 * @brief Returns id of **nameArg**, adding it to the table if it is not there yet
+	 */
+	static entityId intern(const std::string& nameArg);
+
+	/*!
+	 * @brief Returns name stored under **id**
+	 * 
+	 * Returned reference stays valid for the whole program run.
+	 */
+	static const std::string& getName(entityId id);
+
+	/*!
+	 * @brief Returns number of interned names
+	 */
+	static std::size_t size();
+};
+
+#endif /* LIB_NAMETABLE_NAMETABLE_H_ */
@@ -0,0 +1,75 @@
+/*
+ * @brief NUMA nodes of the machine, thread pinning and node-local memory
+ *
+ * Topology is read once: from libnuma when the library is built in (ECONOMY2_NUMA) and the kernel
+ * supports it, otherwise from sysfs node directories, otherwise the machine is a single node with
+ * all hardware threads. Threads are pinned with sched_setaffinity to all CPUs of a node, memory is
+ * allocated with numa_alloc_onnode (without libnuma it is plain memory placed by first touch, which
+ * is node-local when it is touched by a pinned thread).
+ */
+
+#ifndef LIB_NUMATOPOLOGY_NUMATOPOLOGY_H_
+#define LIB_NUMATOPOLOGY_NUMATOPOLOGY_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class numaTopology {
+
+private:
+	std::vector<std::vector<int>> nodeCpus; ///< CPUs of every node, nodes without CPUs are skipped
+	std::vector<int> systemNodes; ///< Operating system number of every node in **nodeCpus**
+	std::string source; ///< Where the topology comes from: libnuma, sysfs or single
+
+	numaTopology();
+
+	static const numaTopology& instance();
+
+public:
+	/*!
+	 * @brief Returns number of nodes with CPUs (at least 1)
+	 *
+	 * Nodes are numbered from 0 to this value - 1 in all numaTopology methods, independently of operating system numbers.
+	 */
+	static int getNodesAmount();
+
+	/*!
+	 * @brief Returns CPUs of **node**
+	 */
+	static const std::vector<int>& getNodeCpus(int node);
+
+	/*!
+	 * @brief Returns libnuma, sysfs or single
+	 */
+	static const std::string& getSource();
+
+	/*!
+	 * @brief Node of Local Bank **localBankIndex** out of **localBanksAmount**, banks are split into contiguous equal blocks
+	 */
+	static int nodeOfLocalBank(std::size_t localBankIndex, std::size_t localBanksAmount);
+
+	/*!
+	 * @brief Pinning calling thread to CPUs of **node**, negative node unpins it (all CPUs of all nodes)
+	 *
+	 * Thread remembers its node, pinning to the same node again costs no system call.
+	 * @return false if the affinity cannot be set
+	 */
+	static bool pinCurrentThread(int node);
+
+	/*!
+	 * @brief Returns node the calling thread is pinned to, -1 if it is not pinned
+	 */
+	static int getPinnedNode();
+
+	/*!
+	 * @brief Allocating **size** bytes on **node**, returns nullptr on failure
+	 *
+	 * Memory has to be released with numaTopology::freeOnNode() with the same size.
+	 */
+	static void* allocateOnNode(std::size_t size, int node);
+
+	static void freeOnNode(void* memory, std::size_t size);
+};
+
+#endif /* LIB_NUMATOPOLOGY_NUMATOPOLOGY_H_ */
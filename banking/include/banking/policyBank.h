@@ -0,0 +1,85 @@
+/*
+ * @brief Banks with loan approval policy chosen at compile time
+ * 
+ * policyLocalBank and policyCentralBank take approval policy (see loanPolicy.h) as template parameter.
+ * Their loanProcessingMethod is **final**, so the policy is inlined and calls made through
+ * policyLocalBank / policyCentralBank pointers are not virtual.
+ */
+
+#ifndef LIB_POLICYBANK_POLICYBANK_H_
+#define LIB_POLICYBANK_POLICYBANK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "localBank.h"
+#include "centralBank.h"
+#include "loanPolicy.h"
+
+template<class Policy>
+class policyLocalBank : public localBank {
+
+public:
+	policyLocalBank(const std::string& nameArg, centralBank* centralBankPtr) :
+		localBank(nameArg, centralBankPtr)
+	{};
+
+	/*!
+	 * @brief Same as localBank::loanProcessingMethod() but validation is done by **Policy**
+	 */
+	void loanProcessingMethod(loan *loanPtr) final {
+		traceSpan span("localBank::loanProcessingMethod");
+		profiledLock lock_guard2(this->bankMTX);
+		if (Policy::approve(this->policyContext(loanPtr))) {
+			this->commitApprovedLoan(loanPtr);
+		} else {
+			this->commitRejectedLoan();
+		}
+	};
+
+	bool loanValidationMethod(loan *loanPtr) final {
+		return Policy::approve(this->policyContext(loanPtr));
+	};
+
+	/*!
+	 * @brief Same as localBank::loanProcessingBatch() but every loan is validated by **Policy**
+	 *
+	 * All loans see the treasury from before the batch, treasury feasibility is then checked by localBank::commitBatch().
+	 */
+	void loanProcessingBatch(const std::vector<loan*>& loanPtrs) final {
+		traceSpan span("localBank::loanProcessingBatch");
+		if (loanPtrs.empty()) {
+			return;
+		}
+		std::vector<std::uint8_t> valid(loanPtrs.size());
+		profiledLock lock_guard2(this->bankMTX);
+		for (std::size_t i = 0; i < loanPtrs.size(); i++) {
+			valid[i] = Policy::approve(this->policyContext(loanPtrs[i]));
+		}
+		this->commitBatch(loanPtrs, valid.data());
+	};
+};
+
+/*!
+ * @attention **Policy** should contain treasuryFeasibilityPolicy, otherwise Central Bank may lend
+ * more than it has in treasury
+ */
+template<class Policy>
+class policyCentralBank : public centralBank {
+
+public:
+	/*!
+	 * @brief Same as centralBank::loanProcessingMethod() but approval is done by **Policy**
+	 */
+	void loanProcessingMethod(loan *loanPtr) final {
+		traceSpan span("centralBank::loanProcessingMethod");
+		profiledLock lock_guard2(this->bankMTX);
+		if (Policy::approve(this->policyContext(loanPtr))) {
+			this->commitApprovedLoan(loanPtr);
+		} else {
+			this->commitRejectedLoan();
+		}
+	};
+};
+
+#endif /* LIB_POLICYBANK_POLICYBANK_H_ */
@@ -0,0 +1,151 @@
+/*
+ * @brief Mutex with contention profiling
+ * 
+ * Drop-in replacement for std::mutex which, when profiling is enabled, records number of acquisitions,
+ * wait time and hold time histograms and the call sites waiting the longest.
+ * Statistics are updated only while the mutex is held, so profiling adds no extra synchronization.
+ * Use profiledLock instead of std::lock_guard to get call sites recorded.
+ */
+
+#ifndef LIB_PROFILEDMUTEX_PROFILEDMUTEX_H_
+#define LIB_PROFILEDMUTEX_PROFILEDMUTEX_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../../constants.h"
+
+/*!
+ * @brief Statistics gathered by a single profiledMutex
+ */
+struct lockStats {
+	/*!
+	 * @brief Wait time statistics of one call site
+	 */
+	struct callSite {
+		const char* site {nullptr}; ///< Name of the function which locked the mutex
+		std::uint64_t acquisitions {0}; ///< Number of acquisitions from this site
+		std::uint64_t totalWaitNs {0}; ///< Total time waited on this site
+	};
+
+	std::uint64_t acquisitions {0}; ///< Number of acquisitions
+	std::uint64_t contendedAcquisitions {0}; ///< Number of acquisitions which had to wait
+	std::uint64_t totalWaitNs {0}; ///< Total time spent waiting for the mutex
+	std::uint64_t totalHoldNs {0}; ///< Total time the mutex was held
+	std::array<std::uint64_t, PROFILING::HISTOGRAM_BUCKETS> waitHistogram {}; ///< Bucket i counts waits in [2^i, 2^(i+1)) ns
+	std::array<std::uint64_t, PROFILING::HISTOGRAM_BUCKETS> holdHistogram {}; ///< Bucket i counts holds in [2^i, 2^(i+1)) ns
+	std::array<callSite, PROFILING::MAX_CALL_SITES> callSites {}; ///< Call sites, the last one collects all sites which did not fit
+
+	void recordAcquisition(const char* site, std::uint64_t waitNs, bool contended);
+	void recordHold(std::uint64_t holdNs);
+	void merge(const lockStats& other);
+};
+
+class profiledMutex {
+
+private:
+	std::mutex mtx; ///< Underlying mutex
+	std::string name; ///< Name used in the report, mutexes with the same name are reported together
+	lockStats stats; ///< Statistics, modified only by the thread holding **mtx**
+	std::chrono::steady_clock::time_point lockedAt; ///< Time of the last acquisition
+	bool profiledAcquisition {false}; ///< True if the current acquisition is being profiled
+	std::atomic<bool> registered {false}; ///< True once the mutex is in the registry used by logReport()
+
+	static std::atomic<bool> enabled; ///< Global profiling switch
+
+	/*!
+	 * @brief Adding the mutex to the registry used by logReport()
+	 *
+	 * Done on the first profiled acquisition (before **mtx** is taken), so mutexes which are never
+	 * profiled do not touch the shared registry at all.
+	 */
+	void registerMutex();
+
+public:
+	profiledMutex(const std::string& nameArg = "unnamed mutex");
+
+	/*!
+	 * Statistics of destroyed mutex are kept and reported under its name
+	 */
+	~profiledMutex();
+
+	profiledMutex(const profiledMutex&) = delete;
+	profiledMutex& operator=(const profiledMutex&) = delete;
+
+	void lock() {
+		this->lock("unknown");
+	};
+
+	/*!
+	 * @brief Locking the mutex and recording **site** as the call site
+	 */
+	void lock(const char* site);
+
+	void unlock();
+
+	bool try_lock();
+
+	const std::string& getName() {
+		return this->name;
+	};
+
+	/*!
+	 * @brief Returns copy of the statistics (takes the mutex)
+	 */
+	lockStats getStats();
+
+	static void setEnabled(bool enabledArg) {
+		enabled.store(enabledArg, std::memory_order_relaxed);
+	};
+
+	static bool isEnabled() {
+		return enabled.load(std::memory_order_relaxed);
+	};
+
+	/*!
+	 * @brief Returns report lines with statistics of all mutexes (alive and destroyed), grouped by name
+	 * 
+	 * @attention meant to be called at the end of the run, when no other thread creates or destroys mutexes
+	 */
+	static std::vector<std::string> getReport();
+
+	/*!
+	 * @brief Logging profiledMutex::getReport(), nothing is logged in headless mode (see loggerClass::setHeadless())
+	 * 
+	 * @attention meant to be called at the end of the run, when no other thread creates or destroys mutexes
+	 */
+	static void logReport();
+};
+
+/*!
+ * @brief Lock guard recording the calling function as call site
+ */
+class profiledLock {
+
+private:
+	profiledMutex& mutexRef; ///< Locked mutex
+
+public:
+#if defined(__GNUC__) || defined(__clang__)
+	explicit profiledLock(profiledMutex& mutexArg, const char* site = __builtin_FUNCTION()) :
+#else
+	explicit profiledLock(profiledMutex& mutexArg, const char* site = "unknown") :
+#endif
+		mutexRef(mutexArg)
+	{
+		this->mutexRef.lock(site);
+	};
+
+	~profiledLock() {
+		this->mutexRef.unlock();
+	};
+
+	profiledLock(const profiledLock&) = delete;
+	profiledLock& operator=(const profiledLock&) = delete;
+};
+
+#endif /* LIB_PROFILEDMUTEX_PROFILEDMUTEX_H_ */
@@ -0,0 +1,75 @@
+/*
+ * @brief Versioned interest rate published with a seqlock
+ *
+ * Central Bank publishes its rate every time centralBank::adjustInterestRate() changes it, loan pricing
+ * reads it without any lock or virtual call (see localBank::getRateSnapshot()). Writer is a single thread
+ * at a time (Central Bank publishes under its bank::bankMTX), readers retry only if they overlap with a write.
+ * Every publication gets the next version number, loans keep the version they were priced at.
+ */
+
+#ifndef LIB_RATESNAPSHOT_RATESNAPSHOT_H_
+#define LIB_RATESNAPSHOT_RATESNAPSHOT_H_
+
+#include <atomic>
+#include <cstdint>
+
+/*!
+ * @brief Rate used to price a single loan
+ */
+struct rateSnapshot {
+	double centralRate {0}; ///< Central Bank interest rate
+	double spread {0}; ///< Interest rate of the Local Bank added to Central Bank rate
+	std::uint64_t version {0}; ///< Number of Central Bank rate publications up to this one, 0 if never published
+
+	double getRate() const {
+		return this->centralRate + this->spread;
+	};
+};
+
+class rateSeqlock {
+
+private:
+	std::atomic<std::uint64_t> sequence {0}; ///< Odd while a write is in progress, twice the version otherwise
+	std::atomic<double> rate {0}; ///< Published rate, atomic only so that racing reads are not undefined
+
+public:
+	/*!
+	 * @brief Publishing **rateArg** as the next version
+	 *
+	 * @attention only one thread may publish at a time
+	 */
+	void publish(double rateArg) {
+		std::uint64_t current = this->sequence.load(std::memory_order_relaxed);
+		this->sequence.store(current + 1, std::memory_order_relaxed);
+		// release publishes the odd sequence together with the rate, reader which sees the new rate sees the write in progress
+		this->rate.store(rateArg, std::memory_order_release);
+		this->sequence.store(current + 2, std::memory_order_release);
+	};
+
+	/*!
+	 * @brief Reading consistent rate and its version
+	 *
+	 * @return version of **rateOut**
+	 */
+	std::uint64_t read(double& rateOut) const {
+		std::uint64_t before;
+		std::uint64_t after;
+		do {
+			before = this->sequence.load(std::memory_order_acquire);
+			// acquire pairs with the release rate store of rateSeqlock::publish() and keeps the check below after it,
+			// readers only load, so they never write the shared cache line
+			rateOut = this->rate.load(std::memory_order_acquire);
+			after = this->sequence.load(std::memory_order_relaxed);
+		} while (before != after || (before & 1) != 0);
+		return before / 2;
+	};
+
+	/*!
+	 * @brief Returns version of the last completed publication
+	 */
+	std::uint64_t getVersion() const {
+		return this->sequence.load(std::memory_order_acquire) / 2;
+	};
+};
+
+#endif /* LIB_RATESNAPSHOT_RATESNAPSHOT_H_ */
@@ -0,0 +1,134 @@
+/*
+ * @brief Streaming statistics of a metric which do not keep individual samples
+ *
+ * runningStatistics keeps count, mean and sum of squared deviations updated with Welford's algorithm,
+ * quantileSketch keeps a bounded number of samples in levels of doubling weight. Both can be merged,
+ * so every worker thread can collect its own statistics and merge them once at the end.
+ */
+
+#ifndef LIB_RUNNINGSTATISTICS_RUNNINGSTATISTICS_H_
+#define LIB_RUNNINGSTATISTICS_RUNNINGSTATISTICS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../../constants.h"
+
+class runningStatistics {
+
+private:
+	std::uint64_t count {0}; ///< Number of added samples
+	double mean {0}; ///< Mean of added samples
+	double squaredDeviations {0}; ///< Sum of squared differences from the mean
+	double min {0}; ///< Smallest sample
+	double max {0}; ///< Largest sample
+
+public:
+	void add(double value);
+
+	/*!
+	 * @brief Adding all samples of **other** (Chan's parallel update)
+	 */
+	void merge(const runningStatistics& other);
+
+	std::uint64_t getCount() const {
+		return this->count;
+	};
+
+	double getMean() const {
+		return this->mean;
+	};
+
+	/*!
+	 * @brief Returns sample variance, 0 for less than 2 samples
+	 */
+	double getVariance() const {
+		return this->count > 1 ? this->squaredDeviations / (this->count - 1) : 0;
+	};
+
+	double getStandardDeviation() const;
+
+	/*!
+	 * @brief Returns half width of the confidence interval of the mean (ENSEMBLE::CONFIDENCE_Z standard errors)
+	 */
+	double getConfidenceHalfWidth() const;
+
+	double getMin() const {
+		return this->min;
+	};
+
+	double getMax() const {
+		return this->max;
+	};
+};
+
+/*!
+ * @brief Mergeable approximate quantiles in bounded memory
+ *
+ * Level **i** holds samples of weight 2^i. When a level reaches **capacity** samples, it is sorted and
+ * every other sample (alternating between odd and even positions) moves one level up, so memory grows
+ * with logarithm of the number of samples and rank error stays within a few percent for the default
+ * ENSEMBLE::SKETCH_CAPACITY. Up to **capacity** samples quantiles are exact.
+ */
+class quantileSketch {
+
+private:
+	std::size_t capacity; ///< Maximal number of samples on a single level
+	std::vector<std::vector<double>> levels; ///< Samples by level
+	std::uint64_t count {0}; ///< Number of added samples
+	bool oddCompaction {false}; ///< Positions kept by the next compaction
+
+	/*!
+	 * @brief Compacting every full level
+	 */
+	void compress();
+
+public:
+	explicit quantileSketch(std::size_t capacityArg = ENSEMBLE::SKETCH_CAPACITY);
+
+	void add(double value);
+
+	/*!
+	 * @brief Adding all samples of **other**
+	 */
+	void merge(const quantileSketch& other);
+
+	/*!
+	 * @brief Returns approximate **fraction** quantile (0 - 1), 0 if no sample was added
+	 */
+	double getQuantile(double fraction) const;
+
+	std::uint64_t getCount() const {
+		return this->count;
+	};
+
+	/*!
+	 * @brief Returns number of stored samples
+	 */
+	std::size_t getRetained() const;
+};
+
+/*!
+ * @brief Both statistics of a single metric
+ */
+struct metricStatistics {
+	runningStatistics moments;
+	quantileSketch quantiles;
+
+	void add(double value) {
+		this->moments.add(value);
+		this->quantiles.add(value);
+	};
+
+	void merge(const metricStatistics& other) {
+		this->moments.merge(other.moments);
+		this->quantiles.merge(other.quantiles);
+	};
+
+	/*!
+	 * @brief Returns mean with confidence interval, standard deviation, min, median, p5 / p95 and max in one line
+	 */
+	std::string toString() const;
+};
+
+#endif /* LIB_RUNNINGSTATISTICS_RUNNINGSTATISTICS_H_ */
@@ -0,0 +1,51 @@
+/*
+ * @brief Sharded accumulator used by epoch-based settlement
+ *
+ * Installments are deposited into one of several cache line aligned shards (picked once per thread)
+ * so concurrent payers do not contend on bank::bankMTX. bank::settleEpoch() drains all shards at once.
+ */
+
+#ifndef LIB_SETTLEMENTBUFFER_SETTLEMENTBUFFER_H_
+#define LIB_SETTLEMENTBUFFER_SETTLEMENTBUFFER_H_
+
+#include <array>
+#include <mutex>
+#include "../../constants.h"
+
+class settlementBuffer {
+
+private:
+	/*!
+	 * @brief Single shard of the buffer
+	 *
+	 * Aligned to cache line so two threads depositing into neighbouring shards do not share a line.
+	 */
+	struct alignas(64) shard {
+		std::mutex shardMTX; ///< Mutex protecting this shard only
+		double pendingAmount {0}; ///< Sum of installments deposited since last drain
+		int pendingInstallments {0}; ///< Number of installments deposited since last drain
+	};
+
+	std::array<shard, BANK::SETTLEMENT_SHARDS> shards; ///< All shards of the buffer
+
+	/*!
+	 * @brief Returns shard assigned to the calling thread
+	 */
+	shard& localShard();
+
+public:
+	/*!
+	 * @brief Adds single installment to the shard of the calling thread
+	 */
+	void deposit(double amount);
+
+	/*!
+	 * @brief Empties all shards
+	 *
+	 * @param installmentsArg is set to the number of drained installments
+	 * @return sum of all drained installments
+	 */
+	double drain(int& installmentsArg);
+};
+
+#endif /* LIB_SETTLEMENTBUFFER_SETTLEMENTBUFFER_H_ */
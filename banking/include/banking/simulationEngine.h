@@ -0,0 +1,223 @@
+/*
+ * @brief Single threaded, deterministic simulation engine
+ *
+ * Runs the same money flow as economy2 (Local Banks creating Local Clients, clients paying installments,
+ * Local Banks paying Central Bank loans) in discrete ticks on the calling thread, without pauses.
+ * All dice are rolled from a generator seeded with simulationConfig::seed (see dice::threadSeed),
+ * so the same configuration always gives the same result. Used by the perf harness and tests.
+ * Engine can also replay applicationTrace captured by economy2 (see simulationConfig::replayFileName).
+ */
+
+#ifndef LIB_SIMULATIONENGINE_SIMULATIONENGINE_H_
+#define LIB_SIMULATIONENGINE_SIMULATIONENGINE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "applicationTrace.h"
+#include "centralBank.h"
+#include "clientRouter.h"
+#include "economicScenario.h"
+#include "localBank.h"
+#include "localClient.h"
+#include "timingWheel.h"
+#include "../../constants.h"
+
+/*!
+ * @brief Parameters of a single simulation run
+ */
+struct simulationConfig {
+	unsigned seed {1}; ///< Seed of all dice rolls
+	int localBanksAmount {3}; ///< Number of Local Banks
+	std::uint32_t clientsAmount {ECONOMY2::MAX_NUMBER_OF_GENERATED_CLIENTS}; ///< Total number of generated Local Clients
+	std::string localBankPolicy {ECONOMY2::LOCAL_BANK_POLICY}; ///< Local Bank policy name, see loanPolicyRegistry
+	std::string centralBankPolicy {ECONOMY2::CENTRAL_BANK_POLICY}; ///< Central Bank policy name, see loanPolicyRegistry
+	bool epochSettlement {ECONOMY2::EPOCH_SETTLEMENT}; ///< See bank::setEpochSettlement()
+	std::string scenarioFileName {}; ///< economicScenario file with shocks, empty means no shocks
+	/*!
+	 * @brief applicationTrace file to replay, empty means clients are generated from **seed**
+	 *
+	 * Replayed trace overrides **clientsAmount** and adds Local Banks if trace needs more of them.
+	 */
+	std::string replayFileName {};
+	/*!
+	 * @brief clientRouter policy of new clients, empty means every Local Bank creates its own clients
+	 *
+	 * Ignored when a trace is replayed (records keep their Local Banks).
+	 */
+	std::string routingPolicy {};
+	std::string loanSchedule {LOCAL_CLIENT::LOAN_SCHEDULE}; ///< Amortization of Local Client loans, see loan::parseSchedule()
+	bool variableRate {LOCAL_CLIENT::VARIABLE_RATE}; ///< See localBank::setLoanTerms()
+	std::uint64_t installmentPeriod {1}; ///< Ticks between two installments of a Local Client
+};
+
+/*!
+ * @brief Counters and final state of a simulation run
+ */
+struct simulationResult {
+	std::uint64_t ticks {0}; ///< Number of simulated ticks
+	std::uint64_t clients {0}; ///< Number of created Local Clients
+	std::uint64_t loanApplications {0}; ///< Number of Local Client loan applications
+	std::uint64_t clientInstallments {0}; ///< Number of installments paid by Local Clients
+	std::uint64_t bankInstallments {0}; ///< Number of installments paid by Local Banks to Central Bank
+	std::uint64_t waitingClients {0}; ///< Clients whose loans were still waiting for Central Bank money at the end
+	std::uint64_t shocks {0}; ///< Number of applied economicScenario shocks
+	std::uint64_t replayMisses {0}; ///< Dice rolls replayed code asked for and the trace did not have, non-zero means replay diverged
+	double centralBankTreasury {0}; ///< Final current treasury of Central Bank
+	double localBanksTreasury {0}; ///< Final current treasury of all Local Banks
+	double centralBankTreasuryRate {0}; ///< Final current treasury of Central Bank divided by its total treasury
+	double localBanksTreasuryRate {0}; ///< Final current treasury of all Local Banks divided by their total treasury
+	double loanValidationRate {0}; ///< Validated Local Client loans divided by all applications (see bank::logLoansValidationRate())
+	std::uint64_t centralBankLoans {0}; ///< Number of loans granted by Central Bank to Local Banks
+	std::uint64_t loanRepricings {0}; ///< Number of times fully paid variable-rate Local Client loans were repriced
+	std::uint64_t missedInstallments {0}; ///< Installments missed by Local Clients, see delinquencyBook
+	std::uint64_t writtenOffLoans {0}; ///< Local Client loans written off after too many missed installments
+
+	/*!
+	 * @brief Number of simulated events (loan applications and installments)
+	 */
+	std::uint64_t events() const {
+		return this->loanApplications + this->clientInstallments + this->bankInstallments;
+	};
+};
+
+class simulationEngine {
+
+private:
+	simulationConfig config; ///< Configuration of the run
+	/*!
+	 * @brief Shocks of the run, nullptr if there are none
+	 *
+	 * Declared before the banks, so its parameter snapshots (see bank::publishParameters()) outlive them.
+	 */
+	std::unique_ptr<economicScenario> scenario;
+	std::unique_ptr<centralBank> centralBankInstance; ///< The only Central Bank
+	std::vector<std::unique_ptr<localBank>> localBanks; ///< All Local Banks
+	std::unique_ptr<applicationTrace> replayedTrace; ///< Trace being replayed, nullptr if clients are generated
+	std::size_t nextRecord {0}; ///< Index of the first not replayed record of **replayedTrace**
+	applicationTrace* recordingTrace {nullptr}; ///< Trace receiving applications of the run, not owned
+	std::unique_ptr<clientRouter> router; ///< Router of new clients, nullptr if Local Banks create their own clients
+	/*!
+	 * @brief Clients paying their loans, keyed by the tick of their next installment
+	 *
+	 * Every tick touches only clients due in it, so installment processing scales with installments due
+	 * rather than with all active clients.
+	 */
+	timingWheel<std::unique_ptr<localClient>> dueClients;
+	std::vector<std::unique_ptr<localClient>> payingClients; ///< Clients due in the current tick, reused between ticks
+	/*!
+	 * @brief Clients with validated loans waiting in localBank.waitingLoans
+	 *
+	 * Kept alive until their loans are granted, Local Bank keeps pointers to their loans.
+	 */
+	std::vector<std::unique_ptr<localClient>> waitingClients;
+	simulationResult result; ///< Result of the run
+
+	/*!
+	 * @brief Creating client **clientNumber** of **localBankPtr** and processing its loan application
+	 *
+	 * **Bank** is the concrete class of all Local Banks (see loanPolicyRegistry::visitLocalBankType()).
+	 */
+	template<class Bank>
+	void createClient(Bank* localBankPtr, std::uint32_t clientNumber);
+
+	/*!
+	 * @brief Creating client of Local Bank with index **localBankIndex**, recording or replaying its dice rolls
+	 *
+	 * Replays the next record of **replayedTrace** if it belongs to that bank (nothing is done otherwise),
+	 * appends the application to **recordingTrace** if it is set.
+	 */
+	template<class Bank>
+	void createClient(std::size_t localBankIndex);
+
+	/*!
+	 * @brief Simulating ticks until the end of the run, see run()
+	 */
+	template<class Bank>
+	void runTicks();
+
+	/*!
+	 * @brief Returns true while there are clients to create
+	 */
+	bool moreClientsExpected() const;
+
+	/*!
+	 * @brief Every client due in the current tick pays one installment
+	 *
+	 * Clients with loans left are due again after simulationConfig::installmentPeriod ticks, fully paid clients are removed.
+	 */
+	void payClientInstallments();
+
+	/*!
+	 * @brief Waiting clients whose loans were granted become due in the next tick
+	 */
+	void activateWaitingClients();
+
+	/*!
+	 * @brief Returns true if any Local Bank is still paying Central Bank loan
+	 */
+	bool isAnyBankPaying();
+
+	/*!
+	 * @brief Returns true if any Local Bank still accepts new clients (see economicParameters::isLocalBankFailed())
+	 */
+	bool isAnyBankOpen();
+
+	/*!
+	 * @brief Applying scenario shocks scheduled up to the current tick
+	 *
+	 * Treasury injections are applied directly, changed parameters are published to all banks as one snapshot.
+	 */
+	void applyShocks();
+
+	/*!
+	 * @brief Depositing (or withdrawing negative) **shock** value to its target treasury
+	 */
+	void injectTreasury(const scenarioShock& shock);
+
+	simulationEngine(const simulationConfig& configArg, std::unique_ptr<centralBank> centralBankArg);
+
+public:
+	/*!
+	 * @brief Creating engine with Central Bank and Local Banks, nothing is simulated yet
+	 *
+	 * @return nullptr if policy from **configArg** is not registered in loanPolicyRegistry, scenario file
+	 * cannot be loaded or one of its shocks targets a Local Bank which does not exist, replayed trace
+	 * cannot be read or routing policy is unknown
+	 */
+	static std::unique_ptr<simulationEngine> create(const simulationConfig& configArg);
+
+	~simulationEngine();
+
+	/*!
+	 * @brief Appending every loan application of the following run to **traceArg** (nullptr stops recording)
+	 */
+	void setRecordingTrace(applicationTrace* traceArg) {
+		this->recordingTrace = traceArg;
+	};
+
+	/*!
+	 * @brief Running the whole simulation
+	 *
+	 * Every tick starts with scenario shocks due in that tick, then each open Local Bank which is not paying
+	 * its own loan creates one client (until simulationConfig::clientsAmount is reached; when replaying, only
+	 * if the next record belongs to that bank, records are replayed in capture order; with a router the client
+	 * is routed to any open Local Bank, router is refreshed at the beginning of every tick), pays Central Bank
+	 * installment and settles epoch, then all clients due in the tick pay one installment (every
+	 * simulationConfig::installmentPeriod ticks, starting in the tick their loan was granted). Simulation ends when all
+	 * clients were created (or all Local Banks failed), all granted loans are paid and no Local Bank is paying
+	 * Central Bank loan.
+	 */
+	simulationResult run();
+
+	centralBank* getCentralBank() {
+		return this->centralBankInstance.get();
+	};
+
+	const std::vector<std::unique_ptr<localBank>>& getLocalBanks() {
+		return this->localBanks;
+	};
+};
+
+#endif /* LIB_SIMULATIONENGINE_SIMULATIONENGINE_H_ */
@@ -0,0 +1,72 @@
+/*
+ * @brief Monte-Carlo ensemble of simulationEngine runs
+ *
+ * Runs the same simulationConfig with many consecutive seeds on all cores and merges the outcomes into
+ * streaming statistics (see runningStatistics.h), no result of a single run is stored. Every worker thread
+ * takes the next seed from a shared counter, runs its own simulationEngine (engines share nothing, dice are
+ * seeded per thread with dice::threadSeed) and collects its own statistics; statistics of all workers are
+ * merged once at the end. Moments do not depend on the number of threads up to rounding, quantiles are
+ * approximate.
+ */
+
+#ifndef LIB_SIMULATIONENSEMBLE_SIMULATIONENSEMBLE_H_
+#define LIB_SIMULATIONENSEMBLE_SIMULATIONENSEMBLE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "runningStatistics.h"
+#include "simulationEngine.h"
+#include "../../constants.h"
+
+/*!
+ * @brief Parameters of an ensemble
+ */
+struct ensembleConfig {
+	simulationConfig simulation {}; ///< Configuration of every run, its seed is replaced by the run seed
+	unsigned firstSeed {1}; ///< Seed of the first run, run **i** uses **firstSeed + i**
+	int runs {ENSEMBLE::RUNS}; ///< Number of runs
+	int threads {0}; ///< Number of worker threads, 0 means one per hardware thread
+};
+
+/*!
+ * @brief Merged outcomes of all runs
+ */
+struct ensembleResult {
+	std::uint64_t runs {0}; ///< Number of finished runs
+	metricStatistics centralBankTreasuryRate; ///< See simulationResult::centralBankTreasuryRate
+	metricStatistics localBanksTreasuryRate; ///< See simulationResult::localBanksTreasuryRate
+	metricStatistics loanValidationRate; ///< See simulationResult::loanValidationRate
+	metricStatistics centralBankLoans; ///< See simulationResult::centralBankLoans
+	metricStatistics ticks; ///< See simulationResult::ticks
+	std::uint64_t events {0}; ///< Events simulated by all runs
+	double seconds {0}; ///< Wall time of the whole ensemble
+
+	/*!
+	 * @brief Adding outcome of a single run
+	 */
+	void add(const simulationResult& result);
+
+	/*!
+	 * @brief Adding all runs of **other**
+	 */
+	void merge(const ensembleResult& other);
+
+	/*!
+	 * @brief Returns human readable report, one metric per line
+	 */
+	std::string toString() const;
+};
+
+class simulationEnsemble {
+
+public:
+	/*!
+	 * @brief Running the whole ensemble on ensembleConfig::threads threads, the calling thread is one of them
+	 *
+	 * @return nullptr if simulationEngine cannot be created from ensembleConfig::simulation
+	 */
+	static std::unique_ptr<ensembleResult> run(const ensembleConfig& config);
+};
+
+#endif /* LIB_SIMULATIONENSEMBLE_SIMULATIONENSEMBLE_H_ */
@@ -0,0 +1,218 @@
+/*
+ * @brief Hierarchical timing wheel of entries due at virtual-time ticks
+ *
+ * TIMING_WHEEL::LEVELS wheels of 2^TIMING_WHEEL::SLOT_BITS slots, level **l** slot holds entries due
+ * within 2^(SLOT_BITS * (l + 1)) ticks. Every tick timingWheel::advance() returns the whole current
+ * slot of the lowest wheel, when it wraps the next slot of the higher wheel is cascaded down, so every
+ * entry is moved at most LEVELS times and a tick costs only the entries due in it. Entries live in
+ * one contiguous node vector linked by 32 bit indices (free nodes are reused), slots keep head and tail
+ * of a doubly linked list: schedule and cancel are O(1) and entries due in the same tick are returned
+ * in scheduling order. Not thread safe.
+ */
+
+#ifndef LIB_TIMINGWHEEL_TIMINGWHEEL_H_
+#define LIB_TIMINGWHEEL_TIMINGWHEEL_H_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "../../constants.h"
+
+template<class T>
+class timingWheel {
+
+public:
+	using handle = std::uint32_t; ///< Scheduled entry, valid until it is returned by timingWheel::advance() or cancelled
+
+	static constexpr handle NO_HANDLE {std::numeric_limits<handle>::max()};
+
+private:
+	static constexpr std::uint32_t SLOTS {1u << TIMING_WHEEL::SLOT_BITS}; ///< Slots of a single wheel
+	static constexpr std::uint32_t SLOT_MASK {SLOTS - 1};
+	static constexpr std::uint32_t NOT_SCHEDULED {std::numeric_limits<std::uint32_t>::max()}; ///< Slot of a free node
+
+	/*!
+	 * @brief Single entry, linked into list of its slot or into free list
+	 */
+	struct node {
+		T value;
+		std::uint64_t due; ///< Tick in which the entry is returned
+		handle previous; ///< Previous node in the slot, NO_HANDLE for the head
+		handle next; ///< Next node in the slot or in the free list, NO_HANDLE for the tail
+		std::uint32_t slot; ///< Index in **heads**, NOT_SCHEDULED if the node is free
+	};
+
+	std::vector<node> nodes; ///< Storage of all entries
+	handle freeNodes {NO_HANDLE}; ///< Head of the list of nodes ready for reuse
+	std::array<handle, TIMING_WHEEL::LEVELS * SLOTS> heads; ///< First node of every slot
+	std::array<handle, TIMING_WHEEL::LEVELS * SLOTS> tails; ///< Last node of every slot
+	std::uint64_t currentTick {0}; ///< Tick returned by the next timingWheel::advance()
+	std::size_t entriesAmount {0}; ///< Number of scheduled entries
+
+	/*!
+	 * @brief Returns slot for **due** relative to **currentTick**
+	 */
+	std::uint32_t slotFor(std::uint64_t due) const {
+		std::uint64_t delta = due - this->currentTick;
+		for (int level = 0; level < TIMING_WHEEL::LEVELS - 1; level++) {
+			if (delta < (std::uint64_t {1} << (TIMING_WHEEL::SLOT_BITS * (level + 1)))) {
+				return level * SLOTS + static_cast<std::uint32_t>((due >> (TIMING_WHEEL::SLOT_BITS * level)) & SLOT_MASK);
+			}
+		}
+		// entries beyond the range of the highest wheel wait in it and are placed again on every cascade
+		const int topShift = TIMING_WHEEL::SLOT_BITS * (TIMING_WHEEL::LEVELS - 1);
+		std::uint64_t limit = this->currentTick + ((std::uint64_t {1} << (TIMING_WHEEL::SLOT_BITS * TIMING_WHEEL::LEVELS)) - 1);
+		std::uint64_t placed = delta >> (TIMING_WHEEL::SLOT_BITS * TIMING_WHEEL::LEVELS) == 0 ? due : limit;
+		return (TIMING_WHEEL::LEVELS - 1) * SLOTS + static_cast<std::uint32_t>((placed >> topShift) & SLOT_MASK);
+	};
+
+	void link(handle entry) {
+		node& linked = this->nodes[entry];
+		linked.slot = this->slotFor(linked.due);
+		linked.previous = this->tails[linked.slot];
+		linked.next = NO_HANDLE;
+		if (linked.previous == NO_HANDLE) {
+			this->heads[linked.slot] = entry;
+		} else {
+			this->nodes[linked.previous].next = entry;
+		}
+		this->tails[linked.slot] = entry;
+	};
+
+	void unlink(handle entry) {
+		node& unlinked = this->nodes[entry];
+		if (unlinked.previous == NO_HANDLE) {
+			this->heads[unlinked.slot] = unlinked.next;
+		} else {
+			this->nodes[unlinked.previous].next = unlinked.next;
+		}
+		if (unlinked.next == NO_HANDLE) {
+			this->tails[unlinked.slot] = unlinked.previous;
+		} else {
+			this->nodes[unlinked.next].previous = unlinked.previous;
+		}
+		unlinked.slot = NOT_SCHEDULED;
+	};
+
+	void release(handle entry) {
+		this->nodes[entry].slot = NOT_SCHEDULED;
+		this->nodes[entry].next = this->freeNodes;
+		this->freeNodes = entry;
+		this->entriesAmount--;
+	};
+
+	/*!
+	 * @brief Placing all entries of **slot** again, relative to **currentTick**
+	 */
+	void cascade(std::uint32_t slot) {
+		handle entry = this->heads[slot];
+		this->heads[slot] = NO_HANDLE;
+		this->tails[slot] = NO_HANDLE;
+		while (entry != NO_HANDLE) {
+			handle next = this->nodes[entry].next;
+			this->link(entry);
+			entry = next;
+		}
+	};
+
+public:
+	timingWheel() {
+		this->heads.fill(NO_HANDLE);
+		this->tails.fill(NO_HANDLE);
+	};
+
+	/*!
+	 * @brief Scheduling **value** to be returned in tick **due**, past ticks mean the current one
+	 */
+	handle schedule(T value, std::uint64_t due) {
+		handle entry = this->freeNodes;
+		if (entry == NO_HANDLE) {
+			entry = static_cast<handle>(this->nodes.size());
+			this->nodes.push_back(node {std::move(value), 0, NO_HANDLE, NO_HANDLE, NOT_SCHEDULED});
+		} else {
+			this->freeNodes = this->nodes[entry].next;
+			this->nodes[entry].value = std::move(value);
+		}
+		this->nodes[entry].due = due < this->currentTick ? this->currentTick : due;
+		this->link(entry);
+		this->entriesAmount++;
+		return entry;
+	};
+
+	/*!
+	 * @brief Removing scheduled **entry**, its value is moved to **valueOut**
+	 *
+	 * @return false if **entry** is not scheduled
+	 */
+	bool cancel(handle entry, T& valueOut) {
+		if (entry >= this->nodes.size() || this->nodes[entry].slot == NOT_SCHEDULED) {
+			return false;
+		}
+		this->unlink(entry);
+		valueOut = std::move(this->nodes[entry].value);
+		this->release(entry);
+		return true;
+	};
+
+	/*!
+	 * @brief Appending values of all entries due in the current tick to **dueOut** and moving to the next tick
+	 *
+	 * @return number of appended values
+	 */
+	std::size_t advance(std::vector<T>& dueOut) {
+		std::uint64_t tick = this->currentTick;
+		// higher wheels are cascaded first, so their entries due soon reach the lower slot before it is emptied
+		int highestLevel {0};
+		while (highestLevel < TIMING_WHEEL::LEVELS - 1
+				&& ((tick >> (TIMING_WHEEL::SLOT_BITS * highestLevel)) & SLOT_MASK) == 0) {
+			highestLevel++;
+		}
+		for (int level = highestLevel; level > 0; level--) {
+			this->cascade(level * SLOTS + static_cast<std::uint32_t>((tick >> (TIMING_WHEEL::SLOT_BITS * level)) & SLOT_MASK));
+		}
+		std::uint32_t slot = static_cast<std::uint32_t>(tick & SLOT_MASK);
+		std::size_t amount {0};
+		handle entry = this->heads[slot];
+		this->heads[slot] = NO_HANDLE;
+		this->tails[slot] = NO_HANDLE;
+		while (entry != NO_HANDLE) {
+			handle next = this->nodes[entry].next;
+			dueOut.push_back(std::move(this->nodes[entry].value));
+			this->release(entry);
+			amount++;
+			entry = next;
+		}
+		this->currentTick++;
+		return amount;
+	};
+
+	/*!
+	 * @brief Returns tick returned by the next timingWheel::advance()
+	 */
+	std::uint64_t getCurrentTick() const {
+		return this->currentTick;
+	};
+
+	std::size_t size() const {
+		return this->entriesAmount;
+	};
+
+	bool empty() const {
+		return this->entriesAmount == 0;
+	};
+
+	/*!
+	 * @brief Destroying all entries, current tick does not change
+	 */
+	void clear() {
+		this->nodes.clear();
+		this->freeNodes = NO_HANDLE;
+		this->heads.fill(NO_HANDLE);
+		this->tails.fill(NO_HANDLE);
+		this->entriesAmount = 0;
+	};
+};
+
+#endif /* LIB_TIMINGWHEEL_TIMINGWHEEL_H_ */
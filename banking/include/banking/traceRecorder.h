@@ -0,0 +1,99 @@
+/*
+ * @brief Timeline tracing of simulation activity
+ * 
+ * Opt-in recorder of scoped spans (see traceSpan) written to per-thread buffers and exported
+ * as Chrome trace JSON (viewable in chrome://tracing or Perfetto UI).
+ * When tracing is disabled traceSpan costs a single flag check.
+ */
+
+#ifndef LIB_TRACERECORDER_TRACERECORDER_H_
+#define LIB_TRACERECORDER_TRACERECORDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+class traceRecorder {
+
+private:
+	static std::atomic<bool> enabled; ///< Global tracing switch
+
+public:
+	static bool isEnabled() {
+		return enabled.load(std::memory_order_relaxed);
+	};
+
+	/*!
+	 * @brief Enabling or disabling recording of new spans
+	 */
+	static void setEnabled(bool enabledArg) {
+		enabled.store(enabledArg, std::memory_order_relaxed);
+	};
+
+	/*!
+	 * @brief Returns nanoseconds since the first call in this process
+	 */
+	static std::uint64_t now();
+
+	/*!
+	 * @brief Appending finished span to the buffer of the calling thread
+	 */
+	static void record(const char* name, std::uint64_t startNs, std::uint64_t durationNs);
+
+	/*!
+	 * @brief Returns number of spans recorded by all threads
+	 * 
+	 * @attention has to be called when no other thread records spans (for example after all threads are joined)
+	 */
+	static std::size_t size();
+
+	/*!
+	 * @brief Removing all recorded spans
+	 * 
+	 * @attention has to be called when no other thread records spans (for example after all threads are joined)
+	 */
+	static void clear();
+
+	/*!
+	 * @brief Writing all recorded spans to **fileName** as Chrome trace JSON
+	 * 
+	 * @attention has to be called when no other thread records spans (for example after all threads are joined)
+	 * @return false if the file could not be written
+	 */
+	static bool writeChromeTrace(const std::string& fileName);
+};
+
+/*!
+ * @brief Span covering the lifetime of the object
+ * 
+ * **nameArg** has to be a string literal (only the pointer is stored).
+ */
+class traceSpan {
+
+private:
+	const char* name; ///< Name of the span
+	std::uint64_t startNs; ///< Start of the span, see traceRecorder::now()
+	bool active; ///< True if tracing was enabled when the span started
+
+public:
+	explicit traceSpan(const char* nameArg) :
+		name(nameArg),
+		startNs(0),
+		active(traceRecorder::isEnabled())
+	{
+		if (this->active) {
+			this->startNs = traceRecorder::now();
+		}
+	};
+
+	~traceSpan() {
+		if (this->active) {
+			traceRecorder::record(this->name, this->startNs, traceRecorder::now() - this->startNs);
+		}
+	};
+
+	traceSpan(const traceSpan&) = delete;
+	traceSpan& operator=(const traceSpan&) = delete;
+};
+
+#endif /* LIB_TRACERECORDER_TRACERECORDER_H_ */
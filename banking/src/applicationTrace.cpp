@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include "banking/applicationTrace.h"
+
+namespace {
+template<class T>
+void writeValue(std::ofstream& output, T value) {
+	output.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<class T>
+bool readValue(std::ifstream& input, T& valueOut) {
+	return static_cast<bool>(input.read(reinterpret_cast<char*>(&valueOut), sizeof(valueOut)));
+}
+}
+
+void applicationTrace::append(applicationRecord record) {
+	if (record.rolls.size() > std::numeric_limits<std::uint8_t>::max()) {
+		record.rolls.resize(std::numeric_limits<std::uint8_t>::max());
+	}
+	std::lock_guard<std::mutex> lock_guard1(this->traceMTX);
+	this->records.push_back(std::move(record));
+}
+
+bool applicationTrace::write(const std::string& fileName) {
+	std::lock_guard<std::mutex> lock_guard1(this->traceMTX);
+	std::ofstream output(fileName, std::ios::binary | std::ios::trunc);
+	writeValue(output, TRACE::MAGIC);
+	writeValue(output, TRACE::VERSION);
+	writeValue(output, static_cast<std::uint64_t>(this->records.size()));
+	for (const applicationRecord& record: this->records) {
+		writeValue(output, record.localBankIndex);
+		writeValue(output, record.clientNumber);
+		writeValue(output, static_cast<std::uint8_t>(record.rolls.size()));
+		output.write(reinterpret_cast<const char*>(record.rolls.data()), record.rolls.size());
+	}
+	return static_cast<bool>(output);
+}
+
+bool applicationTrace::read(const std::string& fileName) {
+	std::ifstream input(fileName, std::ios::binary);
+	std::uint32_t magic {0};
+	std::uint32_t version {0};
+	std::uint64_t recordsAmount {0};
+	if (!readValue(input, magic) || magic != TRACE::MAGIC || !readValue(input, version) || version != TRACE::VERSION
+			|| !readValue(input, recordsAmount)) {
+		return false;
+	}
+	std::vector<applicationRecord> readRecords;
+	for (std::uint64_t i = 0; i < recordsAmount; i++) {
+		applicationRecord record {};
+		std::uint8_t rollsAmount {0};
+		if (!readValue(input, record.localBankIndex) || !readValue(input, record.clientNumber) || !readValue(input, rollsAmount)) {
+			return false;
+		}
+		record.rolls.resize(rollsAmount);
+		if (!input.read(reinterpret_cast<char*>(record.rolls.data()), rollsAmount)) {
+			return false;
+		}
+		readRecords.push_back(std::move(record));
+	}
+	std::lock_guard<std::mutex> lock_guard1(this->traceMTX);
+	this->records = std::move(readRecords);
+	return true;
+}
+
+int applicationTrace::getLocalBanksAmount() const {
+	int localBanksAmount {0};
+	for (const applicationRecord& record: this->records) {
+		localBanksAmount = std::max(localBanksAmount, record.localBankIndex + 1);
+	}
+	return localBanksAmount;
+}
@@ -0,0 +1,35 @@
+#include <chrono>
+#include "banking/arrivalGenerator.h"
+
+arrivalGenerator::arrivalGenerator(std::unique_ptr<arrivalProcess> processArg, arrivalQueue* queueArg, std::uint32_t clientsAmountArg) :
+	process(std::move(processArg)),
+	queuePtr(queueArg),
+	clientsAmount(clientsAmountArg),
+	generated(0),
+	stopRequested(false),
+	finished(false)
+{
+	this->generatorThread = std::thread(&arrivalGenerator::run, this);
+}
+
+arrivalGenerator::~arrivalGenerator() {
+	this->stop();
+	this->generatorThread.join();
+}
+
+void arrivalGenerator::run() {
+	auto nextArrival = std::chrono::steady_clock::now();
+	while (this->generated.load(std::memory_order_relaxed) < this->clientsAmount
+			&& !this->stopRequested.load(std::memory_order_relaxed)) {
+		double interarrival = this->process->nextInterarrival();
+		if (interarrival < 0) {
+			break;
+		}
+		nextArrival += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(interarrival));
+		std::this_thread::sleep_until(nextArrival);
+		this->queuePtr->tryPush({this->generated.load(std::memory_order_relaxed), nextArrival});
+		this->generated.fetch_add(1, std::memory_order_relaxed);
+	}
+	this->finished.store(true, std::memory_order_release);
+	this->queuePtr->close();
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "banking/arrivalProcess.h"
+
+namespace {
+/*!
+ * @brief Splitting **spec** on ':'
+ */
+std::vector<std::string> splitSpec(const std::string& spec) {
+	std::vector<std::string> parts;
+	std::stringstream specStream(spec);
+	std::string part;
+	while (std::getline(specStream, part, ':')) {
+		parts.push_back(part);
+	}
+	return parts;
+}
+
+/*!
+ * @brief Parsing positive number, returns false if **text** is not one
+ */
+bool parsePositive(const std::string& text, double& valueOut) {
+	std::istringstream textStream(text);
+	return (textStream >> valueOut) && textStream.eof() && valueOut > 0;
+}
+}
+
+std::unique_ptr<arrivalProcess> arrivalProcess::create(const std::string& spec, unsigned seed) {
+	std::vector<std::string> parts = splitSpec(spec);
+	if (parts.empty()) {
+		return nullptr;
+	}
+	double rate {0};
+	if (parts[0] == "poisson" && parts.size() == 2 && parsePositive(parts[1], rate)) {
+		return std::unique_ptr<arrivalProcess>(new poissonArrivalProcess(rate, seed));
+	}
+	double highRate {0};
+	double meanStateSeconds {0};
+	if (parts[0] == "mmpp" && parts.size() == 4 && parsePositive(parts[1], rate)
+			&& parsePositive(parts[2], highRate) && parsePositive(parts[3], meanStateSeconds)) {
+		return std::unique_ptr<arrivalProcess>(new mmppArrivalProcess(rate, highRate, meanStateSeconds, seed));
+	}
+	std::vector<double> arrivalTimes;
+	if (parts[0] == "trace" && spec.size() > 6 && traceArrivalProcess::readTrace(spec.substr(6), arrivalTimes)) {
+		return std::unique_ptr<arrivalProcess>(new traceArrivalProcess(std::move(arrivalTimes)));
+	}
+	return nullptr;
+}
+
+poissonArrivalProcess::poissonArrivalProcess(double rate, unsigned seed) :
+	engine(seed),
+	interarrival(rate)
+{}
+
+double poissonArrivalProcess::nextInterarrival() {
+	return this->interarrival(this->engine);
+}
+
+mmppArrivalProcess::mmppArrivalProcess(double lowRate, double highRate, double meanStateSeconds, unsigned seed) :
+	engine(seed),
+	lowInterarrival(lowRate),
+	highInterarrival(highRate),
+	stateDuration(1 / meanStateSeconds),
+	highState(false)
+{
+	this->stateLeft = this->stateDuration(this->engine);
+}
+
+double mmppArrivalProcess::nextInterarrival() {
+	double waited {0};
+	while (true) {
+		double candidate = this->highState ? this->highInterarrival(this->engine) : this->lowInterarrival(this->engine);
+		if (candidate <= this->stateLeft) {
+			this->stateLeft = this->stateLeft - candidate;
+			return waited + candidate;
+		}
+		waited = waited + this->stateLeft;
+		this->highState = !this->highState;
+		this->stateLeft = this->stateDuration(this->engine);
+	}
+}
+
+traceArrivalProcess::traceArrivalProcess(std::vector<double> arrivalTimesArg) :
+	arrivalTimes(std::move(arrivalTimesArg)),
+	nextArrival(0),
+	previousTime(0)
+{
+	std::sort(this->arrivalTimes.begin(), this->arrivalTimes.end());
+}
+
+bool traceArrivalProcess::readTrace(const std::string& fileName, std::vector<double>& arrivalTimesOut) {
+	std::ifstream input(fileName);
+	if (!input) {
+		return false;
+	}
+	std::string line;
+	while (std::getline(input, line)) {
+		std::istringstream lineStream(line);
+		std::string first;
+		if (!(lineStream >> first) || first[0] == '#') {
+			continue;
+		}
+		std::istringstream timeStream(first);
+		double arrivalTime {0};
+		if (!(timeStream >> arrivalTime) || !timeStream.eof() || arrivalTime < 0) {
+			return false;
+		}
+		arrivalTimesOut.push_back(arrivalTime);
+	}
+	return true;
+}
+
+double traceArrivalProcess::nextInterarrival() {
+	if (this->nextArrival == this->arrivalTimes.size()) {
+		return -1;
+	}
+	double arrivalTime = this->arrivalTimes[this->nextArrival++];
+	double interarrivalTime = arrivalTime - this->previousTime;
+	this->previousTime = arrivalTime;
+	return interarrivalTime;
+}
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <sstream>
+#include "banking/arrivalQueue.h"
+
+void latencyHistogram::record(std::chrono::steady_clock::duration latency) {
+	std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+	int index {0};
+	for (std::uint64_t rest = ns; rest > 1 && index < PROFILING::HISTOGRAM_BUCKETS - 1; rest = rest >> 1) {
+		index++;
+	}
+	this->buckets[index].fetch_add(1, std::memory_order_relaxed);
+	this->samples.fetch_add(1, std::memory_order_relaxed);
+	std::uint64_t currentMax = this->maxNs.load(std::memory_order_relaxed);
+	while (ns > currentMax && !this->maxNs.compare_exchange_weak(currentMax, ns, std::memory_order_relaxed)) {}
+}
+
+void latencyHistogram::merge(const latencyHistogram& other) {
+	for (int i = 0; i < PROFILING::HISTOGRAM_BUCKETS; i++) {
+		this->buckets[i].fetch_add(other.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+	this->samples.fetch_add(other.getSamples(), std::memory_order_relaxed);
+	std::uint64_t otherMax = other.getMaxNs();
+	std::uint64_t currentMax = this->maxNs.load(std::memory_order_relaxed);
+	while (otherMax > currentMax && !this->maxNs.compare_exchange_weak(currentMax, otherMax, std::memory_order_relaxed)) {}
+}
+
+std::uint64_t latencyHistogram::getQuantileNs(double quantile) const {
+	std::uint64_t samplesAmount = this->getSamples();
+	if (samplesAmount == 0) {
+		return 0;
+	}
+	std::uint64_t needed = static_cast<std::uint64_t>(quantile * samplesAmount);
+	std::uint64_t counted {0};
+	for (int i = 0; i < PROFILING::HISTOGRAM_BUCKETS; i++) {
+		counted = counted + this->buckets[i].load(std::memory_order_relaxed);
+		if (counted > needed || counted == samplesAmount) {
+			return std::min(std::uint64_t {2} << i, this->getMaxNs());
+		}
+	}
+	return this->getMaxNs();
+}
+
+std::string latencyHistogram::toString() const {
+	std::ostringstream result;
+	result << "p50 " << this->getQuantileNs(0.5) / 1000.0 << " us, p99 " << this->getQuantileNs(0.99) / 1000.0
+			<< " us, max " << this->getMaxNs() / 1000.0 << " us";
+	return result.str();
+}
+
+arrivalQueue::arrivalQueue(std::size_t capacityArg, admissionPolicy policyArg) :
+	capacity(std::max<std::size_t>(1, capacityArg)),
+	policy(policyArg),
+	closed(false),
+	pushed(0),
+	dropped(0),
+	shed(0),
+	waited(0),
+	maxDepth(0),
+	depthSum(0)
+{}
+
+bool arrivalQueue::parsePolicy(const std::string& policyName, admissionPolicy& policyOut) {
+	if (policyName == "reject") {
+		policyOut = admissionPolicy::REJECT;
+	} else if (policyName == "shed") {
+		policyOut = admissionPolicy::SHED;
+	} else if (policyName == "wait") {
+		policyOut = admissionPolicy::WAIT;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool arrivalQueue::tryPush(const clientArrival& arrival) {
+	{
+		std::lock_guard<std::mutex> lock_guard1(this->queueMTX);
+		if (this->closed) {
+			return false;
+		}
+		if (this->arrivals.size() >= this->capacity) {
+			this->dropped++;
+			return false;
+		}
+		this->arrivals.push_back(arrival);
+		this->pushed++;
+		this->maxDepth = std::max(this->maxDepth, this->arrivals.size());
+		this->depthSum = this->depthSum + this->arrivals.size();
+	}
+	this->notEmpty.notify_one();
+	return true;
+}
+
+admissionResult arrivalQueue::push(const clientArrival& arrival, std::chrono::milliseconds timeout) {
+	admissionResult result {admissionResult::ADMITTED};
+	{
+		std::unique_lock<std::mutex> lock1(this->queueMTX);
+		if (!this->closed && this->arrivals.size() >= this->capacity) {
+			switch (this->policy) {
+			case admissionPolicy::REJECT:
+				break;
+			case admissionPolicy::SHED:
+				this->arrivals.pop_front();
+				this->shed++;
+				result = admissionResult::ADMITTED_SHEDDING;
+				break;
+			case admissionPolicy::WAIT:
+				this->waited++;
+				this->notFull.wait_for(lock1, timeout, [this]() { return this->arrivals.size() < this->capacity || this->closed; });
+				break;
+			}
+		}
+		if (this->closed) {
+			return admissionResult::REJECTED;
+		}
+		if (this->arrivals.size() >= this->capacity) {
+			this->dropped++;
+			return admissionResult::REJECTED;
+		}
+		this->arrivals.push_back(arrival);
+		this->pushed++;
+		this->maxDepth = std::max(this->maxDepth, this->arrivals.size());
+		this->depthSum = this->depthSum + this->arrivals.size();
+	}
+	this->notEmpty.notify_one();
+	return result;
+}
+
+bool arrivalQueue::pop(clientArrival& arrivalOut, std::chrono::milliseconds timeout) {
+	std::unique_lock<std::mutex> lock1(this->queueMTX);
+	if (!this->notEmpty.wait_for(lock1, timeout, [this]() { return !this->arrivals.empty() || this->closed; })
+			|| this->arrivals.empty()) {
+		return false;
+	}
+	arrivalOut = this->arrivals.front();
+	this->arrivals.pop_front();
+	lock1.unlock();
+	this->notFull.notify_one();
+	this->queueWait.record(std::chrono::steady_clock::now() - arrivalOut.arrivalTime);
+	return true;
+}
+
+void arrivalQueue::close() {
+	{
+		std::lock_guard<std::mutex> lock_guard1(this->queueMTX);
+		this->closed = true;
+	}
+	this->notEmpty.notify_all();
+	this->notFull.notify_all();
+}
+
+bool arrivalQueue::isDrained() {
+	std::lock_guard<std::mutex> lock_guard1(this->queueMTX);
+	return this->closed && this->arrivals.empty();
+}
+
+std::size_t arrivalQueue::getDepth() {
+	std::lock_guard<std::mutex> lock_guard1(this->queueMTX);
+	return this->arrivals.size();
+}
+
+std::uint64_t arrivalQueue::getPushed() {
+	std::lock_guard<std::mutex> lock_guard1(this->queueMTX);
+	return this->pushed;
+}
+
+std::uint64_t arrivalQueue::getDropped() {
+	std::lock_guard<std::mutex> lock_guard1(this->queueMTX);
+	return this->dropped;
+}
+
+std::uint64_t arrivalQueue::getShed() {
+	std::lock_guard<std::mutex> lock_guard1(this->queueMTX);
+	return this->shed;
+}
+
+std::uint64_t arrivalQueue::getWaited() {
+	std::lock_guard<std::mutex> lock_guard1(this->queueMTX);
+	return this->waited;
+}
+
+std::size_t arrivalQueue::getMaxDepth() {
+	std::lock_guard<std::mutex> lock_guard1(this->queueMTX);
+	return this->maxDepth;
+}
+
+double arrivalQueue::getAverageDepth() {
+	std::lock_guard<std::mutex> lock_guard1(this->queueMTX);
+	return this->pushed > 0 ? this->depthSum / this->pushed : 0;
+}
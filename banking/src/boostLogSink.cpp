@@ -0,0 +1,27 @@
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/log/utility/setup/file.hpp>
+#include "banking/boostLogSink.h"
+
+void boostLogSink::logInit() {
+	static boostLogSink* sinkInstance = new boostLogSink(); // never destroyed, threads may log during exit
+	boost::log::add_file_log("test1.log");
+    boost::log::core::get()->set_filter
+    (
+    		boost::log::trivial::severity >= boost::log::trivial::info
+    );
+    loggerClass::setSink(sinkInstance);
+}
+
+void boostLogSink::write(const std::string& input) {
+	BOOST_LOG_TRIVIAL(info) << input;
+}
+
+void boostLogSink::writeEntityEvent(const std::string& entityName, const std::string& input) {
+	BOOST_LOG_TRIVIAL(info) << entityName << " event: " << input;
+}
+
+void boostLogSink::writeClientEvent(const std::string& bankName, std::uint32_t clientNumber, const std::string& input) {
+	BOOST_LOG_TRIVIAL(info) << bankName << "-Local Client-" << clientNumber << " event: " << input;
+}
@@ -18,29 +18,48 @@ centralBank::centralBank() :
 }
 
 void centralBank::loanProcessingMethod(loan *loanPtr) {
-	std::lock_guard<std::mutex> lock_guard2(this->bankMTX);
-	if (this->currentTreasury > loanPtr->getStartingValue()) {
-		loanPtr->validateLoan();
-		loanPtr->setAsReadyForPayment();
-		this->totalLoans++;
-		this->totalValidLoans++;
-		this->logEvent("Central Bank loan granted");
-		this->currentTreasury = this->currentTreasury - loanPtr->getStartingValue();
-		this->totalTreasury = this->totalTreasury + loanPtr->getCost();
-		this->adjustInterestRate();
+	traceSpan span("centralBank::loanProcessingMethod");
+	profiledLock lock_guard2(this->bankMTX);
+	if (defaultCentralBankPolicy::approve(this->policyContext(loanPtr))) {
+		this->commitApprovedLoan(loanPtr);
 	} else {
-		this->totalLoans++;
-		this->logEvent("Central Bank loan not granted");
+		this->commitRejectedLoan();
 	}
 }
 
+void centralBank::commitApprovedLoan(loan *loanPtr) {
+	loanPtr->validateLoan();
+	loanPtr->setAsReadyForPayment();
+	this->totalLoans++;
+	this->totalValidLoans++;
+	this->logEvent("Central Bank loan granted");
+	this->currentTreasury = this->currentTreasury - loanPtr->getStartingValue();
+	ledger::post(this->treasuryAccount, -loanPtr->getStartingValue());
+	this->totalTreasury = this->totalTreasury + loanPtr->getCost();
+	this->adjustInterestRate();
+}
+
+void centralBank::commitRejectedLoan() {
+	this->totalLoans++;
+	this->logEvent("Central Bank loan not granted");
+}
+
 void centralBank::adjustInterestRate() {
-	for (int i = 0; i < 10; i++){
-		if( this->currentTreasury / this->totalTreasury <= CENTRAL_BANK::INTEREST_TO_TREASURY_RATE[0][i]) {
-			this->interestRate = CENTRAL_BANK::INTEREST_TO_TREASURY_RATE[1][i];
-			break;
+	double previousRate = this->interestRate;
+	const economicParameters& currentParameters = this->getParameters();
+	if (currentParameters.hasInterestRateOverride()) {
+		this->interestRate = currentParameters.interestRateOverride;
+	} else {
+		for (int i = 0; i < 10; i++){
+			if( this->currentTreasury / this->totalTreasury <= CENTRAL_BANK::INTEREST_TO_TREASURY_RATE[0][i]) {
+				this->interestRate = CENTRAL_BANK::INTEREST_TO_TREASURY_RATE[1][i];
+				break;
+			}
 		}
 	}
+	if (this->interestRate != previousRate || this->publishedRate.getVersion() == 0) {
+		this->publishedRate.publish(this->interestRate);
+	}
 	this->logEvent("interest rate updated");
 	this->logCurrentInterestRate();
 }
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include "banking/clientRouter.h"
+
+namespace {
+/*!
+ * @brief Mixing client number, so consecutive clients do not land in consecutive regions
+ */
+std::uint64_t mix(std::uint64_t key) {
+	key = (key ^ (key >> 33)) * 0xff51afd7ed558ccdULL;
+	key = (key ^ (key >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+	return key ^ (key >> 33);
+}
+}
+
+clientRouter::clientRouter(policy policyArg, std::vector<localBank*> banksArg) :
+	routingPolicy(policyArg),
+	banks(std::move(banksArg)),
+	regionsAmount(static_cast<std::uint32_t>(std::min<std::size_t>(ROUTING::REGIONS, this->banks.size()))),
+	cachedRates(new std::atomic<double>[this->banks.size()]),
+	openBanks(new std::atomic<bool>[this->banks.size()]),
+	nextOpenBanks(new std::atomic<std::uint32_t>[this->banks.size()]),
+	candidates(new std::atomic<std::uint32_t>[this->banks.size()]),
+	candidatesAmount(static_cast<std::uint32_t>(this->banks.size())),
+	openBanksAmount(static_cast<std::uint32_t>(this->banks.size())),
+	payingBanks(this->banks.size(), false)
+{
+	for (std::uint32_t i = 0; i < this->banks.size(); i++) {
+		this->cachedRates[i].store(0, std::memory_order_relaxed);
+		this->openBanks[i].store(true, std::memory_order_relaxed);
+		this->nextOpenBanks[i].store(i, std::memory_order_relaxed);
+		this->candidates[i].store(i, std::memory_order_relaxed);
+	}
+}
+
+std::unique_ptr<clientRouter> clientRouter::create(const std::string& policyName, std::vector<localBank*> banksArg) {
+	if (banksArg.empty() || banksArg.size() >= NO_BANK) {
+		return nullptr;
+	}
+	policy policyArg;
+	if (policyName == "region") {
+		policyArg = policy::REGION;
+	} else if (policyName == "rate") {
+		policyArg = policy::RATE;
+	} else if (policyName == "hash") {
+		policyArg = policy::HASH;
+	} else {
+		return nullptr;
+	}
+	std::unique_ptr<clientRouter> router(new clientRouter(policyArg, std::move(banksArg)));
+	router->refresh(*economicParameters::defaults());
+	return router;
+}
+
+std::uint32_t clientRouter::jumpHash(std::uint64_t key, std::uint32_t buckets) {
+	std::int64_t bucket {-1};
+	std::int64_t next {0};
+	while (next < buckets) {
+		bucket = next;
+		key = key * 2862933555777941757ULL + 1;
+		next = static_cast<std::int64_t>((bucket + 1) * (static_cast<double>(1LL << 31) / static_cast<double>((key >> 33) + 1)));
+	}
+	return static_cast<std::uint32_t>(bucket);
+}
+
+std::uint32_t clientRouter::route(std::uint32_t clientNumber) const {
+	if (this->openBanksAmount.load(std::memory_order_acquire) == 0) {
+		return NO_BANK;
+	}
+	std::uint32_t banksAmount = static_cast<std::uint32_t>(this->banks.size());
+	switch (this->routingPolicy) {
+	case policy::REGION: {
+		std::uint64_t hash = mix(clientNumber);
+		std::uint32_t region = static_cast<std::uint32_t>(hash % this->regionsAmount);
+		std::uint32_t begin = static_cast<std::uint32_t>(static_cast<std::uint64_t>(region) * banksAmount / this->regionsAmount);
+		std::uint32_t end = static_cast<std::uint32_t>(static_cast<std::uint64_t>(region + 1) * banksAmount / this->regionsAmount);
+		std::uint32_t first = begin + static_cast<std::uint32_t>((hash >> 32) % (end - begin));
+		std::uint32_t index = this->nextOpenBanks[first].load(std::memory_order_relaxed);
+		if (index >= first && index < end) {
+			return index;
+		}
+		// no open bank from **first** to the region end, wrapping to the region start, if the whole region
+		// failed this is already the nearest open bank after the region
+		return this->nextOpenBanks[begin].load(std::memory_order_relaxed);
+	}
+	case policy::RATE: {
+		std::uint32_t amount = this->candidatesAmount.load(std::memory_order_acquire);
+		return this->candidates[clientNumber % amount].load(std::memory_order_relaxed);
+	}
+	case policy::HASH: {
+		std::uint32_t index = clientRouter::jumpHash(clientNumber, banksAmount);
+		// failed bank: clients are spread over open ones by rehashing, the rest of the mapping stays
+		for (std::uint64_t attempt = 1; !this->openBanks[index].load(std::memory_order_relaxed) && attempt <= 8; attempt++) {
+			index = clientRouter::jumpHash(mix(clientNumber + (attempt << 32)), banksAmount);
+		}
+		return this->nextOpenBanks[index].load(std::memory_order_relaxed);
+	}
+	}
+	return NO_BANK;
+}
+
+void clientRouter::refresh(const economicParameters& parameters) {
+	std::uint32_t banksAmount = static_cast<std::uint32_t>(this->banks.size());
+	std::uint32_t openAmount {0};
+	std::uint32_t firstOpen {NO_BANK};
+	double bestRate {std::numeric_limits<double>::max()};
+	bool bestPaying {true};
+	for (std::uint32_t i = 0; i < banksAmount; i++) {
+		bool open = !parameters.isLocalBankFailed(i);
+		double rate = this->banks[i]->getInterestRate();
+		this->cachedRates[i].store(rate, std::memory_order_relaxed);
+		this->openBanks[i].store(open, std::memory_order_relaxed);
+		if (!open) {
+			continue;
+		}
+		if (openAmount++ == 0) {
+			firstOpen = i;
+		}
+		if (this->routingPolicy != policy::RATE) {
+			continue;
+		}
+		// banks paying their own loan are used only if there is no other, like in startLocalBank
+		bool paying = this->banks[i]->isPayingLoan();
+		this->payingBanks[i] = paying;
+		if ((bestPaying && !paying) || (paying == bestPaying && rate < bestRate)) {
+			bestRate = rate;
+			bestPaying = paying;
+		}
+	}
+	// backward pass, so every bank knows the nearest open bank at or after it (route() is then constant time)
+	std::uint32_t nextOpen {firstOpen};
+	for (std::uint32_t i = banksAmount; i-- > 0;) {
+		if (this->openBanks[i].load(std::memory_order_relaxed)) {
+			nextOpen = i;
+		}
+		this->nextOpenBanks[i].store(nextOpen, std::memory_order_relaxed);
+	}
+	if (this->routingPolicy == policy::RATE && openAmount > 0) {
+		std::uint32_t amount {0};
+		for (std::uint32_t i = 0; i < banksAmount; i++) {
+			if (this->openBanks[i].load(std::memory_order_relaxed) && this->cachedRates[i].load(std::memory_order_relaxed) == bestRate
+					&& (bestPaying || !this->payingBanks[i])) {
+				this->candidates[amount++].store(i, std::memory_order_relaxed);
+			}
+		}
+		this->candidatesAmount.store(amount, std::memory_order_release);
+	}
+	this->openBanksAmount.store(openAmount, std::memory_order_release);
+}
@@ -9,12 +9,78 @@
 #include <cstdio>
 #include "banking/dice.h"
 
+thread_local std::minstd_rand* dice::threadEngine {nullptr};
+thread_local dice::tape* dice::threadTape {nullptr};
+
+dice::threadSeed::threadSeed(unsigned seed) :
+	engine(seed),
+	previousEngine(dice::threadEngine)
+{
+	dice::threadEngine = &this->engine;
+}
+
+dice::threadSeed::~threadSeed() {
+	dice::threadEngine = this->previousEngine;
+}
+
+dice::tape::tape() :
+	recording(true),
+	replayed(nullptr),
+	replayedAmount(0),
+	position(0),
+	misses(0),
+	previousTape(dice::threadTape)
+{
+	dice::threadTape = this;
+}
+
+dice::tape::tape(const std::uint8_t* rolls, std::size_t rollsAmount) :
+	recording(false),
+	replayed(rolls),
+	replayedAmount(rollsAmount),
+	position(0),
+	misses(0),
+	previousTape(dice::threadTape)
+{
+	dice::threadTape = this;
+}
+
+dice::tape::~tape() {
+	dice::threadTape = this->previousTape;
+}
+
 dice::dice(int size) :
 	size{size}
 {}
 
+int dice::draw() const {
+	tape* currentTape = dice::threadTape;
+	if (currentTape != nullptr && !currentTape->recording) {
+		if (currentTape->position < currentTape->replayedAmount) {
+			return currentTape->replayed[currentTape->position++];
+		}
+		currentTape->misses++;
+	}
+	int result;
+	if (dice::threadEngine != nullptr) {
+		result = static_cast<int>((*dice::threadEngine)() % this->size) + 1;
+	} else {
+		result = (rand() % this->size) + 1;
+	}
+	if (currentTape != nullptr && currentTape->recording) {
+		currentTape->recorded.push_back(static_cast<std::uint8_t>(result));
+	}
+	return result;
+}
+
 int dice::roll() {
-	return ((rand() % this->size) + 1);
+	return this->draw();
+}
+
+void dice::rollBatch(int* rollsOut, std::size_t rollsAmount) {
+	for (std::size_t i = 0; i < rollsAmount; i++) {
+		rollsOut[i] = this->draw();
+	}
 }
 
 dice::~dice() {}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "banking/economicScenario.h"
+
+namespace {
+/*!
+ * @brief Parsing **central**, **all** or **local<N>** target, returns false on unknown target
+ */
+bool parseTarget(const std::string& targetName, int& targetOut) {
+	if (targetName == "central") {
+		targetOut = scenarioShock::CENTRAL_BANK_TARGET;
+		return true;
+	}
+	if (targetName == "all") {
+		targetOut = scenarioShock::ALL_LOCAL_BANKS_TARGET;
+		return true;
+	}
+	if (targetName.compare(0, 5, "local") != 0 || targetName.size() == 5) {
+		return false;
+	}
+	int localBankNumber {0};
+	for (std::size_t i = 5; i < targetName.size(); i++) {
+		if (targetName[i] < '0' || targetName[i] > '9') {
+			return false;
+		}
+		localBankNumber = localBankNumber * 10 + (targetName[i] - '0');
+	}
+	targetOut = localBankNumber - 1;
+	return localBankNumber > 0;
+}
+}
+
+economicScenario::economicScenario(std::vector<scenarioShock> shocksArg) :
+	shocks(std::move(shocksArg)),
+	nextShock(0)
+{
+	std::stable_sort(this->shocks.begin(), this->shocks.end(), [](const scenarioShock& first, const scenarioShock& second) {
+		return first.tick < second.tick;
+	});
+	this->snapshots.emplace_back(new economicParameters());
+}
+
+std::unique_ptr<economicScenario> economicScenario::parse(std::istream& input, std::string& errorOut) {
+	std::vector<scenarioShock> shocks;
+	std::string line;
+	int lineNumber {0};
+	while (std::getline(input, line)) {
+		lineNumber++;
+		std::istringstream lineStream(line);
+		std::string first;
+		if (!(lineStream >> first) || first[0] == '#') {
+			continue;
+		}
+		std::string shockName;
+		std::string targetName;
+		scenarioShock shock {};
+		std::istringstream tickStream(first);
+		if (!(tickStream >> shock.tick) || !(lineStream >> shockName >> targetName >> shock.value)
+				|| !parseTarget(targetName, shock.target)) {
+			errorOut = "line " + std::to_string(lineNumber) + ": expected <tick> <shock> <target> <value>";
+			return nullptr;
+		}
+		bool centralTarget = shock.target == scenarioShock::CENTRAL_BANK_TARGET;
+		bool allTarget = shock.target == scenarioShock::ALL_LOCAL_BANKS_TARGET;
+		if (shockName == "rate" && centralTarget) {
+			shock.shockType = scenarioShock::type::INTEREST_RATE;
+		} else if (shockName == "inject") {
+			shock.shockType = scenarioShock::type::TREASURY_INJECTION;
+		} else if (shockName == "demand" && allTarget && shock.value > 0) {
+			shock.shockType = scenarioShock::type::DEMAND;
+		} else if (shockName == "delinquency" && allTarget && shock.value >= 0 && shock.value <= 1) {
+			shock.shockType = scenarioShock::type::DELINQUENCY;
+		} else if (shockName == "fail" && !centralTarget) {
+			shock.shockType = scenarioShock::type::BANK_FAILURE;
+		} else {
+			errorOut = "line " + std::to_string(lineNumber) + ": unsupported shock " + shockName + " " + targetName;
+			return nullptr;
+		}
+		shocks.push_back(shock);
+	}
+	return std::unique_ptr<economicScenario>(new economicScenario(std::move(shocks)));
+}
+
+std::unique_ptr<economicScenario> economicScenario::load(const std::string& fileName, std::string& errorOut) {
+	std::ifstream input(fileName);
+	if (!input) {
+		errorOut = "cannot open " + fileName;
+		return nullptr;
+	}
+	std::unique_ptr<economicScenario> scenario = economicScenario::parse(input, errorOut);
+	if (!scenario) {
+		errorOut = fileName + ", " + errorOut;
+	}
+	return scenario;
+}
+
+std::vector<scenarioShock> economicScenario::advance(std::uint64_t tick) {
+	std::vector<scenarioShock> applied;
+	std::unique_ptr<economicParameters> next;
+	while (this->nextShock < this->shocks.size() && this->shocks[this->nextShock].tick <= tick) {
+		const scenarioShock& shock = this->shocks[this->nextShock++];
+		applied.push_back(shock);
+		if (shock.shockType == scenarioShock::type::TREASURY_INJECTION) {
+			continue;
+		}
+		if (!next) {
+			next.reset(new economicParameters(*this->getParameters()));
+			next->epoch = tick;
+		}
+		switch (shock.shockType) {
+		case scenarioShock::type::INTEREST_RATE:
+			next->interestRateOverride = shock.value;
+			break;
+		case scenarioShock::type::DEMAND:
+			next->loanValueMultiplier = shock.value;
+			break;
+		case scenarioShock::type::DELINQUENCY:
+			next->missedPaymentRate = shock.value;
+			break;
+		case scenarioShock::type::BANK_FAILURE:
+			if (shock.target == scenarioShock::ALL_LOCAL_BANKS_TARGET) {
+				next->allLocalBanksFailed = true;
+			} else {
+				if (next->failedLocalBanks.size() <= static_cast<std::size_t>(shock.target)) {
+					next->failedLocalBanks.resize(shock.target + 1, false);
+				}
+				next->failedLocalBanks[shock.target] = true;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	if (next) {
+		this->snapshots.push_back(std::move(next));
+	}
+	return applied;
+}
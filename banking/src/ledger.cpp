@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "banking/ledger.h"
+
+std::atomic<bool> ledger::enabled {false};
+
+namespace {
+/*!
+ * @brief Fixed size part of a journal buffer, never moved after it is allocated
+ */
+struct journalChunk {
+	std::array<ledger::posting, LEDGER::CHUNK_SIZE> postings; ///< Postings, valid up to **published**
+	std::atomic<std::size_t> published {0}; ///< Number of postings visible to the collector
+	std::atomic<journalChunk*> next {nullptr}; ///< Next chunk, set by the owner thread when this one is full
+};
+
+/*!
+ * @brief Balance of one account summed with Neumaier compensation, so collected balances do not drift
+ */
+struct accountBalance {
+	double sum {0}; ///< Running sum
+	double compensation {0}; ///< Lost low order bits of **sum**
+
+	void add(double amount) {
+		double newSum = this->sum + amount;
+		if (std::abs(this->sum) >= std::abs(amount)) {
+			this->compensation += (this->sum - newSum) + amount;
+		} else {
+			this->compensation += (amount - newSum) + this->sum;
+		}
+		this->sum = newSum;
+	};
+
+	double value() const {
+		return this->sum + this->compensation;
+	};
+};
+
+/*!
+ * @brief Append-only journal of one thread
+ *
+ * Owner thread only appends at **tail**, collector only reads from **head** and frees chunks it finished.
+ * Journal of an exited thread is dropped by ledger::collect() once all its postings are collected.
+ */
+struct threadJournal {
+	journalChunk* tail; ///< Chunk currently filled by the owner thread
+	journalChunk* head; ///< Oldest chunk not fully collected, used only under collectorMTX
+	std::size_t collected {0}; ///< Postings of **head** already collected, used only under collectorMTX
+	std::atomic<bool> retired {false}; ///< Set when the owner thread exited, no more postings will come
+
+	threadJournal() :
+		tail(new journalChunk()),
+		head(tail)
+	{};
+
+	~threadJournal() {
+		while (this->head != nullptr) {
+			journalChunk* next = this->head->next.load(std::memory_order_acquire);
+			delete this->head;
+			this->head = next;
+		}
+	};
+};
+
+/*!
+ * @brief Thread local handle of the journal, marks it retired when the thread exits
+ */
+struct journalOwner {
+	std::shared_ptr<threadJournal> journal; ///< Journal of the thread, also kept in **journals** until collected
+
+	~journalOwner() {
+		if (this->journal) {
+			this->journal->retired.store(true, std::memory_order_release);
+		}
+	};
+};
+
+std::atomic<ledger::accountId> nextAccount {ledger::EXTERNAL + 1}; ///< Next id returned by ledger::openAccount()
+std::mutex journalsMTX; ///< Protects **journals**
+std::vector<std::shared_ptr<threadJournal>> journals; ///< Journals of threads which posted anything and were not retired yet
+std::mutex collectorMTX; ///< Serializes collectors, never taken by posting threads
+std::unordered_map<ledger::accountId, accountBalance> balances; ///< Collected balances, protected by collectorMTX
+std::uint64_t collectedPostings {0}; ///< Number of collected postings, protected by collectorMTX
+
+threadJournal& localJournal() {
+	thread_local journalOwner owner;
+	if (!owner.journal) {
+		std::lock_guard<std::mutex> lock_guard1(journalsMTX);
+		owner.journal = std::make_shared<threadJournal>();
+		journals.push_back(owner.journal);
+	}
+	return *owner.journal;
+}
+
+/*!
+ * @brief Applying published postings of **journal**, caller has to hold collectorMTX
+ */
+std::uint64_t collectJournal(threadJournal& journal) {
+	std::uint64_t applied {0};
+	while (true) {
+		std::size_t published = journal.head->published.load(std::memory_order_acquire);
+		for (std::size_t i = journal.collected; i < published; i++) {
+			const ledger::posting& current = journal.head->postings[i];
+			balances[current.account].add(current.amount);
+		}
+		applied += published - journal.collected;
+		journal.collected = published;
+		if (published < LEDGER::CHUNK_SIZE) {
+			return applied;
+		}
+		journalChunk* next = journal.head->next.load(std::memory_order_acquire);
+		if (next == nullptr) {
+			return applied;
+		}
+		delete journal.head;
+		journal.head = next;
+		journal.collected = 0;
+	}
+}
+}
+
+ledger::accountId ledger::openAccount() {
+	return nextAccount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ledger::append(const posting& postingArg) {
+	threadJournal& journal = localJournal();
+	journalChunk* chunk = journal.tail;
+	std::size_t published = chunk->published.load(std::memory_order_relaxed);
+	if (published == LEDGER::CHUNK_SIZE) {
+		journalChunk* fresh = new journalChunk();
+		chunk->next.store(fresh, std::memory_order_release);
+		journal.tail = fresh;
+		chunk = fresh;
+		published = 0;
+	}
+	chunk->postings[published] = postingArg;
+	chunk->published.store(published + 1, std::memory_order_release);
+}
+
+std::uint64_t ledger::collect() {
+	std::vector<std::shared_ptr<threadJournal>> journalsSnapshot;
+	{
+		std::lock_guard<std::mutex> lock_guard1(journalsMTX);
+		journalsSnapshot = journals;
+	}
+	std::lock_guard<std::mutex> lock_guard2(collectorMTX);
+	std::uint64_t applied {0};
+	std::vector<threadJournal*> retiredJournals;
+	for (auto& journal: journalsSnapshot) {
+		// retired flag is read before collecting, so every posting of a retired journal is visible and collected below
+		bool retired = journal->retired.load(std::memory_order_acquire);
+		applied += collectJournal(*journal);
+		if (retired) {
+			retiredJournals.push_back(journal.get());
+		}
+	}
+	collectedPostings += applied;
+	if (!retiredJournals.empty()) {
+		std::lock_guard<std::mutex> lock_guard1(journalsMTX);
+		journals.erase(std::remove_if(journals.begin(), journals.end(), [&retiredJournals](const std::shared_ptr<threadJournal>& journal) {
+			return std::find(retiredJournals.begin(), retiredJournals.end(), journal.get()) != retiredJournals.end();
+		}), journals.end());
+	}
+	return applied;
+}
+
+std::size_t ledger::getJournalsAmount() {
+	std::lock_guard<std::mutex> lock_guard1(journalsMTX);
+	return journals.size();
+}
+
+double ledger::getBalance(accountId account) {
+	std::lock_guard<std::mutex> lock_guard1(collectorMTX);
+	auto balance = balances.find(account);
+	return balance == balances.end() ? 0 : balance->second.value();
+}
+
+double ledger::getImbalance() {
+	std::lock_guard<std::mutex> lock_guard1(collectorMTX);
+	accountBalance imbalance;
+	for (auto& balance: balances) {
+		imbalance.add(balance.second.value());
+	}
+	return imbalance.value();
+}
+
+bool ledger::isBalanced() {
+	double imbalance = ledger::getImbalance();
+	std::lock_guard<std::mutex> lock_guard1(collectorMTX);
+	double scale {1};
+	for (auto& balance: balances) {
+		scale += std::abs(balance.second.value());
+	}
+	return std::abs(imbalance) <= LEDGER::RELATIVE_TOLERANCE * scale;
+}
+
+std::uint64_t ledger::getCollectedPostings() {
+	std::lock_guard<std::mutex> lock_guard1(collectorMTX);
+	return collectedPostings;
+}
+
+bool ledger::isEqual(double expected, double actual) {
+	return std::abs(expected - actual) <= LEDGER::RELATIVE_TOLERANCE * std::max({1.0, std::abs(expected), std::abs(actual)});
+}
+
+void ledger::clear() {
+	ledger::collect();
+	std::lock_guard<std::mutex> lock_guard1(collectorMTX);
+	balances.clear();
+	collectedPostings = 0;
+}
@@ -0,0 +1,55 @@
+#include "banking/ledgerAuditor.h"
+#include "banking/loggerClass.h"
+
+ledgerAuditor::ledgerAuditor(const std::vector<bank*>& banksArg, std::chrono::milliseconds intervalArg) :
+	banks(banksArg),
+	interval(intervalArg),
+	passes(0),
+	failures(0),
+	stopRequested(false)
+{
+	this->auditorThread = std::thread(&ledgerAuditor::run, this);
+}
+
+ledgerAuditor::~ledgerAuditor() {
+	{
+		std::lock_guard<std::mutex> lock_guard1(this->stopMTX);
+		this->stopRequested = true;
+	}
+	this->stopCondition.notify_all();
+	this->auditorThread.join();
+}
+
+void ledgerAuditor::run() {
+	std::unique_lock<std::mutex> lock1(this->stopMTX);
+	while (!this->stopCondition.wait_for(lock1, this->interval, [this]() { return this->stopRequested; })) {
+		lock1.unlock();
+		this->auditPass();
+		lock1.lock();
+	}
+}
+
+int ledgerAuditor::auditPass() {
+	int mismatches {0};
+	for (auto bankPtr: this->banks) {
+		if (!bankPtr->auditLedger()) {
+			mismatches++;
+			bankPtr->logEvent("ledger audit failed: treasury " + std::to_string(bankPtr->getCurrentTreasury())
+					+ ", ledger balance " + std::to_string(ledger::getBalance(bankPtr->getTreasuryAccount())));
+		}
+	}
+	std::lock_guard<std::mutex> lock_guard1(this->stopMTX);
+	this->passes++;
+	this->failures = this->failures + mismatches;
+	return mismatches;
+}
+
+std::uint64_t ledgerAuditor::getPasses() {
+	std::lock_guard<std::mutex> lock_guard1(this->stopMTX);
+	return this->passes;
+}
+
+std::uint64_t ledgerAuditor::getFailures() {
+	std::lock_guard<std::mutex> lock_guard1(this->stopMTX);
+	return this->failures;
+}
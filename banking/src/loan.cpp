@@ -6,33 +6,177 @@
  */
 
 #include "banking/loan.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include "../../constants.h"
 
-loan::loan(double loanValueArg, int instalmentsAmountArg, double interestRateArg) :
+namespace {
+std::int64_t rateBucketOf(double rate) {
+	return static_cast<std::int64_t>(std::floor(rate / LOAN::RATE_BUCKET));
+}
+}
+
+loan::loan(double loanValueArg, int instalmentsAmountArg, double interestRateArg, std::uint64_t rateVersionArg,
+		amortization scheduleArg) :
 	startingValue(loanValueArg),
 	valueLeft(loanValueArg*(1.0 + interestRateArg)),
 	cost(loanValueArg*interestRateArg),
 	startingInstalmentAmount(instalmentsAmountArg),
 	instalmentAmountLeft(instalmentsAmountArg),
+	interestRate(interestRateArg),
+	rateVersion(rateVersionArg),
+	schedule(scheduleArg),
+	principalLeft(loanValueArg),
 	validated (false),
 	paymentReadiness (false)
 {
-	this->setSingleInstalmentValue();
+	if (this->schedule == amortization::EQUAL) {
+		this->setSingleInstalmentValue();
+	} else {
+		this->recomputeSchedule();
+	}
+}
+
+loan::loan(const loan& other) :
+	startingValue(other.startingValue),
+	valueLeft(other.valueLeft),
+	cost(other.cost),
+	singleInstalmentValue(other.singleInstalmentValue),
+	startingInstalmentAmount(other.startingInstalmentAmount),
+	instalmentAmountLeft(other.instalmentAmountLeft),
+	interestRate(other.interestRate),
+	rateVersion(other.rateVersion),
+	schedule(other.schedule),
+	principalLeft(other.principalLeft),
+	singleInstalmentPrincipal(other.singleInstalmentPrincipal),
+	rateReference(other.rateReference),
+	rateMargin(other.rateMargin),
+	rateBucket(other.rateBucket),
+	repricingsAmount(other.repricingsAmount),
+	missedInstalments(other.missedInstalments),
+	validated(other.validated.load(std::memory_order_acquire)),
+	paymentReadiness(other.paymentReadiness.load(std::memory_order_acquire))
+{}
+
+loan& loan::operator=(const loan& other) {
+	this->startingValue = other.startingValue;
+	this->valueLeft = other.valueLeft;
+	this->cost = other.cost;
+	this->singleInstalmentValue = other.singleInstalmentValue;
+	this->startingInstalmentAmount = other.startingInstalmentAmount;
+	this->instalmentAmountLeft = other.instalmentAmountLeft;
+	this->interestRate = other.interestRate;
+	this->rateVersion = other.rateVersion;
+	this->schedule = other.schedule;
+	this->principalLeft = other.principalLeft;
+	this->singleInstalmentPrincipal = other.singleInstalmentPrincipal;
+	this->rateReference = other.rateReference;
+	this->rateMargin = other.rateMargin;
+	this->rateBucket = other.rateBucket;
+	this->repricingsAmount = other.repricingsAmount;
+	this->missedInstalments = other.missedInstalments;
+	this->validated.store(other.validated.load(std::memory_order_acquire), std::memory_order_release);
+	this->paymentReadiness.store(other.paymentReadiness.load(std::memory_order_acquire), std::memory_order_release);
+	return *this;
+}
+
+bool loan::parseSchedule(const std::string& scheduleName, amortization& scheduleOut) {
+	if (scheduleName == "equal") {
+		scheduleOut = amortization::EQUAL;
+	} else if (scheduleName == "annuity") {
+		scheduleOut = amortization::ANNUITY;
+	} else if (scheduleName == "declining") {
+		scheduleOut = amortization::DECLINING;
+	} else {
+		return false;
+	}
+	return true;
 }
 
 void loan::setSingleInstalmentValue() {
-	this->singleInstalmentValue = this->valueLeft / this->startingInstalmentAmount;
+	if (this->schedule == amortization::EQUAL) {
+		// instalmentAmountLeft == startingInstalmentAmount unless the loan was repriced
+		this->singleInstalmentValue = this->valueLeft / this->instalmentAmountLeft;
+		this->singleInstalmentPrincipal = this->principalLeft / this->instalmentAmountLeft;
+		return;
+	}
+	if (this->instalmentAmountLeft <= 0) {
+		this->singleInstalmentValue = 0;
+		this->singleInstalmentPrincipal = 0;
+		return;
+	}
+	double periodRate = this->interestRate / this->startingInstalmentAmount;
+	double interest = this->principalLeft * periodRate;
+	if (this->schedule == amortization::DECLINING) {
+		this->singleInstalmentPrincipal = this->principalLeft / this->instalmentAmountLeft;
+		this->singleInstalmentValue = this->singleInstalmentPrincipal + interest;
+	} else if (periodRate == 0) {
+		this->singleInstalmentValue = this->principalLeft / this->instalmentAmountLeft;
+		this->singleInstalmentPrincipal = this->singleInstalmentValue;
+	} else {
+		this->singleInstalmentValue = interest / (1.0 - std::pow(1.0 + periodRate, -this->instalmentAmountLeft));
+		this->singleInstalmentPrincipal = this->singleInstalmentValue - interest;
+	}
+}
+
+void loan::recomputeSchedule() {
+	double previousValueLeft = this->valueLeft;
+	double periodRate = this->startingInstalmentAmount > 0 ? this->interestRate / this->startingInstalmentAmount : 0;
+	int instalmentsLeft = std::max(0, this->instalmentAmountLeft);
+	// annuity and declining installments depend only on principalLeft, equal installment on valueLeft
+	this->setSingleInstalmentValue();
+	switch (this->schedule) {
+	case amortization::EQUAL:
+		this->valueLeft = this->principalLeft + this->startingValue * periodRate * instalmentsLeft;
+		this->setSingleInstalmentValue();
+		break;
+	case amortization::ANNUITY:
+		this->valueLeft = this->singleInstalmentValue * instalmentsLeft;
+		break;
+	case amortization::DECLINING:
+		// principal parts are equal, so interest falls linearly from principalLeft * periodRate to 1/k of it
+		this->valueLeft = this->principalLeft + this->principalLeft * periodRate * (instalmentsLeft + 1) / 2.0;
+		break;
+	}
+	this->cost = this->cost + this->valueLeft - previousValueLeft;
+}
+
+void loan::setRateReference(const rateSeqlock* referenceArg, double referenceRateArg) {
+	this->rateReference = referenceArg;
+	this->rateMargin = this->interestRate - referenceRateArg;
+	this->rateBucket = rateBucketOf(referenceRateArg);
+}
+
+bool loan::followReferenceRate() {
+	if (this->rateReference == nullptr || this->rateReference->getVersion() == this->rateVersion) {
+		return false;
+	}
+	double referenceRate {0};
+	this->rateVersion = this->rateReference->read(referenceRate);
+	std::int64_t bucket = rateBucketOf(referenceRate);
+	if (bucket == this->rateBucket) {
+		return false;
+	}
+	this->rateBucket = bucket;
+	this->interestRate = std::max(0.0, referenceRate + this->rateMargin);
+	this->repricingsAmount++;
+	this->recomputeSchedule();
+	return true;
 }
 
 bool loan::payAndUpdate() {
 
 	this->valueLeft = this->valueLeft - this->singleInstalmentValue;
+	this->principalLeft = this->principalLeft - this->singleInstalmentPrincipal;
 	this->instalmentAmountLeft--;
 	if (this->instalmentAmountLeft == 0) {
-		this->validated = false;
-		this->paymentReadiness = false;
+		this->validated.store(false, std::memory_order_release);
+		this->paymentReadiness.store(false, std::memory_order_release);
+	} else if (!this->followReferenceRate() && this->schedule != amortization::EQUAL) {
+		this->setSingleInstalmentValue();
 	}
-	return this->validated;
+	return this->validated.load(std::memory_order_relaxed);
 }
 
 loan::~loan() {
@@ -0,0 +1,44 @@
+#include "banking/loanArena.h"
+#include "banking/numaTopology.h"
+
+loanArena::loanArena(int nodeArg) :
+	node(nodeArg)
+{}
+
+loanArena::~loanArena() {
+	for (void* chunk: this->chunks) {
+		numaTopology::freeOnNode(chunk, NUMA::ARENA_CHUNK_LOANS * BLOCK_SIZE);
+	}
+}
+
+void* loanArena::allocateBlock() {
+	profiledLock lock_guard1(this->arenaMTX);
+	if (this->freeBlocks == nullptr) {
+		if (this->chunks.size() == this->chunks.capacity()) {
+			this->chunks.reserve(2 * this->chunks.size() + 1);
+		}
+		char* chunk = static_cast<char*>(numaTopology::allocateOnNode(NUMA::ARENA_CHUNK_LOANS * BLOCK_SIZE, this->node));
+		if (chunk == nullptr) {
+			throw std::bad_alloc();
+		}
+		this->chunks.push_back(chunk);
+		// blocks are linked in address order, consecutive loans land next to each other
+		for (std::size_t i = NUMA::ARENA_CHUNK_LOANS; i > 0; i--) {
+			freeBlock* block = reinterpret_cast<freeBlock*>(chunk + (i - 1) * BLOCK_SIZE);
+			block->next = this->freeBlocks;
+			this->freeBlocks = block;
+		}
+	}
+	freeBlock* block = this->freeBlocks;
+	this->freeBlocks = block->next;
+	this->usedBlocks++;
+	return block;
+}
+
+void loanArena::releaseBlock(void* block) {
+	profiledLock lock_guard1(this->arenaMTX);
+	freeBlock* released = static_cast<freeBlock*>(block);
+	released->next = this->freeBlocks;
+	this->freeBlocks = released;
+	this->usedBlocks--;
+}
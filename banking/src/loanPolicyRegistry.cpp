@@ -0,0 +1,67 @@
+#include "banking/loanPolicyRegistry.h"
+
+std::map<std::string, loanPolicyRegistry::localBankFactory>& loanPolicyRegistry::localBankFactories() {
+	static std::map<std::string, localBankFactory> factories {
+		{"default", [](std::string nameArg, centralBank* centralBankPtr) {
+			return std::unique_ptr<localBank>(new localBank(nameArg, centralBankPtr));
+		}},
+		{"dice", [](std::string nameArg, centralBank* centralBankPtr) {
+			return std::unique_ptr<localBank>(new diceLocalBank(nameArg, centralBankPtr));
+		}},
+		{"creditScoring", [](std::string nameArg, centralBank* centralBankPtr) {
+			return std::unique_ptr<localBank>(new creditScoringLocalBank(nameArg, centralBankPtr));
+		}},
+		{"treasuryRatio", [](std::string nameArg, centralBank* centralBankPtr) {
+			return std::unique_ptr<localBank>(new treasuryRatioLocalBank(nameArg, centralBankPtr));
+		}},
+		{"interestSensitive", [](std::string nameArg, centralBank* centralBankPtr) {
+			return std::unique_ptr<localBank>(new interestSensitiveLocalBank(nameArg, centralBankPtr));
+		}}
+	};
+	return factories;
+}
+
+std::map<std::string, loanPolicyRegistry::centralBankFactory>& loanPolicyRegistry::centralBankFactories() {
+	static std::map<std::string, centralBankFactory> factories {
+		{"default", []() {
+			return std::unique_ptr<centralBank>(new centralBank());
+		}},
+		{"treasuryRatio", []() {
+			return std::unique_ptr<centralBank>(new policyCentralBank<
+					policyChain<treasuryFeasibilityPolicy, treasuryRatioPolicy>>());
+		}}
+	};
+	return factories;
+}
+
+std::unique_ptr<localBank> loanPolicyRegistry::createLocalBank(const std::string& policyName, std::string nameArg, centralBank* centralBankPtr) {
+	auto factory = localBankFactories().find(policyName);
+	if (factory == localBankFactories().end()) {
+		return nullptr;
+	}
+	return factory->second(nameArg, centralBankPtr);
+}
+
+std::unique_ptr<centralBank> loanPolicyRegistry::createCentralBank(const std::string& policyName) {
+	auto factory = centralBankFactories().find(policyName);
+	if (factory == centralBankFactories().end()) {
+		return nullptr;
+	}
+	return factory->second();
+}
+
+std::vector<std::string> loanPolicyRegistry::getLocalBankPolicyNames() {
+	std::vector<std::string> names;
+	for (auto& factory: localBankFactories()) {
+		names.push_back(factory.first);
+	}
+	return names;
+}
+
+std::vector<std::string> loanPolicyRegistry::getCentralBankPolicyNames() {
+	std::vector<std::string> names;
+	for (auto& factory: centralBankFactories()) {
+		names.push_back(factory.first);
+	}
+	return names;
+}
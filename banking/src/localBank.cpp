@@ -5,14 +5,21 @@
  *      Author: pjoter
  */
 
+#include <algorithm>
 #include <iostream>
 #include <mutex>
 #include <vector>
-#include <iostream>
 #include "banking/localBank.h"
 #include "../../constants.h"
 
-localBank::localBank(std::string nameArg, centralBank* centralBankPtr) :
+// Batch kernels are compiled for several instruction sets and the best one is picked at load time
+#ifdef ECONOMY2_SIMD_DISPATCH
+#define BATCH_KERNEL_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define BATCH_KERNEL_CLONES
+#endif
+
+localBank::localBank(const std::string& nameArg, centralBank* centralBankPtr) :
 		bank(nameArg, LOCAL_BANK::STARTING_TREASURY, LOCAL_BANK::INTEREST_RATE),
 		client(),
 		masterBankPtr(centralBankPtr),
@@ -29,59 +36,190 @@ localBank::~localBank() {
 }
 
 void localBank::loanProcessingMethod(loan *loanPtr) {
-	std::lock_guard<std::mutex> lock_guard2(this->bankMTX);
+	traceSpan span("localBank::loanProcessingMethod");
+	profiledLock lock_guard2(this->bankMTX);
 	if (this->loanValidationMethod(loanPtr)) {
-		if (this->currentTreasury > loanPtr->getStartingValue()) {
-			loanPtr->setAsReadyForPayment();
-			this->currentTreasury = this->currentTreasury - loanPtr->getStartingValue();
-			this->totalTreasury = this->totalTreasury + loanPtr->getCost();
-			this->totalLoans++;
-			this->totalValidLoans++;
-			this->logEvent("loan granted from treasury");
-		} else {
-			this->waitingLoans.push_back(loanPtr);
-			this->amountNeededForLoans = this->amountNeededForLoans + loanPtr->getStartingValue();
-			this->totalLoans++;
-			this->totalValidLoans++;
-			this->logEvent("not enough money in treasury, adding loan to waiting vector");
-			if (this->amountNeededForLoans >= LOCAL_BANK::THRESHOLD_FOR_LOAN) {
-				this->applyForLoan();
-			}
-		}
+		this->commitApprovedLoan(loanPtr);
 	} else {
+		this->commitRejectedLoan();
+	}
+}
+
+void localBank::commitApprovedLoan(loan *loanPtr) {
+	if (this->currentTreasury > loanPtr->getStartingValue()) {
+		loanPtr->setAsReadyForPayment();
+		this->currentTreasury = this->currentTreasury - loanPtr->getStartingValue();
+		ledger::transfer(this->treasuryAccount, ledger::EXTERNAL, loanPtr->getStartingValue());
+		this->totalTreasury = this->totalTreasury + loanPtr->getCost();
 		this->totalLoans++;
-		this->logEvent("loan not granted");
+		this->totalValidLoans++;
+		this->logEvent("loan granted from treasury");
+	} else {
+		this->waitingLoans.push_back(loanPtr);
+		this->amountNeededForLoans = this->amountNeededForLoans + loanPtr->getStartingValue();
+		this->totalLoans++;
+		this->totalValidLoans++;
+		this->logEvent("not enough money in treasury, adding loan to waiting vector");
+		if (this->amountNeededForLoans >= LOCAL_BANK::THRESHOLD_FOR_LOAN) {
+			this->applyForLoan();
+		}
 	}
 }
 
+void localBank::commitRejectedLoan() {
+	this->totalLoans++;
+	this->logEvent("loan not granted");
+}
+
 bool localBank::loanValidationMethod(loan *loanPtr) {
-	return (this->diceBank.roll() + static_cast<int>(loanPtr->getStartingValue()) % 3)  >= 6 && !this->clientLoanPtr->isLoanValid();
+	return defaultLocalBankPolicy::approve(this->policyContext(loanPtr));
+}
+
+BATCH_KERNEL_CLONES
+void localBank::validateBatch(const int* rolls, const double* values, std::uint8_t* validOut, std::size_t loansAmount) {
+	for (std::size_t i = 0; i < loansAmount; i++) {
+		validOut[i] = (rolls[i] + static_cast<int>(values[i]) % 3) >= LOAN_POLICY::DICE_THRESHOLD;
+	}
+}
+
+BATCH_KERNEL_CLONES
+std::size_t localBank::countFeasible(const double* cumulativeValues, std::size_t loansAmount, double treasury) {
+	std::size_t feasible {0};
+	for (std::size_t i = 0; i < loansAmount; i++) {
+		feasible += cumulativeValues[i] < treasury;
+	}
+	return feasible;
+}
+
+void localBank::loanProcessingBatch(const std::vector<loan*>& loanPtrs) {
+	traceSpan span("localBank::loanProcessingBatch");
+	const std::size_t loansAmount = loanPtrs.size();
+	if (loansAmount == 0) {
+		return;
+	}
+	std::vector<int> rolls(loansAmount);
+	std::vector<double> values(loansAmount);
+	std::vector<std::uint8_t> valid(loansAmount);
+	this->diceBank.rollBatch(rolls.data(), loansAmount);
+	for (std::size_t i = 0; i < loansAmount; i++) {
+		values[i] = loanPtrs[i]->getStartingValue();
+	}
+	localBank::validateBatch(rolls.data(), values.data(), valid.data(), loansAmount);
+
+	profiledLock lock_guard2(this->bankMTX);
+	if (this->clientLoanPtr->isLoanValid() || this->delinquencyRatio() > LOAN_POLICY::MAXIMAL_DELINQUENCY_RATIO) {
+		this->totalLoans = this->totalLoans + loansAmount;
+		LOG_EVENT_LAZY(this->logEvent, "batch of " + std::to_string(loansAmount) + " loans not granted");
+		return;
+	}
+	this->commitBatch(loanPtrs, valid.data());
+}
+
+void localBank::commitBatch(const std::vector<loan*>& loanPtrs, const std::uint8_t* valid) {
+	const std::size_t loansAmount = loanPtrs.size();
+	std::vector<double> cumulativeValues(loansAmount);
+	double cumulativeValue {0};
+	for (std::size_t i = 0; i < loansAmount; i++) {
+		cumulativeValue = cumulativeValue + loanPtrs[i]->getStartingValue() * valid[i];
+		cumulativeValues[i] = cumulativeValue;
+	}
+	this->totalLoans = this->totalLoans + loansAmount;
+	const std::size_t feasible = localBank::countFeasible(cumulativeValues.data(), loansAmount, this->currentTreasury);
+	int grantedAmount {0};
+	int waitingAmount {0};
+	for (std::size_t i = 0; i < loansAmount; i++) {
+		if (!valid[i]) {
+			continue;
+		}
+		if (i < feasible) {
+			loanPtrs[i]->setAsReadyForPayment();
+			this->totalTreasury = this->totalTreasury + loanPtrs[i]->getCost();
+			grantedAmount++;
+		} else {
+			this->waitingLoans.push_back(loanPtrs[i]);
+			this->amountNeededForLoans = this->amountNeededForLoans + loanPtrs[i]->getStartingValue();
+			waitingAmount++;
+		}
+	}
+	if (feasible > 0) {
+		this->currentTreasury = this->currentTreasury - cumulativeValues[feasible - 1];
+		ledger::transfer(this->treasuryAccount, ledger::EXTERNAL, cumulativeValues[feasible - 1]);
+	}
+	this->totalValidLoans = this->totalValidLoans + grantedAmount + waitingAmount;
+	LOG_EVENT_LAZY(this->logEvent, "batch of " + std::to_string(loansAmount) + " loans processed: "
+			+ std::to_string(grantedAmount) + " granted from treasury, "
+			+ std::to_string(waitingAmount) + " added to waiting vector");
+	if (this->amountNeededForLoans >= LOCAL_BANK::THRESHOLD_FOR_LOAN) {
+		this->applyForLoan();
+	}
+}
+
+bool localBank::reportMissedPayment(loan* loanPtr) {
+	profiledLock lock_guard1(this->bankMTX);
+	int missed = loanPtr->missInstalment();
+	if (missed < LOAN::WRITE_OFF_MISSED_INSTALMENTS) {
+		this->delinquentLoans.recordMissed(missed, loanPtr->getValueLeft());
+		LOG_EVENT_LAZY(this->logEvent, "installment missed, " + std::to_string(missed * LOAN::DAYS_PER_INSTALMENT) + " days past due");
+		return false;
+	}
+	this->delinquentLoans.recordWrittenOff(missed, loanPtr->getValueLeft());
+	this->totalTreasury = this->totalTreasury - loanPtr->getValueLeft();
+	loanPtr->writeOff();
+	this->logEvent("loan written off");
+	return true;
+}
+
+void localBank::reportCuredLoan(loan* loanPtr) {
+	profiledLock lock_guard1(this->bankMTX);
+	this->delinquentLoans.recordCured(loanPtr->getMissedInstalments(), loanPtr->getValueLeft());
+	loanPtr->cure();
 }
 
 void localBank::paymentMethod() {
-	if (this->clientLoanPtr->isReadyToBePayed()) {
-		this->logEvent("Central Bank loan installment payment");
-		this->logCurrentTreasuryRate();
-		this->currentTreasury = this->currentTreasury - this->clientLoanPtr->getSingleInstallmentValue();
-		this->masterBankPtr->receivePayment(clientLoanPtr);
-		this->clientLoanPtr->payAndUpdate();
+	// whole payment under bankMTX: once payAndUpdate() invalidates the loan a client thread may replace it
+	// (localBank::generateLoan()), lock order Local Bank -> Central Bank is the same as in applyForLoan()
+	profiledLock lock_guard1(this->bankMTX);
+	if (!this->clientLoanPtr->isReadyToBePayed()) {
+		return;
+	}
+	this->logEvent("Central Bank loan installment payment");
+	this->logCurrentTreasuryRate();
+	this->currentTreasury = this->currentTreasury - this->clientLoanPtr->getSingleInstallmentValue();
+	ledger::post(this->treasuryAccount, -this->clientLoanPtr->getSingleInstallmentValue());
+	this->masterBankPtr->receivePayment(clientLoanPtr);
+	this->clientLoanPtr->payAndUpdate();
+}
+
+bool localBank::cancelWaitingLoan(loan *loanPtr) {
+	profiledLock lock_guard1(this->bankMTX);
+	auto waitingLoan = std::find(this->waitingLoans.begin(), this->waitingLoans.end(), loanPtr);
+	if (waitingLoan == this->waitingLoans.end()) {
+		return false;
 	}
+	this->waitingLoans.erase(waitingLoan);
+	this->amountNeededForLoans = this->amountNeededForLoans - loanPtr->getStartingValue();
+	this->totalValidLoans--;
+	this->logEvent("waiting loan cancelled by client");
+	return true;
 }
 
 double localBank::generateTotalLoanValue() {
-	std::lock_guard<std::mutex> lock_guard1(this->bankMTX);
+	profiledLock lock_guard1(this->bankMTX);
 	return this->amountNeededForLoans;
 }
 
 void localBank::generateLoan() {
 	delete this->clientLoanPtr;
+	rateSnapshot rate = this->getRateSnapshot();
 	this->clientLoanPtr = new loan(
 		this->amountNeededForLoans,
 		this->generateTotalInstalmentsAmount(),
-		this->masterBankPtr->getInterestRate());
+		rate.centralRate,
+		rate.version);
 }
 
 void localBank::applyForLoan() {
+	traceSpan span("applyForLoan");
 	this->generateLoan();
 	this->logEvent("Applying for Central Bank loan");
 	this->masterBankPtr->loanProcessingMethod(this->clientLoanPtr);
@@ -89,12 +227,14 @@ void localBank::applyForLoan() {
 		this->logEvent("Central Bank loan granted");
 		this->logCurrentTreasuryRate();
 		this->currentTreasury = this->currentTreasury + this->amountNeededForLoans;
+		ledger::post(this->treasuryAccount, this->amountNeededForLoans);
 		this->totalTreasury = this->totalTreasury + (this->amountNeededForLoans * this->interestRate);
 		for (auto loan: waitingLoans) {
 			this->totalLoans++;
 			this->totalValidLoans++;
 			loan->setAsReadyForPayment();
 			this->currentTreasury = this->currentTreasury - loan->getStartingValue();
+			ledger::transfer(this->treasuryAccount, ledger::EXTERNAL, loan->getStartingValue());
 		}
 		this->waitingLoans.clear();
 		this->amountNeededForLoans = 0;
@@ -8,8 +8,17 @@
 #include "banking/localClient.h"
 #include "../../constants.h"
 
-localClient::localClient(std::string nameArg, localBank* localBankPtr) :
-	name(nameArg),
+localClient::localClient(std::uint32_t clientNumberArg, localBank* localBankPtr) :
+	localClient(NO_NAME, clientNumberArg, localBankPtr)
+{}
+
+localClient::localClient(const std::string& nameArg, localBank* localBankPtr) :
+	localClient(nameTable::intern(nameArg), 0, localBankPtr)
+{}
+
+localClient::localClient(nameTable::entityId nameIdArg, std::uint32_t clientNumberArg, localBank* localBankPtr) :
+	nameId(nameIdArg),
+	clientNumber(clientNumberArg),
 	masterBankPtr(localBankPtr)
 {
 	this->totalInstalmentsAmount = this->generateTotalInstalmentsAmount();
@@ -20,22 +29,40 @@ localClient::localClient(std::string nameArg, localBank* localBankPtr) :
 
 void localClient::paymentMethod() {
 	if (this->clientLoanPtr->isReadyToBePayed()) {
+		if (this->missesInstallment()) {
+			this->masterBankPtr->reportMissedPayment(this->clientLoanPtr);
+			return;
+		}
+		if (this->clientLoanPtr->getMissedInstalments() > 0) {
+			this->masterBankPtr->reportCuredLoan(this->clientLoanPtr);
+		}
+		ledger::post(ledger::EXTERNAL, -this->clientLoanPtr->getSingleInstallmentValue());
 		this->masterBankPtr->receivePayment(clientLoanPtr);
 		this->clientLoanPtr->payAndUpdate();
 	}
 }
 
+bool localClient::missesInstallment() {
+	double missedPaymentRate = this->masterBankPtr->getParameters().missedPaymentRate;
+	if (missedPaymentRate <= 0) {
+		return false;
+	}
+	profiledLock ul(mtx);
+	dice missDice(LOCAL_CLIENT::MISSED_PAYMENT_DICE_SIZE);
+	return missDice.roll() <= missedPaymentRate * LOCAL_CLIENT::MISSED_PAYMENT_DICE_SIZE;
+}
+
 double localClient::generateTotalLoanValue() {
-	std::unique_lock<std::mutex> ul(mtx);
+	profiledLock ul(mtx);
 	int roll = diceClient.roll();
-	this->logEvent("generating loan total value - dice roll: " + std::to_string(roll));
-	return roll * LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER;
+	LOG_EVENT_LAZY(this->logEvent, "generating loan total value - dice roll: " + std::to_string(roll));
+	return roll * this->masterBankPtr->getParameters().loanValueMultiplier;
 }
 
 int localClient::generateTotalInstalmentsAmount() {
-	std::unique_lock<std::mutex> ul(mtx);
+	profiledLock ul(mtx);
 	int roll = diceClient.roll();
-	this->logEvent("generating loan total installments amount - dice roll: " + std::to_string(roll));
+	LOG_EVENT_LAZY(this->logEvent, "generating loan total installments amount - dice roll: " + std::to_string(roll));
 	if (roll < LOCAL_CLIENT::MINIMAL_INSTALLMENT_AMOUNT) {
 		roll += LOCAL_CLIENT::MINIMAL_INSTALLMENT_AMOUNT;
 	}
@@ -43,14 +70,34 @@ int localClient::generateTotalInstalmentsAmount() {
 }
 
 void localClient::generateLoan() {
-	this->clientLoanPtr = new loan(
-			this->totalLoanValue,
-			this->totalInstalmentsAmount,
-			this->masterBankPtr->getInterestRate());
+	rateSnapshot rate = this->masterBankPtr->getRateSnapshot();
+	this->loanArenaPtr = this->masterBankPtr->getLoanArena();
+	if (this->loanArenaPtr != nullptr) {
+		this->clientLoanPtr = this->loanArenaPtr->create(
+				this->totalLoanValue,
+				this->totalInstalmentsAmount,
+				rate.getRate(),
+				rate.version,
+				this->masterBankPtr->getLoanSchedule());
+	} else {
+		this->clientLoanPtr = new loan(
+				this->totalLoanValue,
+				this->totalInstalmentsAmount,
+				rate.getRate(),
+				rate.version,
+				this->masterBankPtr->getLoanSchedule());
+	}
+	if (this->masterBankPtr->isVariableRateLoans()) {
+		this->clientLoanPtr->setRateReference(this->masterBankPtr->getRateReference(), rate.centralRate);
+	}
 }
 
 localClient::~localClient() {
-	delete this->clientLoanPtr;
+	if (this->loanArenaPtr != nullptr) {
+		this->loanArenaPtr->destroy(this->clientLoanPtr);
+	} else {
+		delete this->clientLoanPtr;
+	}
 	this->clientLoanPtr = nullptr;
 }
 
@@ -5,28 +5,51 @@
  *      Author: pjoter
  */
 #include <banking/loggerClass.h>
+#include <banking/traceRecorder.h>
+
+std::atomic<bool> loggerClass::headless {false};
+std::atomic<std::uint64_t> loggerClass::eventCount {0};
+std::atomic<logSink*> loggerClass::sink {nullptr};
 
 loggerClass::loggerClass() {
 
 }
 
-void loggerClass::logInit() {
-	boost::log::add_file_log("test1.log");
-//	boost::log::add_file_log(
-//    		boost::log::keywords::file_name = "sample.log"
-//    				);
-    boost::log::core::get()->set_filter
-    (
-    		boost::log::trivial::severity >= boost::log::trivial::info
-    );    
+void loggerClass::logEvent(const std::string& input) {
+	if (loggerClass::isHeadless()) {
+		return;
+	}
+	traceSpan span("logEvent");
+	eventCount.fetch_add(1, std::memory_order_relaxed);
+	if (logSink* sinkPtr = loggerClass::getSink()) {
+		sinkPtr->write(input);
+	}
+}
+
+void loggerClass::logEvent(nameTable::entityId entityIdArg, const std::string& input) {
+	if (loggerClass::isHeadless()) {
+		return;
+	}
+	traceSpan span("logEvent");
+	eventCount.fetch_add(1, std::memory_order_relaxed);
+	if (logSink* sinkPtr = loggerClass::getSink()) {
+		sinkPtr->writeEntityEvent(nameTable::getName(entityIdArg), input);
+	}
 }
 
-void loggerClass::logEvent(std::string input) {
-	BOOST_LOG_TRIVIAL(info) << input;
+void loggerClass::logClientEvent(nameTable::entityId bankIdArg, std::uint32_t clientNumber, const std::string& input) {
+	if (loggerClass::isHeadless()) {
+		return;
+	}
+	traceSpan span("logEvent");
+	eventCount.fetch_add(1, std::memory_order_relaxed);
+	if (logSink* sinkPtr = loggerClass::getSink()) {
+		sinkPtr->writeClientEvent(nameTable::getName(bankIdArg), clientNumber, input);
+	}
 }
 
 void loggerClass::logTest() {
-	BOOST_LOG_TRIVIAL(info) << "This is test logging function";
+	loggerClass::logEvent("This is test logging function");
 }
 
 loggerClass::~loggerClass() {}
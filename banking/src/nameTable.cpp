@@ -0,0 +1,37 @@
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include "banking/nameTable.h"
+
+namespace {
+std::shared_mutex tableMTX; ///< Protects both containers below
+std::deque<std::string> names; ///< Names indexed by id, deque keeps references stable
+std::unordered_map<std::string, nameTable::entityId> ids; ///< Ids indexed by name
+}
+
+nameTable::entityId nameTable::intern(const std::string& nameArg) {
+	{
+		std::shared_lock<std::shared_mutex> sharedLock(tableMTX);
+		auto found = ids.find(nameArg);
+		if (found != ids.end()) {
+			return found->second;
+		}
+	}
+	std::unique_lock<std::shared_mutex> uniqueLock(tableMTX);
+	auto inserted = ids.emplace(nameArg, static_cast<entityId>(names.size()));
+	if (inserted.second) {
+		names.push_back(nameArg);
+	}
+	return inserted.first->second;
+}
+
+const std::string& nameTable::getName(entityId id) {
+	std::shared_lock<std::shared_mutex> sharedLock(tableMTX);
+	return names.at(id);
+}
+
+std::size_t nameTable::size() {
+	std::shared_lock<std::shared_mutex> sharedLock(tableMTX);
+	return names.size();
+}
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#ifdef ECONOMY2_NUMA
+#include <numa.h>
+#endif
+#include "banking/numaTopology.h"
+#include "../../constants.h"
+
+namespace {
+thread_local int pinnedNode {-1}; ///< Node the thread is pinned to, -1 if it is not pinned
+
+/*!
+ * @brief Parsing sysfs cpulist (for example **0-3,8,10-11**), returns false on malformed list
+ */
+bool parseCpuList(const std::string& cpuList, std::vector<int>& cpusOut) {
+	std::istringstream listStream(cpuList);
+	std::string range;
+	while (std::getline(listStream, range, ',')) {
+		if (range.empty() || range == "\n") {
+			continue;
+		}
+		int first {0};
+		int last {0};
+		char dash {0};
+		std::istringstream rangeStream(range);
+		if (!(rangeStream >> first)) {
+			return false;
+		}
+		last = first;
+		if (rangeStream >> dash && (dash != '-' || !(rangeStream >> last))) {
+			return false;
+		}
+		for (int cpu = first; cpu <= last; cpu++) {
+			cpusOut.push_back(cpu);
+		}
+	}
+	return true;
+}
+
+#ifdef ECONOMY2_NUMA
+bool libnumaUsed() {
+	return numaTopology::getSource() == "libnuma";
+}
+#endif
+}
+
+numaTopology::numaTopology() {
+#ifdef ECONOMY2_NUMA
+	if (numa_available() >= 0) {
+		struct bitmask* cpuMask = numa_allocate_cpumask();
+		for (int node = 0; node <= numa_max_node(); node++) {
+			std::vector<int> cpus;
+			if (numa_node_to_cpus(node, cpuMask) == 0) {
+				for (int cpu = 0; cpu < numa_num_possible_cpus(); cpu++) {
+					if (numa_bitmask_isbitset(cpuMask, cpu)) {
+						cpus.push_back(cpu);
+					}
+				}
+			}
+			if (!cpus.empty()) {
+				this->nodeCpus.push_back(std::move(cpus));
+				this->systemNodes.push_back(node);
+			}
+		}
+		numa_free_cpumask(cpuMask);
+		if (!this->nodeCpus.empty()) {
+			this->source = "libnuma";
+			return;
+		}
+	}
+#endif
+	// node directories are numbered from 0 without gaps on machines this simulation runs on
+	for (int node = 0; ; node++) {
+		std::ifstream cpuListFile(NUMA::SYSFS_NODES + std::to_string(node) + "/cpulist");
+		std::string cpuList;
+		if (!cpuListFile || !std::getline(cpuListFile, cpuList)) {
+			break;
+		}
+		std::vector<int> cpus;
+		if (parseCpuList(cpuList, cpus) && !cpus.empty()) {
+			this->nodeCpus.push_back(std::move(cpus));
+			this->systemNodes.push_back(node);
+		}
+	}
+	if (!this->nodeCpus.empty()) {
+		this->source = "sysfs";
+		return;
+	}
+	std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+	for (std::size_t cpu = 0; cpu < cpus.size(); cpu++) {
+		cpus[cpu] = static_cast<int>(cpu);
+	}
+	this->nodeCpus.push_back(std::move(cpus));
+	this->systemNodes.push_back(0);
+	this->source = "single";
+}
+
+const numaTopology& numaTopology::instance() {
+	static const numaTopology topology;
+	return topology;
+}
+
+int numaTopology::getNodesAmount() {
+	return static_cast<int>(instance().nodeCpus.size());
+}
+
+const std::vector<int>& numaTopology::getNodeCpus(int node) {
+	return instance().nodeCpus[node];
+}
+
+const std::string& numaTopology::getSource() {
+	return instance().source;
+}
+
+int numaTopology::nodeOfLocalBank(std::size_t localBankIndex, std::size_t localBanksAmount) {
+	if (localBanksAmount == 0) {
+		return 0;
+	}
+	return static_cast<int>(std::min(localBankIndex, localBanksAmount - 1) * getNodesAmount() / localBanksAmount);
+}
+
+bool numaTopology::pinCurrentThread(int node) {
+	node = std::min(node, getNodesAmount() - 1);
+	if (node == pinnedNode) {
+		return true;
+	}
+#ifdef __linux__
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	for (int pinnedCpusNode = 0; pinnedCpusNode < getNodesAmount(); pinnedCpusNode++) {
+		if (node >= 0 && pinnedCpusNode != node) {
+			continue;
+		}
+		for (int cpu: getNodeCpus(pinnedCpusNode)) {
+			if (cpu < CPU_SETSIZE) {
+				CPU_SET(cpu, &cpuSet);
+			}
+		}
+	}
+	if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+		return false;
+	}
+	pinnedNode = node < 0 ? -1 : node;
+	return true;
+#else
+	return false;
+#endif
+}
+
+int numaTopology::getPinnedNode() {
+	return pinnedNode;
+}
+
+void* numaTopology::allocateOnNode(std::size_t size, int node) {
+#ifdef ECONOMY2_NUMA
+	if (libnumaUsed()) {
+		return numa_alloc_onnode(size, instance().systemNodes[std::min(std::max(node, 0), getNodesAmount() - 1)]);
+	}
+#endif
+	return ::operator new(size, std::align_val_t {NUMA::ARENA_BLOCK_ALIGNMENT}, std::nothrow);
+}
+
+void numaTopology::freeOnNode(void* memory, std::size_t size) {
+	if (memory == nullptr) {
+		return;
+	}
+#ifdef ECONOMY2_NUMA
+	if (libnumaUsed()) {
+		numa_free(memory, size);
+		return;
+	}
+#endif
+	::operator delete(memory, std::align_val_t {NUMA::ARENA_BLOCK_ALIGNMENT});
+}
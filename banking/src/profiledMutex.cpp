@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
+#include "banking/profiledMutex.h"
+#include "banking/loggerClass.h"
+
+std::atomic<bool> profiledMutex::enabled {false};
+
+namespace {
+/*!
+ * @brief Registry of all profiled mutexes
+ * 
+ * Function local static, so global profiled mutexes from other translation units can use it during static initialization.
+ */
+struct mutexRegistry {
+	std::mutex registryMTX; ///< Protects both containers below
+	std::set<profiledMutex*> aliveMutexes; ///< All existing profiled mutexes
+	std::map<std::string, lockStats> retiredStats; ///< Statistics of destroyed mutexes grouped by name
+};
+
+mutexRegistry& registry() {
+	static mutexRegistry* registryPtr = new mutexRegistry(); // never destroyed, global mutexes may outlive static destruction
+	return *registryPtr;
+}
+
+int bucketIndex(std::uint64_t ns) {
+	int index {0};
+	while (ns > 1 && index < PROFILING::HISTOGRAM_BUCKETS - 1) {
+		ns = ns >> 1;
+		index++;
+	}
+	return index;
+}
+
+std::uint64_t nanoseconds(std::chrono::steady_clock::duration duration) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+std::string histogramToString(const std::array<std::uint64_t, PROFILING::HISTOGRAM_BUCKETS>& histogram) {
+	std::string result;
+	for (int i = 0; i < PROFILING::HISTOGRAM_BUCKETS; i++) {
+		if (histogram[i] > 0) {
+			result += " [2^" + std::to_string(i) + " ns: " + std::to_string(histogram[i]) + "]";
+		}
+	}
+	return result;
+}
+}
+
+void lockStats::recordAcquisition(const char* site, std::uint64_t waitNs, bool contended) {
+	this->acquisitions++;
+	this->contendedAcquisitions += contended;
+	this->totalWaitNs += waitNs;
+	this->waitHistogram[bucketIndex(waitNs)]++;
+	for (auto& currentSite: this->callSites) {
+		if (currentSite.site == nullptr || &currentSite == &this->callSites.back()
+				|| currentSite.site == site || std::strcmp(currentSite.site, site) == 0) {
+			if (currentSite.site == nullptr) {
+				currentSite.site = &currentSite == &this->callSites.back() ? "other" : site;
+			}
+			currentSite.acquisitions++;
+			currentSite.totalWaitNs += waitNs;
+			return;
+		}
+	}
+}
+
+void lockStats::recordHold(std::uint64_t holdNs) {
+	this->totalHoldNs += holdNs;
+	this->holdHistogram[bucketIndex(holdNs)]++;
+}
+
+void lockStats::merge(const lockStats& other) {
+	this->acquisitions += other.acquisitions;
+	this->contendedAcquisitions += other.contendedAcquisitions;
+	this->totalWaitNs += other.totalWaitNs;
+	this->totalHoldNs += other.totalHoldNs;
+	for (int i = 0; i < PROFILING::HISTOGRAM_BUCKETS; i++) {
+		this->waitHistogram[i] += other.waitHistogram[i];
+		this->holdHistogram[i] += other.holdHistogram[i];
+	}
+	for (auto& otherSite: other.callSites) {
+		if (otherSite.site == nullptr) {
+			continue;
+		}
+		for (auto& currentSite: this->callSites) {
+			bool isLast = &currentSite == &this->callSites.back();
+			if (currentSite.site == nullptr || isLast || std::strcmp(currentSite.site, otherSite.site) == 0) {
+				if (currentSite.site == nullptr) {
+					currentSite.site = isLast ? "other" : otherSite.site;
+				}
+				currentSite.acquisitions += otherSite.acquisitions;
+				currentSite.totalWaitNs += otherSite.totalWaitNs;
+				break;
+			}
+		}
+	}
+}
+
+profiledMutex::profiledMutex(const std::string& nameArg) :
+	name(nameArg)
+{}
+
+profiledMutex::~profiledMutex() {
+	if (!this->registered.load(std::memory_order_relaxed)) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock_guard1(registry().registryMTX);
+	registry().aliveMutexes.erase(this);
+	if (this->stats.acquisitions > 0) {
+		registry().retiredStats[this->name].merge(this->stats);
+	}
+}
+
+void profiledMutex::registerMutex() {
+	std::lock_guard<std::mutex> lock_guard1(registry().registryMTX);
+	registry().aliveMutexes.insert(this);
+	this->registered.store(true, std::memory_order_relaxed);
+}
+
+void profiledMutex::lock(const char* site) {
+	if (!profiledMutex::isEnabled()) {
+		this->mtx.lock();
+		this->profiledAcquisition = false;
+		return;
+	}
+	if (!this->registered.load(std::memory_order_relaxed)) {
+		this->registerMutex();
+	}
+	auto start = std::chrono::steady_clock::now();
+	bool contended = !this->mtx.try_lock();
+	if (contended) {
+		this->mtx.lock();
+	}
+	this->lockedAt = std::chrono::steady_clock::now();
+	this->profiledAcquisition = true;
+	this->stats.recordAcquisition(site, nanoseconds(this->lockedAt - start), contended);
+}
+
+void profiledMutex::unlock() {
+	if (this->profiledAcquisition) {
+		this->stats.recordHold(nanoseconds(std::chrono::steady_clock::now() - this->lockedAt));
+	}
+	this->mtx.unlock();
+}
+
+bool profiledMutex::try_lock() {
+	bool profiled = profiledMutex::isEnabled();
+	if (profiled && !this->registered.load(std::memory_order_relaxed)) {
+		this->registerMutex();
+	}
+	if (!this->mtx.try_lock()) {
+		return false;
+	}
+	this->profiledAcquisition = profiled;
+	if (this->profiledAcquisition) {
+		this->lockedAt = std::chrono::steady_clock::now();
+		this->stats.recordAcquisition("try_lock", 0, false);
+	}
+	return true;
+}
+
+lockStats profiledMutex::getStats() {
+	std::lock_guard<std::mutex> lock_guard1(this->mtx);
+	return this->stats;
+}
+
+std::vector<std::string> profiledMutex::getReport() {
+	std::vector<std::string> lines;
+	std::map<std::string, lockStats> report;
+	{
+		std::lock_guard<std::mutex> lock_guard1(registry().registryMTX);
+		report = registry().retiredStats;
+		for (auto mutexPtr: registry().aliveMutexes) {
+			report[mutexPtr->name].merge(mutexPtr->getStats());
+		}
+	}
+	for (auto& entry: report) {
+		const lockStats& stats = entry.second;
+		if (stats.acquisitions == 0) {
+			continue;
+		}
+		lines.push_back("Lock profile " + entry.first
+				+ ": acquisitions " + std::to_string(stats.acquisitions)
+				+ ", contended " + std::to_string(stats.contendedAcquisitions)
+				+ ", total wait " + std::to_string(stats.totalWaitNs / 1e6) + " ms"
+				+ ", total hold " + std::to_string(stats.totalHoldNs / 1e6) + " ms");
+		lines.push_back("Lock profile " + entry.first + " wait histogram:" + histogramToString(stats.waitHistogram));
+		lines.push_back("Lock profile " + entry.first + " hold histogram:" + histogramToString(stats.holdHistogram));
+		std::vector<lockStats::callSite> sites;
+		for (auto& site: stats.callSites) {
+			if (site.site != nullptr) {
+				sites.push_back(site);
+			}
+		}
+		std::sort(sites.begin(), sites.end(), [](const lockStats::callSite& a, const lockStats::callSite& b) {
+			return a.totalWaitNs > b.totalWaitNs;
+		});
+		for (auto& site: sites) {
+			lines.push_back("Lock profile " + entry.first + " call site " + site.site
+					+ ": acquisitions " + std::to_string(site.acquisitions)
+					+ ", total wait " + std::to_string(site.totalWaitNs / 1e6) + " ms");
+		}
+	}
+	return lines;
+}
+
+void profiledMutex::logReport() {
+	if (loggerClass::isHeadless()) {
+		return;
+	}
+	for (auto& line: profiledMutex::getReport()) {
+		loggerClass::logEvent(line);
+	}
+}
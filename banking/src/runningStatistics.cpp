@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <utility>
+#include "banking/runningStatistics.h"
+
+void runningStatistics::add(double value) {
+	this->count++;
+	if (this->count == 1) {
+		this->min = value;
+		this->max = value;
+	} else {
+		this->min = std::min(this->min, value);
+		this->max = std::max(this->max, value);
+	}
+	double delta = value - this->mean;
+	this->mean = this->mean + delta / this->count;
+	this->squaredDeviations = this->squaredDeviations + delta * (value - this->mean);
+}
+
+void runningStatistics::merge(const runningStatistics& other) {
+	if (other.count == 0) {
+		return;
+	}
+	if (this->count == 0) {
+		*this = other;
+		return;
+	}
+	std::uint64_t mergedCount = this->count + other.count;
+	double delta = other.mean - this->mean;
+	this->mean = this->mean + delta * other.count / mergedCount;
+	this->squaredDeviations = this->squaredDeviations + other.squaredDeviations
+			+ delta * delta * this->count * other.count / mergedCount;
+	this->count = mergedCount;
+	this->min = std::min(this->min, other.min);
+	this->max = std::max(this->max, other.max);
+}
+
+double runningStatistics::getStandardDeviation() const {
+	return std::sqrt(this->getVariance());
+}
+
+double runningStatistics::getConfidenceHalfWidth() const {
+	if (this->count < 2) {
+		return 0;
+	}
+	return ENSEMBLE::CONFIDENCE_Z * this->getStandardDeviation() / std::sqrt(static_cast<double>(this->count));
+}
+
+quantileSketch::quantileSketch(std::size_t capacityArg) :
+	capacity(std::max<std::size_t>(2, capacityArg)),
+	levels(1)
+{}
+
+void quantileSketch::add(double value) {
+	this->levels[0].push_back(value);
+	this->count++;
+	if (this->levels[0].size() >= this->capacity) {
+		this->compress();
+	}
+}
+
+void quantileSketch::merge(const quantileSketch& other) {
+	if (this->levels.size() < other.levels.size()) {
+		this->levels.resize(other.levels.size());
+	}
+	for (std::size_t i = 0; i < other.levels.size(); i++) {
+		this->levels[i].insert(this->levels[i].end(), other.levels[i].begin(), other.levels[i].end());
+	}
+	this->count = this->count + other.count;
+	this->compress();
+}
+
+void quantileSketch::compress() {
+	for (std::size_t i = 0; i < this->levels.size(); i++) {
+		if (this->levels[i].size() < this->capacity) {
+			continue;
+		}
+		if (i + 1 == this->levels.size()) {
+			this->levels.emplace_back();
+		}
+		std::vector<double>& level = this->levels[i];
+		std::vector<double>& upperLevel = this->levels[i + 1];
+		std::sort(level.begin(), level.end());
+		// odd sample stays on its level, so weights of all levels always sum up to count
+		double leftover {0};
+		bool hasLeftover = level.size() % 2 == 1;
+		if (hasLeftover) {
+			leftover = level.back();
+			level.pop_back();
+		}
+		for (std::size_t j = this->oddCompaction ? 1 : 0; j < level.size(); j += 2) {
+			upperLevel.push_back(level[j]);
+		}
+		this->oddCompaction = !this->oddCompaction;
+		level.clear();
+		if (hasLeftover) {
+			level.push_back(leftover);
+		}
+	}
+}
+
+double quantileSketch::getQuantile(double fraction) const {
+	std::vector<std::pair<double, std::uint64_t>> weighted;
+	for (std::size_t i = 0; i < this->levels.size(); i++) {
+		for (double value: this->levels[i]) {
+			weighted.emplace_back(value, std::uint64_t {1} << i);
+		}
+	}
+	if (weighted.empty()) {
+		return 0;
+	}
+	std::sort(weighted.begin(), weighted.end());
+	double rank = std::min(1.0, std::max(0.0, fraction)) * (this->count - 1);
+	std::uint64_t cumulative {0};
+	for (auto& sample: weighted) {
+		cumulative = cumulative + sample.second;
+		if (cumulative > rank) {
+			return sample.first;
+		}
+	}
+	return weighted.back().first;
+}
+
+std::size_t quantileSketch::getRetained() const {
+	std::size_t retained {0};
+	for (auto& level: this->levels) {
+		retained = retained + level.size();
+	}
+	return retained;
+}
+
+std::string metricStatistics::toString() const {
+	std::ostringstream output;
+	output << "mean " << this->moments.getMean() << " +/- " << this->moments.getConfidenceHalfWidth()
+			<< ", sd " << this->moments.getStandardDeviation()
+			<< ", min " << this->moments.getMin()
+			<< ", p5 " << this->quantiles.getQuantile(0.05)
+			<< ", median " << this->quantiles.getQuantile(0.5)
+			<< ", p95 " << this->quantiles.getQuantile(0.95)
+			<< ", max " << this->moments.getMax();
+	return output.str();
+}
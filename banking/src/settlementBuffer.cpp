@@ -0,0 +1,28 @@
+#include <atomic>
+#include "banking/settlementBuffer.h"
+
+settlementBuffer::shard& settlementBuffer::localShard() {
+	static std::atomic<unsigned> nextShard {0};
+	thread_local unsigned shardIndex {nextShard.fetch_add(1, std::memory_order_relaxed) % BANK::SETTLEMENT_SHARDS};
+	return this->shards[shardIndex];
+}
+
+void settlementBuffer::deposit(double amount) {
+	shard& currentShard = this->localShard();
+	std::lock_guard<std::mutex> lock_guard1(currentShard.shardMTX);
+	currentShard.pendingAmount = currentShard.pendingAmount + amount;
+	currentShard.pendingInstallments++;
+}
+
+double settlementBuffer::drain(int& installmentsArg) {
+	double amount {0};
+	installmentsArg = 0;
+	for (auto& currentShard: this->shards) {
+		std::lock_guard<std::mutex> lock_guard1(currentShard.shardMTX);
+		amount = amount + currentShard.pendingAmount;
+		installmentsArg = installmentsArg + currentShard.pendingInstallments;
+		currentShard.pendingAmount = 0;
+		currentShard.pendingInstallments = 0;
+	}
+	return amount;
+}
@@ -0,0 +1,270 @@
+#include <algorithm>
+#include "banking/simulationEngine.h"
+#include "banking/loanPolicyRegistry.h"
+#include "banking/dice.h"
+
+simulationEngine::simulationEngine(const simulationConfig& configArg, std::unique_ptr<centralBank> centralBankArg) :
+	config(configArg),
+	centralBankInstance(std::move(centralBankArg))
+{
+	this->centralBankInstance->setEpochSettlement(this->config.epochSettlement);
+}
+
+std::unique_ptr<simulationEngine> simulationEngine::create(const simulationConfig& configArg) {
+	std::unique_ptr<applicationTrace> replayedTrace;
+	simulationConfig config {configArg};
+	if (!config.replayFileName.empty()) {
+		replayedTrace.reset(new applicationTrace());
+		if (!replayedTrace->read(config.replayFileName)) {
+			loggerClass::logEvent("Trace not loaded: " + config.replayFileName);
+			return nullptr;
+		}
+		config.clientsAmount = static_cast<std::uint32_t>(replayedTrace->getRecords().size());
+		config.localBanksAmount = std::max(config.localBanksAmount, replayedTrace->getLocalBanksAmount());
+	}
+	std::unique_ptr<centralBank> centralBankInstance = loanPolicyRegistry::createCentralBank(config.centralBankPolicy);
+	if (!centralBankInstance) {
+		return nullptr;
+	}
+	amortization loanSchedule {amortization::EQUAL};
+	if (!loan::parseSchedule(config.loanSchedule, loanSchedule)) {
+		loggerClass::logEvent("Unknown loan schedule: " + config.loanSchedule);
+		return nullptr;
+	}
+	std::unique_ptr<simulationEngine> engine(new simulationEngine(config, std::move(centralBankInstance)));
+	engine->replayedTrace = std::move(replayedTrace);
+	for (int i = 1; i <= config.localBanksAmount; i++) {
+		std::unique_ptr<localBank> localBankInstance = loanPolicyRegistry::createLocalBank(
+				config.localBankPolicy, "Local Bank " + std::to_string(i), engine->centralBankInstance.get());
+		if (!localBankInstance) {
+			return nullptr;
+		}
+		localBankInstance->setEpochSettlement(config.epochSettlement);
+		localBankInstance->setLoanTerms(loanSchedule, config.variableRate);
+		engine->localBanks.push_back(std::move(localBankInstance));
+	}
+	if (!config.routingPolicy.empty() && !engine->replayedTrace) {
+		std::vector<localBank*> routedBanks;
+		for (auto& localBankInstance: engine->localBanks) {
+			routedBanks.push_back(localBankInstance.get());
+		}
+		engine->router = clientRouter::create(config.routingPolicy, std::move(routedBanks));
+		if (!engine->router) {
+			loggerClass::logEvent("Unknown routing policy: " + config.routingPolicy);
+			return nullptr;
+		}
+	}
+	if (!config.scenarioFileName.empty()) {
+		std::string error;
+		engine->scenario = economicScenario::load(config.scenarioFileName, error);
+		if (!engine->scenario) {
+			loggerClass::logEvent("Scenario not loaded: " + error);
+			return nullptr;
+		}
+		for (const scenarioShock& shock: engine->scenario->getShocks()) {
+			if (shock.target >= config.localBanksAmount) {
+				loggerClass::logEvent("Scenario not loaded: shock targets Local Bank " + std::to_string(shock.target + 1));
+				return nullptr;
+			}
+		}
+	}
+	return engine;
+}
+
+simulationEngine::~simulationEngine() {
+	// clients go first, Local Banks still hold pointers to loans of waiting clients but never touch them again
+	this->dueClients.clear();
+	this->payingClients.clear();
+	this->waitingClients.clear();
+}
+
+template<class Bank>
+void simulationEngine::createClient(std::size_t localBankIndex) {
+	Bank* localBankPtr = static_cast<Bank*>(this->localBanks[localBankIndex].get());
+	if (this->replayedTrace) {
+		const applicationRecord& record = this->replayedTrace->getRecords()[this->nextRecord];
+		if (record.localBankIndex != localBankIndex) {
+			return;
+		}
+		this->nextRecord++;
+		dice::tape replayTape(record.rolls.data(), record.rolls.size());
+		this->createClient(localBankPtr, record.clientNumber);
+		this->result.replayMisses = this->result.replayMisses + replayTape.getMisses();
+	} else if (this->recordingTrace != nullptr) {
+		std::uint32_t clientNumber = static_cast<std::uint32_t>(this->result.clients);
+		dice::tape recordTape;
+		this->createClient(localBankPtr, clientNumber);
+		this->recordingTrace->append({static_cast<std::uint16_t>(localBankIndex), clientNumber, recordTape.getRecorded()});
+	} else {
+		this->createClient(localBankPtr, static_cast<std::uint32_t>(this->result.clients));
+	}
+}
+
+bool simulationEngine::moreClientsExpected() const {
+	if (this->replayedTrace) {
+		return this->nextRecord < this->replayedTrace->getRecords().size();
+	}
+	return this->result.clients < this->config.clientsAmount;
+}
+
+template<class Bank>
+void simulationEngine::createClient(Bank* localBankPtr, std::uint32_t clientNumber) {
+	std::unique_ptr<localClient> localClientPtr(new localClient(clientNumber, localBankPtr));
+	this->result.clients++;
+	localBankPtr->loanProcessingMethod(localClientPtr->getLoanPtr());
+	this->result.loanApplications++;
+	if (localClientPtr->getLoanPtr()->isReadyToBePayed()) {
+		this->dueClients.schedule(std::move(localClientPtr), this->result.ticks);
+	} else if (localBankPtr->isLoanWaiting(localClientPtr->getLoanPtr())) {
+		this->waitingClients.push_back(std::move(localClientPtr));
+	}
+}
+
+void simulationEngine::payClientInstallments() {
+	this->dueClients.advance(this->payingClients);
+	std::uint64_t nextDue = this->result.ticks + std::max<std::uint64_t>(1, this->config.installmentPeriod);
+	for (auto& localClientPtr: this->payingClients) {
+		localClientPtr->paymentMethod();
+		this->result.clientInstallments++;
+		if (localClientPtr->getLoanPtr()->isReadyToBePayed()) {
+			this->dueClients.schedule(std::move(localClientPtr), nextDue);
+		} else {
+			this->result.loanRepricings = this->result.loanRepricings + localClientPtr->getLoanPtr()->getRepricingsAmount();
+		}
+	}
+	this->payingClients.clear();
+}
+
+void simulationEngine::activateWaitingClients() {
+	std::size_t kept {0};
+	for (std::size_t i = 0; i < this->waitingClients.size(); i++) {
+		if (this->waitingClients[i]->getLoanPtr()->isReadyToBePayed()) {
+			this->dueClients.schedule(std::move(this->waitingClients[i]), this->result.ticks + 1);
+		} else {
+			this->waitingClients[kept++] = std::move(this->waitingClients[i]);
+		}
+	}
+	this->waitingClients.resize(kept);
+}
+
+bool simulationEngine::isAnyBankPaying() {
+	for (auto& localBankInstance: this->localBanks) {
+		if (localBankInstance->isPayingLoan()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool simulationEngine::isAnyBankOpen() {
+	const economicParameters& currentParameters = this->centralBankInstance->getParameters();
+	for (std::size_t i = 0; i < this->localBanks.size(); i++) {
+		if (!currentParameters.isLocalBankFailed(i)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void simulationEngine::injectTreasury(const scenarioShock& shock) {
+	std::vector<bank*> targets;
+	if (shock.target == scenarioShock::CENTRAL_BANK_TARGET) {
+		targets.push_back(this->centralBankInstance.get());
+	} else if (shock.target == scenarioShock::ALL_LOCAL_BANKS_TARGET) {
+		for (auto& localBankInstance: this->localBanks) {
+			targets.push_back(localBankInstance.get());
+		}
+	} else {
+		targets.push_back(this->localBanks[shock.target].get());
+	}
+	for (auto bankPtr: targets) {
+		if (shock.value >= 0) {
+			bankPtr->deposit(shock.value);
+		} else {
+			bankPtr->withdraw(-shock.value);
+		}
+	}
+}
+
+void simulationEngine::applyShocks() {
+	if (!this->scenario || this->scenario->isFinished()) {
+		return;
+	}
+	const economicParameters* previousParameters = this->scenario->getParameters();
+	for (const scenarioShock& shock: this->scenario->advance(this->result.ticks)) {
+		if (shock.shockType == scenarioShock::type::TREASURY_INJECTION) {
+			this->injectTreasury(shock);
+		}
+		this->result.shocks++;
+	}
+	const economicParameters* currentParameters = this->scenario->getParameters();
+	if (currentParameters != previousParameters) {
+		this->centralBankInstance->publishParameters(currentParameters);
+		for (auto& localBankInstance: this->localBanks) {
+			localBankInstance->publishParameters(currentParameters);
+		}
+	}
+}
+
+template<class Bank>
+void simulationEngine::runTicks() {
+	while ((this->moreClientsExpected() && this->isAnyBankOpen())
+			|| !this->dueClients.empty()
+			|| this->isAnyBankPaying()) {
+		this->applyShocks();
+		const economicParameters& currentParameters = this->centralBankInstance->getParameters();
+		// applications of failed Local Banks are dropped, otherwise they would block the rest of the trace
+		while (this->replayedTrace && this->moreClientsExpected()
+				&& currentParameters.isLocalBankFailed(this->replayedTrace->getRecords()[this->nextRecord].localBankIndex)) {
+			this->nextRecord++;
+		}
+		if (this->router) {
+			this->router->refresh(currentParameters);
+		}
+		for (std::size_t i = 0; i < this->localBanks.size(); i++) {
+			localBank* localBankPtr = this->localBanks[i].get();
+			if (!localBankPtr->isPayingLoan() && this->moreClientsExpected() && !currentParameters.isLocalBankFailed(i)) {
+				this->createClient<Bank>(this->router ? this->router->route(static_cast<std::uint32_t>(this->result.clients)) : i);
+			}
+			if (localBankPtr->isPayingLoan()) {
+				localBankPtr->paymentMethod();
+				this->result.bankInstallments++;
+			}
+			localBankPtr->settleEpoch();
+		}
+		this->payClientInstallments();
+		this->activateWaitingClients();
+		this->centralBankInstance->settleEpoch();
+		this->result.ticks++;
+	}
+}
+
+simulationResult simulationEngine::run() {
+	dice::threadSeed seedGuard(this->config.seed);
+	// all Local Banks are created by the same policy, loans are processed without virtual calls
+	loanPolicyRegistry::visitLocalBankType(this->localBanks.empty() ? nullptr : this->localBanks.front().get(), [this](auto bankType) {
+		this->runTicks<typename decltype(bankType)::type>();
+	});
+	this->result.waitingClients = this->waitingClients.size();
+	this->result.centralBankTreasury = this->centralBankInstance->getCurrentTreasury();
+	this->result.centralBankTreasuryRate = this->result.centralBankTreasury / this->centralBankInstance->getTotalTreasury();
+	this->result.centralBankLoans = static_cast<std::uint64_t>(this->centralBankInstance->getTotalValidLoans());
+	this->result.localBanksTreasury = 0;
+	this->result.missedInstallments = 0;
+	this->result.writtenOffLoans = 0;
+	double localBanksTotalTreasury {0};
+	double localBanksLoans {0};
+	double localBanksValidLoans {0};
+	for (auto& localBankInstance: this->localBanks) {
+		this->result.localBanksTreasury = this->result.localBanksTreasury + localBankInstance->getCurrentTreasury();
+		localBanksTotalTreasury = localBanksTotalTreasury + localBankInstance->getTotalTreasury();
+		localBanksLoans = localBanksLoans + localBankInstance->getTotalLoans();
+		localBanksValidLoans = localBanksValidLoans + localBankInstance->getTotalValidLoans();
+		delinquencyBook delinquentLoans = localBankInstance->getDelinquencyBook();
+		this->result.missedInstallments = this->result.missedInstallments + delinquentLoans.getMissedInstalments();
+		this->result.writtenOffLoans = this->result.writtenOffLoans + delinquentLoans.getWrittenOffLoans();
+	}
+	this->result.localBanksTreasuryRate = localBanksTotalTreasury > 0 ? this->result.localBanksTreasury / localBanksTotalTreasury : 0;
+	this->result.loanValidationRate = localBanksLoans > 0 ? localBanksValidLoans / localBanksLoans : 0;
+	return this->result;
+}
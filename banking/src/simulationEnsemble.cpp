@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "banking/simulationEnsemble.h"
+
+void ensembleResult::add(const simulationResult& result) {
+	this->runs++;
+	this->centralBankTreasuryRate.add(result.centralBankTreasuryRate);
+	this->localBanksTreasuryRate.add(result.localBanksTreasuryRate);
+	this->loanValidationRate.add(result.loanValidationRate);
+	this->centralBankLoans.add(static_cast<double>(result.centralBankLoans));
+	this->ticks.add(static_cast<double>(result.ticks));
+	this->events = this->events + result.events();
+}
+
+void ensembleResult::merge(const ensembleResult& other) {
+	this->runs = this->runs + other.runs;
+	this->centralBankTreasuryRate.merge(other.centralBankTreasuryRate);
+	this->localBanksTreasuryRate.merge(other.localBanksTreasuryRate);
+	this->loanValidationRate.merge(other.loanValidationRate);
+	this->centralBankLoans.merge(other.centralBankLoans);
+	this->ticks.merge(other.ticks);
+	this->events = this->events + other.events;
+}
+
+std::string ensembleResult::toString() const {
+	std::ostringstream output;
+	output << "Runs: " << this->runs << ", " << this->events << " events in " << this->seconds << " s ("
+			<< static_cast<long>(this->events / std::max(this->seconds, 1e-9)) << " events / s)\n"
+			<< "Central Bank treasury rate: " << this->centralBankTreasuryRate.toString() << "\n"
+			<< "Local Banks treasury rate: " << this->localBanksTreasuryRate.toString() << "\n"
+			<< "Loans validation rate: " << this->loanValidationRate.toString() << "\n"
+			<< "Central Bank loans: " << this->centralBankLoans.toString() << "\n"
+			<< "Ticks: " << this->ticks.toString();
+	return output.str();
+}
+
+std::unique_ptr<ensembleResult> simulationEnsemble::run(const ensembleConfig& config) {
+	if (!simulationEngine::create(config.simulation)) {
+		return nullptr;
+	}
+	int threadsAmount = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+	threadsAmount = std::max(1, std::min(threadsAmount, config.runs));
+	std::atomic<int> nextRun {0};
+	std::vector<ensembleResult> workerResults(threadsAmount);
+	auto worker = [&config, &nextRun](ensembleResult& workerResult) {
+		simulationConfig runConfig {config.simulation};
+		for (int run = nextRun++; run < config.runs; run = nextRun++) {
+			runConfig.seed = config.firstSeed + static_cast<unsigned>(run);
+			workerResult.add(simulationEngine::create(runConfig)->run());
+		}
+	};
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	for (int i = 1; i < threadsAmount; i++) {
+		threads.emplace_back(worker, std::ref(workerResults[i]));
+	}
+	worker(workerResults[0]);
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	std::unique_ptr<ensembleResult> result(new ensembleResult());
+	for (auto& workerResult: workerResults) {
+		result->merge(workerResult);
+	}
+	result->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
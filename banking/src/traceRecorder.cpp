@@ -0,0 +1,90 @@
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "banking/traceRecorder.h"
+
+std::atomic<bool> traceRecorder::enabled {false};
+
+namespace {
+/*!
+ * @brief Single finished span
+ */
+struct traceEvent {
+	const char* name; ///< Name of the span
+	std::uint64_t startNs; ///< Start of the span
+	std::uint64_t durationNs; ///< Duration of the span
+};
+
+/*!
+ * @brief Spans recorded by one thread, kept alive after the thread ends
+ */
+struct threadBuffer {
+	std::uint32_t threadNumber; ///< Number used as "tid" in the trace
+	std::vector<traceEvent> events; ///< Recorded spans
+};
+
+std::mutex buffersMTX; ///< Protects **buffers**
+std::vector<std::shared_ptr<threadBuffer>> buffers; ///< Buffers of all threads which recorded anything
+
+threadBuffer& localBuffer() {
+	thread_local std::shared_ptr<threadBuffer> buffer;
+	if (!buffer) {
+		std::lock_guard<std::mutex> lock_guard1(buffersMTX);
+		buffer = std::make_shared<threadBuffer>();
+		buffer->threadNumber = static_cast<std::uint32_t>(buffers.size());
+		buffers.push_back(buffer);
+	}
+	return *buffer;
+}
+}
+
+std::uint64_t traceRecorder::now() {
+	static const auto origin = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void traceRecorder::record(const char* name, std::uint64_t startNs, std::uint64_t durationNs) {
+	localBuffer().events.push_back(traceEvent {name, startNs, durationNs});
+}
+
+std::size_t traceRecorder::size() {
+	std::lock_guard<std::mutex> lock_guard1(buffersMTX);
+	std::size_t total {0};
+	for (auto& buffer: buffers) {
+		total += buffer->events.size();
+	}
+	return total;
+}
+
+void traceRecorder::clear() {
+	std::lock_guard<std::mutex> lock_guard1(buffersMTX);
+	for (auto& buffer: buffers) {
+		buffer->events.clear();
+	}
+}
+
+bool traceRecorder::writeChromeTrace(const std::string& fileName) {
+	std::ofstream file(fileName);
+	if (!file) {
+		return false;
+	}
+	std::lock_guard<std::mutex> lock_guard1(buffersMTX);
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first {true};
+	for (auto& buffer: buffers) {
+		for (auto& event: buffer->events) {
+			file << (first ? "\n" : ",\n")
+					<< "{\"name\":\"" << event.name
+					<< "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadNumber
+					<< ",\"ts\":" << event.startNs / 1000.0
+					<< ",\"dur\":" << event.durationNs / 1000.0 << "}";
+			first = false;
+		}
+	}
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+}
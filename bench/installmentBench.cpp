@@ -0,0 +1,83 @@
+/*
+ * @brief Per installment cost benchmark
+ * 
+ * Compares cost of a single installment payment in the classic hierarchy (bank.h, localBank.h,
+ * centralBank.h), in the classic hierarchy with epoch settlement and in the compact hierarchy (compactBank.h).
+ * All cases run without logging.
+ * Usage: economy2bench [installments amount]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "banking/loggerClass.h"
+#include "banking/centralBank.h"
+#include "banking/localBank.h"
+#include "banking/compactBank.h"
+#include "banking/loan.h"
+#include "../constants.h"
+
+const int DEFAULT_INSTALLMENTS_AMOUNT {100'000}; ///< Installments paid in every benchmark case
+const int EPOCH_LENGTH {1'000}; ///< Installments between two settlements in epoch settlement case
+
+/*!
+ * @brief Paying **installmentsAmount** installments of one loan with **payFunction** and returning ns per installment
+ */
+template<class Pay>
+double measure(int installmentsAmount, Pay payFunction) {
+	loan loanInstance(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER, installmentsAmount, LOCAL_BANK::INTEREST_RATE);
+	loanInstance.setAsReadyForPayment();
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < installmentsAmount; i++) {
+		payFunction(loanInstance, i);
+		loanInstance.payAndUpdate();
+	}
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / installmentsAmount;
+}
+
+void report(const std::string& caseName, double nsPerInstallment) {
+	std::cout << caseName << ": " << nsPerInstallment << " ns / installment" << std::endl;
+}
+
+int main(int argc, char **argv) {
+	int installmentsAmount = argc > 1 ? std::atoi(argv[1]) : DEFAULT_INSTALLMENTS_AMOUNT;
+	// compact hierarchy never logs, so the classic one runs headless to compare only dispatch and layout
+	loggerClass::setHeadless(true);
+
+	centralBank centralBankInstance;
+	localBank localBankInstance("Benchmark Local Bank", &centralBankInstance);
+	report("classic localClient -> localBank", measure(installmentsAmount, [&](loan& loanArg, int) {
+		localBankInstance.receivePayment(&loanArg);
+	}));
+	report("classic localBank -> centralBank", measure(installmentsAmount, [&](loan& loanArg, int) {
+		centralBankInstance.receivePayment(&loanArg);
+	}));
+
+	localBankInstance.setEpochSettlement(true);
+	centralBankInstance.setEpochSettlement(true);
+	report("epoch settlement localClient -> localBank", measure(installmentsAmount, [&](loan& loanArg, int i) {
+		localBankInstance.receivePayment(&loanArg);
+		if (i % EPOCH_LENGTH == 0) {
+			localBankInstance.settleEpoch();
+		}
+	}));
+	report("epoch settlement localBank -> centralBank", measure(installmentsAmount, [&](loan& loanArg, int i) {
+		centralBankInstance.receivePayment(&loanArg);
+		if (i % EPOCH_LENGTH == 0) {
+			centralBankInstance.settleEpoch();
+		}
+	}));
+
+	compactCentralBank compactCentralBankInstance;
+	compactLocalBank compactLocalBankInstance("Benchmark Compact Local Bank", &compactCentralBankInstance);
+	report("compact localClient -> localBank", measure(installmentsAmount, [&](loan& loanArg, int) {
+		compactLocalBankInstance.receivePayment(loanArg);
+	}));
+	report("compact localBank -> centralBank", measure(installmentsAmount, [&](loan& loanArg, int) {
+		compactCentralBankInstance.receivePayment(loanArg);
+	}));
+	return 0;
+}
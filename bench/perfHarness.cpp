@@ -0,0 +1,288 @@
+/*
+ * @brief Throughput regression harness
+ *
+ * Runs a fixed seed scenario through simulationEngine in headless mode, measures events / s and peak RSS growth
+ * and compares them with the stored baseline. Exits with non zero code when throughput dropped or memory
+ * grew by more than the tolerance, or when repeated runs of the same seed gave different results.
+ * Usage: economy2perf <scenario> [--baseline <file>] [--tolerance <fraction>] [--repeat <n>] [--update-baseline]
+ *        [--shocks <file>] [--banks <n>] [--route <policy>]
+ *
+ * Every sample runs the scenario again and again for at least MIN_SAMPLE_SECONDS, **--repeat** samples are
+ * taken and their median is used. Throughput is compared relative to a fixed reference workload which does
+ * not use banking code (see referenceOpsPerSecond()), measured just before and after every sample, so the baseline
+ * does not depend on how fast the machine is or how busy it currently is.
+ * With --shocks the scenario runs with economicScenario shocks from the file and is stored in the baseline
+ * as **<scenario>+shocks**. --banks changes the number of Local Banks (**<scenario>+banks<n>**), --route
+ * routes clients with clientRouter policy (**<scenario>+<policy>**).
+ *
+ * Baseline file has one line per scenario: **<scenario> <relative throughput> <RSS growth in kB> [<tolerance>]**,
+ * where relative throughput is scenario events / s divided by reference operations / s and RSS growth is how much
+ * peak RSS grew while the scenario ran (process startup is not counted). Tolerance is the allowed fraction of
+ * throughput drop and memory growth of the scenario (DEFAULT_TOLERANCE if missing, --tolerance overrides it).
+ * Lines starting with # are comments. Refresh numbers with --update-baseline, tolerances are kept.
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "banking/loggerClass.h"
+#include "banking/profiledMutex.h"
+#include "banking/simulationEngine.h"
+#include "../constants.h"
+
+const unsigned SCENARIO_SEED {2022}; ///< Seed of every scenario
+const int SCENARIO_LOCAL_BANKS {10}; ///< Local Banks in every scenario
+const double DEFAULT_TOLERANCE {0.15}; ///< Allowed relative throughput drop and memory growth of scenarios without own tolerance
+const long RSS_SLACK_KB {512}; ///< RSS growth always allowed on top of the baseline, allocator and page granularity noise
+const int DEFAULT_REPEAT {5}; ///< Samples per scenario, the median is compared
+const double MIN_SAMPLE_SECONDS {0.5}; ///< Minimal measured time of a single sample
+const double REFERENCE_SECONDS {0.2}; ///< Minimal measured time of the reference workload
+
+/*!
+ * @brief Scenario name -> number of generated clients
+ */
+const std::map<std::string, std::uint32_t> SCENARIOS {
+	{"10k", 10'000},
+	{"100k", 100'000},
+	{"1M", 1'000'000}
+};
+
+struct baselineEntry {
+	double relativeThroughput; ///< Scenario events / s divided by reference operations / s
+	long rssGrowthKb; ///< Peak RSS growth while the scenario ran
+	double tolerance; ///< Allowed relative throughput drop and memory growth
+};
+
+/*!
+ * @brief Throughput of a fixed reference workload in operations / s
+ *
+ * Dice rolls, floating point accumulation and a small ring of heap allocations, roughly the mix simulationEngine
+ * does per event, but without any banking code, so banking regressions do not move it.
+ */
+double referenceOpsPerSecond() {
+	std::mt19937 generator {SCENARIO_SEED};
+	std::uniform_int_distribution<int> roll(1, 20);
+	std::vector<std::unique_ptr<double>> ring;
+	for (int i = 0; i < 64; i++) {
+		ring.emplace_back(new double(i));
+	}
+	double sum {0};
+	std::uint64_t operations {0};
+	auto start = std::chrono::steady_clock::now();
+	double seconds {0};
+	while (seconds < REFERENCE_SECONDS) {
+		for (int i = 0; i < 100'000; i++) {
+			int value = roll(generator);
+			ring[operations % ring.size()].reset(new double(value * 1.05));
+			sum = sum + *ring[(operations * 7) % ring.size()] / (value + 1);
+			operations++;
+		}
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+	if (sum < 0) {
+		std::cout << sum << std::endl; // keeps the loop from being optimized away
+	}
+	return operations / seconds;
+}
+
+double median(std::vector<double> values) {
+	std::sort(values.begin(), values.end());
+	std::size_t middle = values.size() / 2;
+	return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+long peakRssKb() {
+	rusage usage {};
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+/*!
+ * @brief Reading baseline file, missing file gives empty map
+ */
+std::map<std::string, baselineEntry> readBaseline(const std::string& fileName, std::vector<std::string>& comments) {
+	std::map<std::string, baselineEntry> entries;
+	std::ifstream file(fileName);
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			comments.push_back(line);
+			continue;
+		}
+		std::istringstream lineStream(line);
+		std::string scenario;
+		baselineEntry entry {0, 0, DEFAULT_TOLERANCE};
+		if (lineStream >> scenario >> entry.relativeThroughput >> entry.rssGrowthKb) {
+			if (!(lineStream >> entry.tolerance)) {
+				entry.tolerance = DEFAULT_TOLERANCE;
+			}
+			entries[scenario] = entry;
+		}
+	}
+	return entries;
+}
+
+bool writeBaseline(const std::string& fileName, const std::vector<std::string>& comments,
+		const std::map<std::string, baselineEntry>& entries) {
+	std::ofstream file(fileName);
+	for (auto& comment: comments) {
+		file << comment << "\n";
+	}
+	for (auto& entry: entries) {
+		file << entry.first << " " << entry.second.relativeThroughput << " " << entry.second.rssGrowthKb
+				<< " " << entry.second.tolerance << "\n";
+	}
+	return static_cast<bool>(file);
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2 || SCENARIOS.count(argv[1]) == 0) {
+		std::cout << "Usage: economy2perf <10k|100k|1M> [--baseline <file>] [--tolerance <fraction>]"
+				<< " [--repeat <n>] [--update-baseline] [--shocks <file>] [--banks <n>] [--route <policy>]" << std::endl;
+		return 2;
+	}
+	std::string scenario {argv[1]};
+	std::string baselineFileName {};
+	double tolerance {DEFAULT_TOLERANCE};
+	bool toleranceGiven {false};
+	int repeat {DEFAULT_REPEAT};
+	bool updateBaseline {false};
+	std::string shocksFileName {};
+	int localBanksAmount {SCENARIO_LOCAL_BANKS};
+	std::string routingPolicy {};
+	for (int i = 2; i < argc; i++) {
+		std::string argument {argv[i]};
+		if (argument == "--baseline" && i + 1 < argc) {
+			baselineFileName = argv[++i];
+		} else if (argument == "--tolerance" && i + 1 < argc) {
+			tolerance = std::atof(argv[++i]);
+			toleranceGiven = true;
+		} else if (argument == "--repeat" && i + 1 < argc) {
+			repeat = std::max(1, std::atoi(argv[++i]));
+		} else if (argument == "--update-baseline") {
+			updateBaseline = true;
+		} else if (argument == "--shocks" && i + 1 < argc) {
+			shocksFileName = argv[++i];
+		} else if (argument == "--banks" && i + 1 < argc) {
+			localBanksAmount = std::max(1, std::atoi(argv[++i]));
+		} else if (argument == "--route" && i + 1 < argc) {
+			routingPolicy = argv[++i];
+		}
+	}
+	loggerClass::setHeadless(true);
+	profiledMutex::setEnabled(false);
+
+	simulationConfig config;
+	config.seed = SCENARIO_SEED;
+	config.localBanksAmount = localBanksAmount;
+	config.routingPolicy = routingPolicy;
+	config.clientsAmount = SCENARIOS.at(scenario);
+	config.scenarioFileName = shocksFileName;
+	if (!shocksFileName.empty()) {
+		scenario = scenario + "+shocks";
+	}
+	if (localBanksAmount != SCENARIO_LOCAL_BANKS) {
+		scenario = scenario + "+banks" + std::to_string(localBanksAmount);
+	}
+	if (!routingPolicy.empty()) {
+		scenario = scenario + "+" + routingPolicy;
+	}
+
+	std::vector<double> eventsPerSecondSamples;
+	std::vector<double> relativeSamples;
+	simulationResult firstResult;
+	const long startRssKb = peakRssKb();
+	int runs {0};
+	for (int sample = 0; sample < repeat; sample++) {
+		double referenceBefore = referenceOpsPerSecond();
+		std::uint64_t sampleEvents {0};
+		double sampleSeconds {0};
+		int sampleRuns {0};
+		while (sampleSeconds < MIN_SAMPLE_SECONDS) {
+			std::unique_ptr<simulationEngine> engine = simulationEngine::create(config);
+			if (!engine) {
+				std::cout << "Could not create simulation, check --shocks file " << shocksFileName
+						<< " and --route policy " << routingPolicy << std::endl;
+				return 2;
+			}
+			auto start = std::chrono::steady_clock::now();
+			simulationResult result = engine->run();
+			sampleSeconds = sampleSeconds + std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			sampleEvents = sampleEvents + result.events();
+			sampleRuns++;
+			if (runs++ == 0) {
+				firstResult = result;
+			} else if (result.events() != firstResult.events() || result.ticks != firstResult.ticks
+					|| result.centralBankTreasury != firstResult.centralBankTreasury) {
+				std::cout << "FAIL: run " << runs << " differs from run 1, scenario is not deterministic" << std::endl;
+				return 1;
+			}
+		}
+		// reference measured on both sides of the sample, so machine speed drifting during the sample cancels out
+		double referenceSpeed = (referenceBefore + referenceOpsPerSecond()) / 2;
+		double eventsPerSecond = sampleEvents / sampleSeconds;
+		eventsPerSecondSamples.push_back(eventsPerSecond);
+		relativeSamples.push_back(eventsPerSecond / referenceSpeed);
+		std::cout << scenario << " sample " << sample + 1 << ": " << sampleRuns << " runs, " << sampleEvents << " events in "
+				<< sampleSeconds << " s (" << static_cast<long>(eventsPerSecond) << " events / s, relative "
+				<< relativeSamples.back() << "), " << firstResult.ticks << " ticks, " << firstResult.waitingClients
+				<< " clients left waiting, " << firstResult.shocks << " shocks" << std::endl;
+	}
+	baselineEntry measured {median(relativeSamples), peakRssKb() - startRssKb, tolerance};
+	std::cout << scenario << ": " << static_cast<long>(median(eventsPerSecondSamples)) << " events / s, relative throughput "
+			<< measured.relativeThroughput << ", peak RSS growth " << measured.rssGrowthKb << " kB" << std::endl;
+
+	if (baselineFileName.empty()) {
+		return 0;
+	}
+	std::vector<std::string> comments;
+	std::map<std::string, baselineEntry> baseline = readBaseline(baselineFileName, comments);
+	if (updateBaseline) {
+		if (!toleranceGiven && baseline.count(scenario) > 0) {
+			measured.tolerance = baseline.at(scenario).tolerance;
+		}
+		baseline[scenario] = measured;
+		if (!writeBaseline(baselineFileName, comments, baseline)) {
+			std::cout << "Could not write baseline to " << baselineFileName << std::endl;
+			return 1;
+		}
+		std::cout << "Baseline of " << scenario << " updated" << std::endl;
+		return 0;
+	}
+	if (baseline.count(scenario) == 0) {
+		std::cout << "No baseline for " << scenario << " in " << baselineFileName << ", nothing to compare" << std::endl;
+		return 0;
+	}
+	const baselineEntry& expected = baseline.at(scenario);
+	if (!toleranceGiven) {
+		tolerance = expected.tolerance;
+	}
+	bool passed {true};
+	if (measured.relativeThroughput < expected.relativeThroughput * (1 - tolerance)) {
+		std::cout << "FAIL: relative throughput " << measured.relativeThroughput << " is below baseline "
+				<< expected.relativeThroughput << " minus " << tolerance * 100 << "%" << std::endl;
+		passed = false;
+	}
+	if (measured.rssGrowthKb > expected.rssGrowthKb * (1 + tolerance) + RSS_SLACK_KB) {
+		std::cout << "FAIL: peak RSS growth " << measured.rssGrowthKb << " kB is above baseline "
+				<< expected.rssGrowthKb << " kB plus " << tolerance * 100 << "% and " << RSS_SLACK_KB << " kB" << std::endl;
+		passed = false;
+	}
+	if (passed) {
+		std::cout << "PASS: within " << tolerance * 100 << "% of baseline (relative throughput " << expected.relativeThroughput
+				<< ", peak RSS growth " << expected.rssGrowthKb << " kB)" << std::endl;
+	}
+	return passed ? 0 : 1;
+}
@@ -7,11 +7,13 @@
 #ifndef CONSTANTS_H_
 #define CONSTANTS_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace BANK {
 const int DICE_SIZE {20}; ///< Size of Bank class dice
+const int SETTLEMENT_SHARDS {16}; ///< Number of shards used to accumulate installments in epoch settlement mode
 }
 
 namespace CLIENT {
@@ -44,12 +46,101 @@ const double THRESHOLD_FOR_LOAN {STARTING_TREASURY * 0.01}; ///< Threshold after
 namespace LOCAL_CLIENT {
 const double LOAN_VALUE_MULTIPLIER {200}; ///< Multiplier for CLIENT::DICE_SIZE
 const int MINIMAL_INSTALLMENT_AMOUNT {10}; ///< Minimal amount of installments for Local Client
+const std::string LOAN_SCHEDULE {"equal"}; ///< Default amortization of Local Client loans (equal, annuity or declining)
+const bool VARIABLE_RATE {false}; ///< If true Local Client loans follow Central Bank rate, see loan::setRateReference()
+const double MISSED_PAYMENT_RATE {0}; ///< Probability that Local Client misses a single installment
+const int MISSED_PAYMENT_DICE_SIZE {1000}; ///< Size of the dice deciding about missed installment
+}
+
+namespace LOAN {
+/*!
+ * @brief Width of interest rate bucket of variable-rate loans
+ *
+ * Variable-rate loan is repriced only when the reference rate moves to another bucket.
+ */
+const double RATE_BUCKET {0.0025};
+const int DAYS_PER_INSTALMENT {30}; ///< Days between two installments, unit of days past due
+const int DELINQUENCY_BUCKETS {3}; ///< Aging buckets of delinquent loans: 30, 60 and 90+ days past due
+const int WRITE_OFF_MISSED_INSTALMENTS {4}; ///< Consecutive missed installments after which loan is written off
+}
+
+namespace LOAN_POLICY {
+const int DICE_THRESHOLD {6}; ///< Minimal dice roll plus (loan value % 3) for diceThresholdPolicy
+const double CREDIT_BASE_SCORE {700}; ///< Starting credit score for creditScoringPolicy
+const double CREDIT_SCORE_PER_VALUE_STEP {10}; ///< Score lost per every LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER of loan value
+const double CREDIT_SCORE_PER_INSTALLMENT {2}; ///< Score gained per every installment
+const double CREDIT_MINIMAL_SCORE {550}; ///< Minimal credit score required by creditScoringPolicy
+const double MINIMAL_TREASURY_RATIO {0.2}; ///< Minimal (treasury after loan / total treasury) for treasuryRatioPolicy
+const double DEMAND_SENSITIVITY {5}; ///< How strongly interest rate discourages applicants in interestSensitiveDemandPolicy
+const int RISK_DAYS_PAST_DUE {60}; ///< Loans at least this many days past due count in delinquencyRiskPolicy
+const double MAXIMAL_DELINQUENCY_RATIO {0.05}; ///< Maximal (delinquent value left / total treasury) for delinquencyRiskPolicy
+}
+
+namespace PROFILING {
+const int HISTOGRAM_BUCKETS {32}; ///< Number of power of two buckets in profiledMutex wait and hold histograms
+const int MAX_CALL_SITES {8}; ///< Number of call sites tracked by a single profiledMutex
+}
+
+namespace LEDGER {
+const int CHUNK_SIZE {4096}; ///< Number of postings in a single chunk of a per-thread journal buffer
+const double RELATIVE_TOLERANCE {1e-8}; ///< Allowed relative difference between ledger balance and treasury (rounding)
+const int AUDIT_INTERVAL_MS {100}; ///< Default interval between two ledgerAuditor passes
+}
+
+namespace TRACE {
+const std::uint32_t MAGIC {0x52543245}; ///< "E2TR" at the beginning of every application trace file
+const std::uint32_t VERSION {1}; ///< Version of the application trace format
+}
+
+namespace ENSEMBLE {
+const int RUNS {64}; ///< Default number of simulation runs (seeds) in an ensemble
+const std::size_t SKETCH_CAPACITY {256}; ///< Values kept on a single level of quantileSketch
+const double CONFIDENCE_Z {1.96}; ///< Normal quantile of the reported confidence interval (95%)
+}
+
+namespace TIMING_WHEEL {
+const int SLOT_BITS {8}; ///< Every wheel of timingWheel has 2^SLOT_BITS slots
+const int LEVELS {4}; ///< Number of wheels, ticks up to 2^(SLOT_BITS * LEVELS) ahead are kept without re-placing
+}
+
+namespace ARRIVALS {
+const int QUEUE_CAPACITY {1024}; ///< Default capacity of arrivalQueue, arrivals above it are dropped
+const unsigned SEED {2022}; ///< Seed of random arrival processes
+const int POP_TIMEOUT_MS {5}; ///< How long a Local Bank waits for an arrival before doing its other work
+}
+
+namespace ADMISSION {
+const int QUEUE_CAPACITY {20}; ///< Default number of loan applications waiting for a pool thread of a single Local Bank
+const std::string POLICY {"wait"}; ///< Default admissionPolicy of pending applications (reject, shed or wait)
+const int WAIT_TIMEOUT_MS {50}; ///< How long "wait" policy waits for room before the application is rejected
+}
+
+namespace NUMA {
+const std::size_t ARENA_CHUNK_LOANS {256}; ///< Loans allocated at once by loanArena from node-local memory
+const std::size_t ARENA_BLOCK_ALIGNMENT {64}; ///< Loan blocks of loanArena start on separate cache lines
+const std::string SYSFS_NODES {"/sys/devices/system/node/node"}; ///< Prefix of sysfs node directories used without libnuma
 }
 
 //TODO: poprawic
+namespace ROUTING {
+const int REGIONS {16}; ///< Number of regions of clientRouter "region" policy (at most one per Local Bank)
+const int REFRESH_CLIENTS {64}; ///< Routed clients between two clientRouter::refresh() calls in economy2
+}
+
 namespace ECONOMY2 {
 const int MAX_NUMBER_OF_ACTIVE_CLIENTS {10}; ///< Size of thread pool for single Local Bank instance
+const int LOCAL_BANKS_AMOUNT {3}; ///< Default number of Local Banks
 const int MAX_NUMBER_OF_GENERATED_CLIENTS {300}; ///< Total number of clients throughout the whole simulation
+/*!
+ * @brief Epoch settlement mode
+ * 
+ * If true banks accumulate installments and settle them once per Local Bank / Central Bank loop pass
+ * instead of updating treasury on every installment. See bank::settleEpoch()
+ */
+const bool EPOCH_SETTLEMENT {false};
+const bool PROFILE_LOCKS {false}; ///< If true profiledMutex statistics are gathered and logged at the end of the run (see also --profile-locks)
+const std::string LOCAL_BANK_POLICY {"default"}; ///< Name of Local Bank loan policy, see loanPolicyRegistry
+const std::string CENTRAL_BANK_POLICY {"default"}; ///< Name of Central Bank loan policy, see loanPolicyRegistry
 }
 
 #endif /* CONSTANTS_H_ */
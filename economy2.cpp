@@ -6,10 +6,13 @@
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
+#include <chrono>
+#include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <vector>
 
-#include <boost/asio/io_service.hpp>
-#include <boost/bind.hpp>
-#include <boost/thread/thread.hpp>
 #include <boost/asio/post.hpp>
 #include <boost/asio/thread_pool.hpp>
 
@@ -21,117 +24,755 @@
 #include "banking/localBank.h"
 #include "banking/localClient.h"
 #include "banking/loan.h"
+#include "banking/loanPolicyRegistry.h"
+#include "banking/profiledMutex.h"
+#include "banking/traceRecorder.h"
+#include "banking/ledger.h"
+#include "banking/ledgerAuditor.h"
+#include "banking/boostLogSink.h"
+#include "banking/arrivalProcess.h"
+#include "banking/arrivalQueue.h"
+#include "banking/arrivalGenerator.h"
+#include "banking/applicationTrace.h"
+#include "banking/dice.h"
+#include "banking/simulationEngine.h"
+#include "banking/simulationEnsemble.h"
+#include "banking/clientRouter.h"
+#include "banking/numaTopology.h"
 
 using namespace std;
 
-int currentQueuedClientsCounter {0}; ///< needed for statistics
-int totalLocalClientsCounter {0}; ///< needed for statistics
+atomic<int> currentQueuedClientsCounter {0}; ///< needed for statistics, read without mtx in thread loops
+atomic<int> totalLocalClientsCounter {0}; ///< needed for statistics, read without mtx in thread loops
 
-mutex mtx;
+profiledMutex mtx {"economy2 mtx"}; ///< Makes checking and increasing totalLocalClientsCounter a single step
+
+bool headless {false}; ///< No console output and no logging, see --headless option
+chrono::milliseconds metricsInterval {0}; ///< Interval of metrics sampling in headless mode, 0 means no sampling
+chrono::milliseconds clientPaymentPause {75}; ///< Pause between two installments of a single Local Client
+chrono::milliseconds localBankPause {50}; ///< Pause between two iterations of Local Bank loop
+chrono::milliseconds centralBankPause {500}; ///< Pause between two iterations of Central Bank loop
+arrivalQueue* arrivalQueuePtr {nullptr}; ///< Queue of open-loop arrivals, nullptr if Local Banks create clients themselves
+latencyHistogram admissionLatency; ///< Time from client arrival to decision about its loan
+applicationTrace* applicationTracePtr {nullptr}; ///< Trace recording loan applications, nullptr if they are not recorded
+int routedPoolSize {ECONOMY2::MAX_NUMBER_OF_ACTIVE_CLIENTS}; ///< Threads of routed clients, see startDispatcher()
+std::vector<std::unique_ptr<arrivalQueue>> pendingApplications; ///< Bounded loan applications waiting for a pool thread, one queue per Local Bank
+bool numaPlacement {false}; ///< Local Banks are placed on NUMA nodes and threads serving them are pinned there, see --numa option
 
 /*!
  * Method responsible for single Local Client instance (creation and payment method) 
+ *
+ * **Bank** is the concrete class of Local Banks (see loanPolicyRegistry::visitLocalBankType()), so loan
+ * application is processed without virtual calls. Same for the methods below taking **Bank**.
+ */
+template<class Bank>
+void startLocalClient(Bank* localBankPtr, uint16_t localBankIndex, uint32_t clientNumber, chrono::steady_clock::time_point arrivalTime);
+/*!
+ * @brief Admitting **arrival** to pendingApplications of Local Bank **localBankIndex** and posting its processing to **pool**
+ *
+ * **arrival** has to be already counted in currentQueuedClientsCounter, the counter is decreased for every
+ * application which is rejected or shed. Pool holds at most one task per pending application.
+ */
+template<class Bank>
+void admitClient(boost::asio::thread_pool& pool, Bank* localBankPtr, uint16_t localBankIndex, const clientArrival& arrival);
+/*!
+ * @brief Returns true while new Local Clients can still come (generated by Local Banks or by arrivalGenerator)
  */
-void startLocalClient(localBank* localBankPtr);
+bool moreClientsExpected();
 /*!
  * Method managing a single Local Bank instance (creating new Local Clients
  * and paying loan to Central Bank
  */
-void startLocalBank(localBank* localBankPtr);
+template<class Bank>
+void startLocalBank(Bank* localBankPtr, uint16_t localBankIndex);
+/*!
+ * @brief Generating (or taking arrived) Local Clients centrally and routing them to Local Banks with **routerPtr**
+ *
+ * Used with --route instead of client creation in startLocalBank(). Up to one client per Local Bank is created
+ * every localBankPause while fewer than **routedPoolSize** clients are active, clients run in a single pool
+ * of **routedPoolSize** threads. With --numa there is one pool per NUMA node instead, its threads are pinned
+ * to the node once and run clients of Local Banks placed there.
+ */
+template<class Bank>
+void startDispatcher(clientRouter* routerPtr, centralBank* centralBankPtr);
+/*!
+ * @brief Paying Central Bank loans and settling epochs of **localBanks** until the simulation ends
+ *
+ * Used with --route, a few service threads handle all Local Banks instead of one thread per bank.
+ */
+void startBankService(std::vector<localBank*> localBanks);
+/*!
+ * @brief Pinning calling thread to NUMA node of **localBankPtr**, nothing is done if the bank is not placed
+ */
+void pinToBankNode(localBank* localBankPtr);
+/*!
+ * @brief Pinning all **threadsAmount** threads of **pool** to NUMA **node** before it runs any client, nothing is done for negative **node**
+ */
+void pinPoolThreads(boost::asio::thread_pool& pool, int threadsAmount, int node);
 /*!
  * Method managing a Central Bank instance.
  */
 void startCentralBank(centralBank* centralBankPtr);
+/*!
+ * @brief Printing aggregated end of run statistics (used in headless mode instead of logs)
+ */
+void printSummary(const std::vector<bank*>& banks, chrono::steady_clock::duration runTime);
+/*!
+ * @brief Replaying applicationTrace from **replayFileName** in simulationEngine at full speed, returns exit code
+ */
+int replay(const string& replayFileName);
+/*!
+ * @brief Running simulationEnsemble from **config** and printing its statistics, returns exit code
+ */
+int runEnsemble(const ensembleConfig& config);
 /*!
  * @brief method cout'ing funy messages (which shows that program is running and not freezed)
  */
 
+/*!
+ * Options:
+ * - **--trace <file>** records timeline of the run and writes it to **file** as Chrome trace JSON
+ * - **--headless** runs without pauses, console output and logging, only end of run statistics are printed
+ * - **--metrics <ms>** in headless mode prints treasury of all banks every **ms** milliseconds
+ * - **--profile-locks** gathers profiledMutex statistics and logs them at the end of the run, in headless mode they
+ * are printed after the summary (ECONOMY2::PROFILE_LOCKS by default)
+ * - **--audit <ms>** keeps double-entry ledger of all transfers and verifies it every **ms** milliseconds
+ * (LEDGER::AUDIT_INTERVAL_MS if **ms** is 0), audit result is printed at the end of the run
+ * - **--arrivals <spec>** clients arrive from arrivalProcess **spec** (see arrivalProcess::create()) through
+ * a bounded arrivalQueue instead of being created by Local Banks, arrival metrics are printed at the end of the run
+ * - **--queue <capacity>** capacity of the arrival queue (ARRIVALS::QUEUE_CAPACITY by default)
+ * - **--record <file>** records client creation and dice rolls of every loan application to **file** (applicationTrace)
+ * - **--replay <file>** replays applicationTrace from **file** in simulationEngine without pauses and threads,
+ * prints the result and exits; replay fails (exit code 1) if it needed dice rolls the trace does not have, which
+ * happens when applications of the recorded run asked Central Bank for money in a different order than the replay
+ * - **--admission <policy>** what happens to a loan application when pending applications of its Local Bank are full:
+ * **reject** it, **shed** the oldest pending one or **wait** for room (ADMISSION::POLICY by default), admission
+ * metrics are printed at the end of the run
+ * - **--pending <capacity>** pending applications per Local Bank (ADMISSION::QUEUE_CAPACITY by default), admission
+ * metrics are printed at the end of the run
+ * - **--schedule <schedule>** amortization of Local Client loans: **equal**, **annuity** or **declining**
+ * (LOCAL_CLIENT::LOAN_SCHEDULE by default)
+ * - **--variable-rate** Local Client loans are repriced when Central Bank rate moves to another LOAN::RATE_BUCKET
+ * - **--missed <rate>** probability that Local Client misses an installment (LOCAL_CLIENT::MISSED_PAYMENT_RATE by default),
+ * delinquency of Local Banks is printed at the end of the run
+ * - **--banks <n>** number of Local Banks (ECONOMY2::LOCAL_BANKS_AMOUNT by default)
+ * - **--route <policy>** Local Clients are generated centrally and routed to Local Banks by clientRouter
+ * **policy** (region, rate or hash), Local Banks are served by one thread per hardware thread;
+ * needed for many Local Banks, without it every Local Bank runs its own thread and client pool
+ * - **--numa** Local Banks are split into contiguous blocks, one per NUMA node (see numaTopology): each bank is
+ * created on its node, loans of its clients live in node-local loanArena and threads serving it (Local Bank thread,
+ * client pool threads, with --route service threads of contiguous blocks of banks) are pinned to that node;
+ * placement is printed at the end of the run
+ * - **--ensemble <runs>** runs simulationEngine with **runs** consecutive seeds on all cores, prints mean,
+ * confidence interval and quantiles of run outcomes and exits; tuned by **--threads <n>** (worker threads,
+ * all hardware threads by default), **--seed <seed>** (seed of the first run) and **--clients <n>** (clients per run),
+ * **--banks**, **--route**, **--schedule** and **--variable-rate** apply to every run
+ */
 int main(int argc, char **argv) {
-	cout << "App start" << endl;
-	loggerClass::logInit();
+	string traceFileName {};
+	bool audit {false};
+	chrono::milliseconds auditInterval {LEDGER::AUDIT_INTERVAL_MS};
+	string arrivalsSpec {};
+	size_t queueCapacity {ARRIVALS::QUEUE_CAPACITY};
+	string recordFileName {};
+	ensembleConfig ensemble;
+	bool ensembleMode {false};
+	int localBanksAmount {ECONOMY2::LOCAL_BANKS_AMOUNT};
+	string routingPolicy {};
+	string admissionPolicyName {ADMISSION::POLICY};
+	size_t pendingCapacity {ADMISSION::QUEUE_CAPACITY};
+	bool admissionMetrics {false};
+	string loanScheduleName {LOCAL_CLIENT::LOAN_SCHEDULE};
+	bool variableRate {LOCAL_CLIENT::VARIABLE_RATE};
+	bool profileLocks {ECONOMY2::PROFILE_LOCKS};
+	economicParameters runParameters;
+	for (int i = 1; i < argc; i++) {
+		string argument {argv[i]};
+		if (argument == "--trace" && i + 1 < argc) {
+			traceFileName = argv[++i];
+		} else if (argument == "--headless") {
+			headless = true;
+		} else if (argument == "--profile-locks") {
+			profileLocks = true;
+		} else if (argument == "--metrics" && i + 1 < argc) {
+			metricsInterval = chrono::milliseconds(atoi(argv[++i]));
+		} else if (argument == "--audit" && i + 1 < argc) {
+			audit = true;
+			int auditIntervalArg = atoi(argv[++i]);
+			if (auditIntervalArg > 0) {
+				auditInterval = chrono::milliseconds(auditIntervalArg);
+			}
+		} else if (argument == "--arrivals" && i + 1 < argc) {
+			arrivalsSpec = argv[++i];
+		} else if (argument == "--queue" && i + 1 < argc) {
+			queueCapacity = max(1, atoi(argv[++i]));
+		} else if (argument == "--admission" && i + 1 < argc) {
+			admissionPolicyName = argv[++i];
+			admissionMetrics = true;
+		} else if (argument == "--pending" && i + 1 < argc) {
+			pendingCapacity = max(1, atoi(argv[++i]));
+			admissionMetrics = true;
+		} else if (argument == "--schedule" && i + 1 < argc) {
+			loanScheduleName = argv[++i];
+		} else if (argument == "--missed" && i + 1 < argc) {
+			runParameters.missedPaymentRate = min(max(0.0, atof(argv[++i])), 1.0);
+		} else if (argument == "--variable-rate") {
+			variableRate = true;
+		} else if (argument == "--numa") {
+			numaPlacement = true;
+		} else if (argument == "--record" && i + 1 < argc) {
+			recordFileName = argv[++i];
+		} else if (argument == "--replay" && i + 1 < argc) {
+			return replay(argv[++i]);
+		} else if (argument == "--ensemble" && i + 1 < argc) {
+			ensembleMode = true;
+			ensemble.runs = max(1, atoi(argv[++i]));
+		} else if (argument == "--threads" && i + 1 < argc) {
+			ensemble.threads = max(0, atoi(argv[++i]));
+		} else if (argument == "--seed" && i + 1 < argc) {
+			ensemble.firstSeed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+		} else if (argument == "--banks" && i + 1 < argc) {
+			localBanksAmount = min(max(1, atoi(argv[++i])), static_cast<int>(numeric_limits<uint16_t>::max()));
+		} else if (argument == "--route" && i + 1 < argc) {
+			routingPolicy = argv[++i];
+		} else if (argument == "--clients" && i + 1 < argc) {
+			ensemble.simulation.clientsAmount = static_cast<uint32_t>(max(1, atoi(argv[++i])));
+		}
+	}
+	if (ensembleMode) {
+		ensemble.simulation.localBanksAmount = localBanksAmount;
+		ensemble.simulation.routingPolicy = routingPolicy;
+		ensemble.simulation.loanSchedule = loanScheduleName;
+		ensemble.simulation.variableRate = variableRate;
+		return runEnsemble(ensemble);
+	}
+	std::unique_ptr<arrivalProcess> arrivalProcessInstance;
+	if (!arrivalsSpec.empty()) {
+		arrivalProcessInstance = arrivalProcess::create(arrivalsSpec);
+		if (!arrivalProcessInstance) {
+			cout << "Unknown arrival process " << arrivalsSpec << endl;
+			return 2;
+		}
+	}
+	amortization loanSchedule {amortization::EQUAL};
+	if (!loan::parseSchedule(loanScheduleName, loanSchedule)) {
+		cout << "Unknown loan schedule " << loanScheduleName << endl;
+		return 2;
+	}
+	admissionPolicy admission {admissionPolicy::WAIT};
+	if (!arrivalQueue::parsePolicy(admissionPolicyName, admission)) {
+		cout << "Unknown admission policy " << admissionPolicyName << endl;
+		return 2;
+	}
+	if (headless) {
+		clientPaymentPause = 0ms;
+		localBankPause = 0ms;
+		centralBankPause = metricsInterval > 0ms ? metricsInterval : 1ms;
+	} else {
+		cout << "App start" << endl;
+	}
+	auto runStart = chrono::steady_clock::now();
+	loggerClass::setHeadless(headless);
+	boostLogSink::logInit();
+	profiledMutex::setEnabled(profileLocks);
+	traceRecorder::setEnabled(!traceFileName.empty());
+	ledger::setEnabled(audit);
 	loggerClass::logEvent("------ START ------");
 
 	srand(time(NULL)); // for true RNG
 
-	centralBank centralBankInstance;
-	thread centralBankThread{startCentralBank, &centralBankInstance};
+	std::unique_ptr<arrivalQueue> arrivalQueueInstance;
+	std::unique_ptr<arrivalGenerator> arrivalGeneratorInstance;
+	if (arrivalProcessInstance) {
+		arrivalQueueInstance.reset(new arrivalQueue(queueCapacity));
+		arrivalQueuePtr = arrivalQueueInstance.get();
+		arrivalGeneratorInstance.reset(new arrivalGenerator(std::move(arrivalProcessInstance), arrivalQueuePtr,
+				ECONOMY2::MAX_NUMBER_OF_GENERATED_CLIENTS));
+	}
+
+	std::unique_ptr<applicationTrace> applicationTraceInstance;
+	if (!recordFileName.empty()) {
+		applicationTraceInstance.reset(new applicationTrace());
+		applicationTracePtr = applicationTraceInstance.get();
+	}
+
+	std::unique_ptr<centralBank> centralBankInstance = loanPolicyRegistry::createCentralBank(ECONOMY2::CENTRAL_BANK_POLICY);
+	if (!centralBankInstance) {
+		cout << "Unknown Central Bank policy " << ECONOMY2::CENTRAL_BANK_POLICY << endl;
+		return 2;
+	}
+	centralBankInstance->setEpochSettlement(ECONOMY2::EPOCH_SETTLEMENT);
+	std::vector<std::unique_ptr<localBank>> localBanks;
+	std::vector<localBank*> localBankPtrs;
+	std::vector<bank*> banks;
+	for (int i = 1; i <= localBanksAmount; i++) {
+		int numaNode = numaTopology::nodeOfLocalBank(i - 1, localBanksAmount);
+		if (numaPlacement) {
+			// bank state is first touched by a thread running on its node
+			numaTopology::pinCurrentThread(numaNode);
+		}
+		localBanks.push_back(loanPolicyRegistry::createLocalBank(ECONOMY2::LOCAL_BANK_POLICY, "Local Bank " + to_string(i),
+				centralBankInstance.get()));
+		if (!localBanks.back()) {
+			cout << "Unknown Local Bank policy " << ECONOMY2::LOCAL_BANK_POLICY << endl;
+			return 2;
+		}
+		if (numaPlacement) {
+			localBanks.back()->setNumaNode(numaNode);
+		}
+		localBanks.back()->setEpochSettlement(ECONOMY2::EPOCH_SETTLEMENT);
+		localBanks.back()->setLoanTerms(loanSchedule, variableRate);
+		localBankPtrs.push_back(localBanks.back().get());
+		banks.push_back(localBanks.back().get());
+		pendingApplications.emplace_back(new arrivalQueue(pendingCapacity, admission));
+	}
+	if (numaPlacement) {
+		numaTopology::pinCurrentThread(-1);
+	}
+	banks.push_back(centralBankInstance.get());
+	for (auto bankPtr: banks) {
+		bankPtr->publishParameters(&runParameters);
+	}
+	std::unique_ptr<clientRouter> router;
+	if (!routingPolicy.empty()) {
+		router = clientRouter::create(routingPolicy, localBankPtrs);
+		if (!router) {
+			cout << "Unknown routing policy " << routingPolicy << endl;
+			return 2;
+		}
+	}
+	thread centralBankThread{startCentralBank, centralBankInstance.get()};
 	std::vector<thread> localBankThreadVector;
-	localBank localBankInstance1("Local Bank 1", &centralBankInstance);
-	localBankThreadVector.push_back(thread{startLocalBank, &localBankInstance1});
-	localBank localBankInstance2("Local Bank 2", &centralBankInstance);
-	localBankThreadVector.push_back(thread{startLocalBank, &localBankInstance2});
-	localBank localBankInstance3("Local Bank 3", &centralBankInstance);
-	localBankThreadVector.push_back(thread{startLocalBank, &localBankInstance3});
+	if (router) {
+		int serviceThreadsAmount = max(1, min(localBanksAmount, static_cast<int>(thread::hardware_concurrency())));
+		routedPoolSize = ECONOMY2::MAX_NUMBER_OF_ACTIVE_CLIENTS * serviceThreadsAmount;
+		for (int i = 0; i < serviceThreadsAmount; i++) {
+			std::vector<localBank*> servedBanks;
+			if (numaPlacement) {
+				// contiguous blocks, like NUMA nodes of the banks, so a service thread stays on one node
+				for (int j = i * localBanksAmount / serviceThreadsAmount; j < (i + 1) * localBanksAmount / serviceThreadsAmount; j++) {
+					servedBanks.push_back(localBankPtrs[j]);
+				}
+			} else {
+				for (int j = i; j < localBanksAmount; j += serviceThreadsAmount) {
+					servedBanks.push_back(localBankPtrs[j]);
+				}
+			}
+			localBankThreadVector.push_back(thread{startBankService, std::move(servedBanks)});
+		}
+	}
+	// all Local Banks are created by the same policy, client threads process loans without virtual calls
+	loanPolicyRegistry::visitLocalBankType(localBankPtrs.front(), [&](auto bankType) {
+		using Bank = typename decltype(bankType)::type;
+		if (router) {
+			localBankThreadVector.push_back(thread{startDispatcher<Bank>, router.get(), centralBankInstance.get()});
+		} else {
+			for (int i = 0; i < localBanksAmount; i++) {
+				localBankThreadVector.push_back(thread{startLocalBank<Bank>, static_cast<Bank*>(localBankPtrs[i]), static_cast<uint16_t>(i)});
+			}
+		}
+	});
+	std::unique_ptr<ledgerAuditor> auditor;
+	if (audit) {
+		auditor.reset(new ledgerAuditor(banks, auditInterval));
+	}
 	//Closing the programm
 	for(auto& t: localBankThreadVector) {
 		t.join();
 	}
 	centralBankThread.join();
-	centralBankInstance.logEvent("--- thread joined ---");
+	centralBankInstance->logEvent("--- thread joined ---");
+	//Settling last epoch
+	for (auto localBankPtr: localBankPtrs) {
+		localBankPtr->settleEpoch();
+	}
+	centralBankInstance->settleEpoch();
+	if (auditor) {
+		int mismatches = auditor->auditPass();
+		double imbalance = ledger::getImbalance();
+		cout << "Ledger audit: " << auditor->getPasses() << " passes, " << auditor->getFailures() << " failed bank checks, "
+				<< ledger::getCollectedPostings() << " postings, final imbalance " << imbalance
+				<< (mismatches == 0 && ledger::isBalanced() ? " (balanced)" : " (NOT balanced)") << endl;
+		auditor.reset();
+	}
+	if (arrivalQueuePtr) {
+		cout << "Arrivals: " << arrivalGeneratorInstance->getGenerated() << " offered, " << arrivalQueuePtr->getPushed()
+				<< " admitted, " << arrivalQueuePtr->getDropped() << " dropped, queue depth avg "
+				<< arrivalQueuePtr->getAverageDepth() << " max " << arrivalQueuePtr->getMaxDepth() << endl;
+		cout << "Queue wait: " << arrivalQueuePtr->getQueueWait().toString() << endl;
+		cout << "Admission latency: " << admissionLatency.toString() << endl;
+		arrivalGeneratorInstance.reset();
+		arrivalQueuePtr = nullptr;
+	}
+	if (admissionMetrics) {
+		uint64_t admitted {0};
+		uint64_t rejected {0};
+		uint64_t shed {0};
+		uint64_t waited {0};
+		size_t maxPending {0};
+		double pendingDepthSum {0};
+		latencyHistogram pendingWait;
+		for (auto& pending: pendingApplications) {
+			admitted = admitted + pending->getPushed();
+			rejected = rejected + pending->getDropped();
+			shed = shed + pending->getShed();
+			waited = waited + pending->getWaited();
+			maxPending = max(maxPending, pending->getMaxDepth());
+			pendingDepthSum = pendingDepthSum + pending->getAverageDepth() * pending->getPushed();
+			pendingWait.merge(pending->getQueueWait());
+		}
+		cout << "Admission (" << admissionPolicyName << ", " << pendingCapacity << " pending per Local Bank): "
+				<< admitted << " admitted, " << rejected << " rejected, " << shed << " shed, " << waited << " waited for room, "
+				<< "pending depth avg " << (admitted > 0 ? pendingDepthSum / admitted : 0) << " max " << maxPending << endl;
+		cout << "Pending wait: " << pendingWait.toString() << endl;
+	}
+	pendingApplications.clear();
+	if (numaPlacement) {
+		std::vector<int> nodeBanks(numaTopology::getNodesAmount(), 0);
+		std::vector<size_t> nodeChunks(numaTopology::getNodesAmount(), 0);
+		for (auto localBankPtr: localBankPtrs) {
+			nodeBanks[localBankPtr->getNumaNode()]++;
+			nodeChunks[localBankPtr->getNumaNode()] += localBankPtr->getLoanArena()->getChunksAmount();
+		}
+		cout << "NUMA placement (" << numaTopology::getSource() << "): " << numaTopology::getNodesAmount() << " nodes";
+		for (int node = 0; node < numaTopology::getNodesAmount(); node++) {
+			cout << ", node " << node << " " << nodeBanks[node] << " Local Banks " << nodeChunks[node] << " loan chunks";
+		}
+		cout << endl;
+	}
+	if (runParameters.missedPaymentRate > 0) {
+		for (auto localBankPtr: localBankPtrs) {
+			delinquencyBook delinquentLoans = localBankPtr->getDelinquencyBook();
+			cout << localBankPtr->getName() << " delinquency: " << delinquentLoans.getMissedInstalments() << " missed installments, "
+					<< "30 / 60 / 90+ days past due " << delinquentLoans.getBucket(30).loans << " / " << delinquentLoans.getBucket(60).loans
+					<< " / " << delinquentLoans.getBucket(90).loans << " loans, " << delinquentLoans.getCuredLoans() << " cured, "
+					<< delinquentLoans.getWrittenOffLoans() << " written off (" << delinquentLoans.getWrittenOffAmount() << ")" << endl;
+		}
+	}
+	if (applicationTracePtr) {
+		if (!applicationTracePtr->write(recordFileName)) {
+			cout << "Could not write application trace to " << recordFileName << endl;
+		}
+		applicationTracePtr = nullptr;
+	}
 	//Log info
-	localBankInstance1.logEndingInfo();
-	localBankInstance2.logEndingInfo();
-	localBankInstance3.logEndingInfo();
-	centralBankInstance.logEndingInfo();
-	loggerClass::logEvent("Total local clients: " + to_string(totalLocalClientsCounter++));
+	for (auto bankPtr: banks) {
+		bankPtr->logEndingInfo();
+	}
+	profiledMutex::logReport();
+	loggerClass::logEvent("Total local clients: " + to_string(totalLocalClientsCounter.load()));
 	loggerClass::logEvent("------ END ------");
-	cout << "App end" << endl;
+	if (headless) {
+		printSummary(banks, chrono::steady_clock::now() - runStart);
+		if (profileLocks) {
+			for (auto& line: profiledMutex::getReport()) {
+				cout << line << endl;
+			}
+		}
+	}
+	if (traceRecorder::isEnabled()) {
+		traceRecorder::setEnabled(false);
+		if (!traceRecorder::writeChromeTrace(traceFileName)) {
+			cout << "Could not write trace to " << traceFileName << endl;
+		}
+	}
+	if (!headless) {
+		cout << "App end" << endl;
+	}
 	return 0;
 }
 
-void startLocalClient(localBank* localBankPtr) {
-	string name{};
+bool moreClientsExpected() {
+	if (arrivalQueuePtr != nullptr) {
+		return !arrivalQueuePtr->isDrained();
+	}
+	return totalLocalClientsCounter < ECONOMY2::MAX_NUMBER_OF_GENERATED_CLIENTS;
+}
+
+template<class Bank>
+void admitClient(boost::asio::thread_pool& pool, Bank* localBankPtr, uint16_t localBankIndex, const clientArrival& arrival) {
+	arrivalQueue* pendingPtr = pendingApplications[localBankIndex].get();
+	switch (pendingPtr->push(arrival, chrono::milliseconds(ADMISSION::WAIT_TIMEOUT_MS))) {
+	case admissionResult::ADMITTED:
+		boost::asio::post(pool, [localBankPtr, localBankIndex, pendingPtr]() {
+			clientArrival pending {};
+			if (pendingPtr->pop(pending, chrono::milliseconds(0))) {
+				startLocalClient(localBankPtr, localBankIndex, pending.clientNumber, pending.arrivalTime);
+			}
+		});
+		break;
+	case admissionResult::ADMITTED_SHEDDING:
+		// task of the shed application serves the new one
+		currentQueuedClientsCounter--;
+		break;
+	case admissionResult::REJECTED:
+		currentQueuedClientsCounter--;
+		break;
+	}
+}
+
+template<class Bank>
+void startLocalClient(Bank* localBankPtr, uint16_t localBankIndex, uint32_t clientNumber, chrono::steady_clock::time_point arrivalTime) {
+	traceSpan span("client lifecycle");
+	localClient* localClientPtr {nullptr};
 	{
-		unique_lock<mutex> ul(mtx);
-		name = localBankPtr->getName() + "-Local Client-" + to_string(currentQueuedClientsCounter);
+		// Central Bank validation runs inside localBank::loanProcessingMethod(), so all rolls of the application are recorded;
+		// Central Bank roll for waiting loans lands in the application which crossed LOCAL_BANK::THRESHOLD_FOR_LOAN
+		std::unique_ptr<dice::tape> recordTape(applicationTracePtr ? new dice::tape() : nullptr);
+		localClientPtr = new localClient(clientNumber, localBankPtr);
+		localBankPtr->loanProcessingMethod(localClientPtr->getLoanPtr());
+		if (recordTape) {
+			applicationTracePtr->append({localBankIndex, clientNumber, recordTape->getRecorded()});
+		}
+	}
+	admissionLatency.record(chrono::steady_clock::now() - arrivalTime);
+	// validated loan may wait for Central Bank money, client resigns once no more clients will come
+	while (!localClientPtr->getLoanPtr()->isReadyToBePayed() && localBankPtr->isLoanWaiting(localClientPtr->getLoanPtr())) {
+		if (!moreClientsExpected()
+				&& localBankPtr->cancelWaitingLoan(localClientPtr->getLoanPtr())) {
+			break;
+		}
+		this_thread::sleep_for(clientPaymentPause);
+		this_thread::yield();
 	}
-	localClient* localClientPtr = new localClient(name, localBankPtr);
-	localBankPtr->loanProcessingMethod(localClientPtr->getLoanPtr());
 	while (localClientPtr->getLoanPtr()->isReadyToBePayed()) {
 		localClientPtr->paymentMethod();
-		this_thread::sleep_for(75ms);
-	}
-	{
-		unique_lock<mutex> ul(mtx);
-		currentQueuedClientsCounter--;
+		this_thread::sleep_for(clientPaymentPause);
 	}
-	loggerClass::logEvent("Current active clients: " + to_string(currentQueuedClientsCounter));
-	loggerClass::logEvent("Total active clients: " + to_string(totalLocalClientsCounter));
+	currentQueuedClientsCounter--;
+	LOG_EVENT_LAZY(loggerClass::logEvent, "Current active clients: " + to_string(currentQueuedClientsCounter.load()));
+	LOG_EVENT_LAZY(loggerClass::logEvent, "Total active clients: " + to_string(totalLocalClientsCounter.load()));
 	delete localClientPtr;
 	localClientPtr = nullptr;
 }
 
-void startLocalBank(localBank* localBankPtr) {
+template<class Bank>
+void startLocalBank(Bank* localBankPtr, uint16_t localBankIndex) {
+	pinToBankNode(localBankPtr);
 	boost::asio::thread_pool pool(ECONOMY2::MAX_NUMBER_OF_ACTIVE_CLIENTS);
-	while (totalLocalClientsCounter < ECONOMY2::MAX_NUMBER_OF_GENERATED_CLIENTS
-			|| currentQueuedClientsCounter > 0) {
-		if (!localBankPtr->getLoanPtr()->isReadyToBePayed() && totalLocalClientsCounter < ECONOMY2::MAX_NUMBER_OF_GENERATED_CLIENTS) {
-			{
-				unique_lock<mutex> ul(mtx);
-				totalLocalClientsCounter++;
+	pinPoolThreads(pool, ECONOMY2::MAX_NUMBER_OF_ACTIVE_CLIENTS, localBankPtr->getNumaNode());
+	arrivalQueue* pendingPtr = pendingApplications[localBankIndex].get();
+	auto nextBankWork = chrono::steady_clock::now();
+	while (moreClientsExpected() || currentQueuedClientsCounter > 0) {
+		clientArrival arrival {0, chrono::steady_clock::now()};
+		if (arrivalQueuePtr != nullptr) {
+			// every arrival goes to admitClient(), so the admission policy rejects, sheds or waits when pending
+			// applications are full; burst is bounded by the pending capacity to keep bank work going, only the
+			// first pop waits for an arrival
+			chrono::milliseconds popTimeout {ARRIVALS::POP_TIMEOUT_MS};
+			for (size_t popped = 0; popped < pendingPtr->getCapacity(); popped++) {
+				// counted before pop, so moreClientsExpected() || currentQueuedClientsCounter > 0 never misses the arrival
 				currentQueuedClientsCounter++;
+				if (!arrivalQueuePtr->pop(arrival, popTimeout)) {
+					currentQueuedClientsCounter--;
+					break;
+				}
+				totalLocalClientsCounter++;
+				admitClient(pool, localBankPtr, localBankIndex, arrival);
+				popTimeout = chrono::milliseconds(0);
+			}
+		} else if (!localBankPtr->isPayingLoan() && totalLocalClientsCounter < ECONOMY2::MAX_NUMBER_OF_GENERATED_CLIENTS) {
+			bool clientCreated {false};
+			{
+				profiledLock ul(mtx);
+				if (totalLocalClientsCounter < ECONOMY2::MAX_NUMBER_OF_GENERATED_CLIENTS) {
+					currentQueuedClientsCounter++;
+					arrival.clientNumber = totalLocalClientsCounter++;
+					clientCreated = true;
+				}
+			}
+			if (clientCreated) {
+				admitClient(pool, localBankPtr, localBankIndex, arrival);
 			}
-			boost::asio::post(pool, [localBankPtr](){ startLocalClient(localBankPtr); });
 		}
-		localBankPtr->paymentMethod();
-		this_thread::sleep_for(50ms);
+		// with arrivals the loop is paced by arrivalQueue::pop(), bank work keeps the localBankPause cadence
+		if (arrivalQueuePtr == nullptr || chrono::steady_clock::now() >= nextBankWork) {
+			localBankPtr->paymentMethod();
+			localBankPtr->settleEpoch();
+			nextBankWork = chrono::steady_clock::now() + localBankPause;
+		}
+		if (arrivalQueuePtr == nullptr) {
+			this_thread::sleep_for(localBankPause);
+		}
 	}
 	pool.join();
 	localBankPtr->logEvent("Local Clients threads joined ---");
-	this_thread::sleep_for(100ms);
+	this_thread::sleep_for(localBankPause * 2);
 	localBankPtr->logEvent("--- thread joined ---");
 }
 
+template<class Bank>
+void startDispatcher(clientRouter* routerPtr, centralBank* centralBankPtr) {
+	int poolsAmount = numaPlacement ? numaTopology::getNodesAmount() : 1;
+	int poolThreadsAmount = max(1, routedPoolSize / poolsAmount);
+	std::vector<std::unique_ptr<boost::asio::thread_pool>> pools;
+	for (int node = 0; node < poolsAmount; node++) {
+		pools.emplace_back(new boost::asio::thread_pool(poolThreadsAmount));
+		pinPoolThreads(*pools.back(), poolThreadsAmount, numaPlacement ? node : -1);
+	}
+	int routedClients {0};
+	while (moreClientsExpected()) {
+		for (size_t i = 0; i < routerPtr->getBanksAmount() && currentQueuedClientsCounter < routedPoolSize; i++) {
+			clientArrival arrival {0, chrono::steady_clock::now()};
+			if (arrivalQueuePtr != nullptr) {
+				currentQueuedClientsCounter++;
+				if (!arrivalQueuePtr->pop(arrival, chrono::milliseconds(ARRIVALS::POP_TIMEOUT_MS))) {
+					currentQueuedClientsCounter--;
+					break;
+				}
+				totalLocalClientsCounter++;
+			} else {
+				profiledLock ul(mtx);
+				if (totalLocalClientsCounter >= ECONOMY2::MAX_NUMBER_OF_GENERATED_CLIENTS) {
+					break;
+				}
+				currentQueuedClientsCounter++;
+				arrival.clientNumber = totalLocalClientsCounter++;
+			}
+			if (routedClients++ % ROUTING::REFRESH_CLIENTS == 0) {
+				routerPtr->refresh(centralBankPtr->getParameters());
+			}
+			uint32_t localBankIndex = routerPtr->route(arrival.clientNumber);
+			if (localBankIndex == clientRouter::NO_BANK) {
+				currentQueuedClientsCounter--;
+				continue;
+			}
+			Bank* localBankPtr = static_cast<Bank*>(routerPtr->getBank(localBankIndex));
+			admitClient(*pools[max(0, localBankPtr->getNumaNode())], localBankPtr, static_cast<uint16_t>(localBankIndex), arrival);
+		}
+		// with arrivals the loop is paced by arrivalQueue::pop(), it sleeps only while the pool is full
+		if (arrivalQueuePtr == nullptr) {
+			this_thread::sleep_for(localBankPause);
+		} else if (currentQueuedClientsCounter >= routedPoolSize) {
+			this_thread::sleep_for(chrono::milliseconds(ARRIVALS::POP_TIMEOUT_MS));
+		}
+	}
+	for (auto& pool: pools) {
+		pool->join();
+	}
+	loggerClass::logEvent("Routed Local Clients threads joined ---");
+}
+
+void startBankService(std::vector<localBank*> localBanks) {
+	if (!localBanks.empty()) {
+		pinToBankNode(localBanks.front());
+	}
+	while (moreClientsExpected() || currentQueuedClientsCounter > 0) {
+		for (auto localBankPtr: localBanks) {
+			localBankPtr->paymentMethod();
+			localBankPtr->settleEpoch();
+		}
+		this_thread::sleep_for(localBankPause);
+	}
+	for (auto localBankPtr: localBanks) {
+		localBankPtr->logEvent("--- thread joined ---");
+	}
+}
+
+void pinToBankNode(localBank* localBankPtr) {
+	if (localBankPtr->getNumaNode() >= 0 && !numaTopology::pinCurrentThread(localBankPtr->getNumaNode())) {
+		loggerClass::logEvent("Could not pin thread to NUMA node " + to_string(localBankPtr->getNumaNode()));
+	}
+}
+
+void pinPoolThreads(boost::asio::thread_pool& pool, int threadsAmount, int node) {
+	if (node < 0) {
+		return;
+	}
+	struct pinBarrier {
+		std::mutex barrierMTX;
+		std::condition_variable allPinned;
+		int pinned {0};
+	};
+	// every task holds its thread until all of them are pinned, so each pool thread runs exactly one
+	auto barrier = std::make_shared<pinBarrier>();
+	for (int i = 0; i < threadsAmount; i++) {
+		boost::asio::post(pool, [barrier, threadsAmount, node]() {
+			if (!numaTopology::pinCurrentThread(node)) {
+				loggerClass::logEvent("Could not pin thread to NUMA node " + to_string(node));
+			}
+			std::unique_lock<std::mutex> ul(barrier->barrierMTX);
+			barrier->pinned++;
+			barrier->allPinned.notify_all();
+			barrier->allPinned.wait(ul, [&barrier, threadsAmount]() { return barrier->pinned == threadsAmount; });
+		});
+	}
+	std::unique_lock<std::mutex> ul(barrier->barrierMTX);
+	barrier->allPinned.wait(ul, [&barrier, threadsAmount]() { return barrier->pinned == threadsAmount; });
+}
 
 void startCentralBank(centralBank* centralBankPtr) {
 	int i {0};
-	while (totalLocalClientsCounter < ECONOMY2::MAX_NUMBER_OF_GENERATED_CLIENTS || currentQueuedClientsCounter > 0) {
-		this_thread::sleep_for(500ms);
+	while (moreClientsExpected() || currentQueuedClientsCounter > 0) {
+		this_thread::sleep_for(centralBankPause);
+		centralBankPtr->settleEpoch();
+		if (headless) {
+			if (metricsInterval > 0ms) {
+				cout << "metrics: clients " << totalLocalClientsCounter
+						<< ", active clients " << currentQueuedClientsCounter
+						<< ", Central Bank treasury " << centralBankPtr->getCurrentTreasury()
+						<< ", interest rate " << centralBankPtr->getInterestRate() << endl;
+			}
+			continue;
+		}
 		std::cout << "." << flush;
 		i++;
 		if (i%20 == 0) {
 			std::cout << "\n" << flush;
 		}
 	}
-	std::cout << endl;
+	if (!headless) {
+		std::cout << endl;
+	}
+}
+
+void printSummary(const std::vector<bank*>& banks, chrono::steady_clock::duration runTime) {
+	double seconds = chrono::duration<double>(runTime).count();
+	cout << "Run time: " << seconds << " s" << endl;
+	cout << "Total local clients: " << totalLocalClientsCounter
+			<< " (" << totalLocalClientsCounter / seconds << " clients / s)" << endl;
+	for (auto bankPtr: banks) {
+		double validationRate = bankPtr->getTotalLoans() > 0 ? bankPtr->getTotalValidLoans() / bankPtr->getTotalLoans() : 0;
+		cout << bankPtr->getName()
+				<< ": treasury rate " << bankPtr->getCurrentTreasury() / bankPtr->getTotalTreasury() * 100
+				<< "%, interest rate " << bankPtr->getInterestRate() * 100
+				<< "%, loans validation rate " << validationRate * 100
+				<< "% (" << bankPtr->getTotalValidLoans() << " / " << bankPtr->getTotalLoans() << ")" << endl;
+	}
+}
+
+int replay(const string& replayFileName) {
+	loggerClass::setHeadless(true);
+	profiledMutex::setEnabled(false);
+	simulationConfig config;
+	config.replayFileName = replayFileName;
+	std::unique_ptr<simulationEngine> engine = simulationEngine::create(config);
+	if (!engine) {
+		cout << "Could not replay application trace " << replayFileName << endl;
+		return 2;
+	}
+	auto start = chrono::steady_clock::now();
+	simulationResult result = engine->run();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout << "Replayed " << result.loanApplications << " loan applications in " << result.ticks << " ticks, "
+			<< result.events() << " events in " << seconds << " s (" << result.events() / max(seconds, 1e-9) << " events / s)" << endl;
+	cout << "Central Bank treasury " << result.centralBankTreasury << ", Local Banks treasury " << result.localBanksTreasury
+			<< ", waiting clients " << result.waitingClients << ", missing dice rolls " << result.replayMisses << endl;
+	if (result.replayMisses > 0) {
+		cout << "Replay diverged from the recorded run, " << result.replayMisses << " dice rolls were drawn instead of replayed" << endl;
+		return 1;
+	}
+	return 0;
+}
+
+int runEnsemble(const ensembleConfig& config) {
+	loggerClass::setHeadless(true);
+	profiledMutex::setEnabled(false);
+	std::unique_ptr<ensembleResult> result = simulationEnsemble::run(config);
+	if (!result) {
+		cout << "Could not create simulation for the ensemble" << endl;
+		return 2;
+	}
+	cout << result->toString() << endl;
+	return 0;
 }
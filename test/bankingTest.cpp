@@ -4,8 +4,14 @@
  * Test class created using gtest and gmock. 
  */
 
+#include <algorithm>
 #include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
 #include <vector>
+#include <type_traits>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -16,6 +22,27 @@
 #include "banking/localClient.h"
 #include "banking/loan.h"
 #include "banking/dice.h"
+#include "banking/loanPolicy.h"
+#include "banking/policyBank.h"
+#include "banking/loanPolicyRegistry.h"
+#include "banking/compactBank.h"
+#include "banking/nameTable.h"
+#include "banking/profiledMutex.h"
+#include "banking/traceRecorder.h"
+#include "banking/simulationEngine.h"
+#include "banking/timingWheel.h"
+#include "banking/economicScenario.h"
+#include "banking/arrivalProcess.h"
+#include "banking/arrivalQueue.h"
+#include "banking/arrivalGenerator.h"
+#include "banking/applicationTrace.h"
+#include "banking/runningStatistics.h"
+#include "banking/simulationEnsemble.h"
+#include "banking/clientRouter.h"
+#include "banking/ledger.h"
+#include "banking/ledgerAuditor.h"
+#include "banking/loanArena.h"
+#include "banking/numaTopology.h"
 #include "../constants.h"
 
 /*!
@@ -179,6 +206,99 @@ TEST(LoanTest, LoanPayment) {
 	EXPECT_FALSE(loanInstance.payAndUpdate());
 }
 
+/*!
+ * @brief Paying loan of every schedule until the end
+ *
+ * Installments sum up to starting value plus costs, annuity installments are equal, declining installments
+ * decrease, interest on value left makes annuity cheaper than equal installments and declining cheaper than annuity.
+ */
+TEST(LoanTest, AmortizationSchedules) {
+	amortization schedule {amortization::EQUAL};
+	EXPECT_TRUE(loan::parseSchedule("declining", schedule));
+	EXPECT_EQ(amortization::DECLINING, schedule);
+	EXPECT_FALSE(loan::parseSchedule("balloon", schedule));
+
+	std::vector<double> costs;
+	for (amortization scheduleArg: {amortization::EQUAL, amortization::ANNUITY, amortization::DECLINING}) {
+		loan loanInstance(loanAmount, loanInstalments, loanInterest, 0, scheduleArg);
+		EXPECT_EQ(scheduleArg, loanInstance.getSchedule());
+		double cost = loanInstance.getCost();
+		EXPECT_NEAR(loanAmount + cost, loanInstance.getValueLeft(), 1e-6);
+		loanInstance.validateLoan();
+		double paid {0};
+		double previousInstallment = loanInstance.getSingleInstallmentValue();
+		while (loanInstance.isLoanValid()) {
+			double installment = loanInstance.getSingleInstallmentValue();
+			if (scheduleArg == amortization::DECLINING) {
+				EXPECT_LE(installment, previousInstallment);
+			} else {
+				EXPECT_NEAR(previousInstallment, installment, 1e-6);
+			}
+			previousInstallment = installment;
+			paid = paid + installment;
+			loanInstance.payAndUpdate();
+		}
+		EXPECT_NEAR(loanAmount + cost, paid, 1e-6);
+		EXPECT_NEAR(0, loanInstance.getPrincipalLeft(), 1e-6);
+		EXPECT_EQ(0, loanInstance.getRepricingsAmount());
+		costs.push_back(cost);
+	}
+	EXPECT_GT(costs[0], costs[1]);
+	EXPECT_GT(costs[1], costs[2]);
+	EXPECT_DOUBLE_EQ(loanInterest / loanInstalments * loanAmount * (loanInstalments + 1) / 2, costs[2]);
+}
+
+/*!
+ * @brief Variable-rate loan is repriced at payment only when reference rate moves to another bucket
+ */
+TEST(LoanTest, VariableRateRepricing) {
+	rateSeqlock reference;
+	reference.publish(0.101);
+	const double margin {0.05};
+	loan loanInstance(loanAmount, loanInstalments, 0.101 + margin, reference.getVersion(), amortization::ANNUITY);
+	loanInstance.setRateReference(&reference, 0.101);
+	EXPECT_TRUE(loanInstance.isVariableRate());
+	loanInstance.validateLoan();
+	double paid {0};
+	double initialCost = loanInstance.getCost();
+	double initialInstallment = loanInstance.getSingleInstallmentValue();
+
+	paid = paid + loanInstance.getSingleInstallmentValue();
+	loanInstance.payAndUpdate();
+	EXPECT_EQ(0, loanInstance.getRepricingsAmount());
+
+	// same bucket: new version is noticed, schedule stays
+	reference.publish(0.1015);
+	paid = paid + loanInstance.getSingleInstallmentValue();
+	loanInstance.payAndUpdate();
+	EXPECT_EQ(0, loanInstance.getRepricingsAmount());
+	EXPECT_EQ(reference.getVersion(), loanInstance.getRateVersion());
+	EXPECT_NEAR(initialInstallment, loanInstance.getSingleInstallmentValue(), 1e-6);
+
+	// another bucket: remaining installments are recomputed with the same margin
+	reference.publish(0.121);
+	paid = paid + loanInstance.getSingleInstallmentValue();
+	loanInstance.payAndUpdate();
+	EXPECT_EQ(1, loanInstance.getRepricingsAmount());
+	EXPECT_DOUBLE_EQ(0.121 + margin, loanInstance.getInterestRate());
+	EXPECT_GT(loanInstance.getSingleInstallmentValue(), initialInstallment);
+	EXPECT_GT(loanInstance.getCost(), initialCost);
+
+	while (loanInstance.isLoanValid()) {
+		paid = paid + loanInstance.getSingleInstallmentValue();
+		loanInstance.payAndUpdate();
+	}
+	EXPECT_NEAR(loanAmount + loanInstance.getCost(), paid, 1e-6);
+	EXPECT_NEAR(0, loanInstance.getPrincipalLeft(), 1e-6);
+
+	loan fixedLoan(loanAmount, loanInstalments, loanInterest, reference.getVersion());
+	reference.publish(0.2);
+	fixedLoan.validateLoan();
+	fixedLoan.payAndUpdate();
+	EXPECT_FALSE(fixedLoan.isVariableRate());
+	EXPECT_EQ(0, fixedLoan.getRepricingsAmount());
+}
+
 //========== BANK: bank.h; centralBank.h; localBank.h ==========
 /*!
  * @brief Central Bank basic test
@@ -325,6 +445,243 @@ TEST(BankTest, LocalBank_LoanProcessingMethod_MaximalValueLoan) {
 	EXPECT_DOUBLE_EQ(expectedTotalTreasury, mockLocalBankInstance.getTotalTreasury());
 }
 
+/*!
+ * @brief Local Bank processing batch of loans
+ * 
+ * Dice rolls are reproduced with the same seed to compute expected result of the batch.
+ * Loans are small enough to be all granted from treasury.
+ */
+TEST(BankTest, LocalBank_LoanProcessingBatch) {
+	const unsigned seed {1234};
+	const int loansAmount {16};
+	centralBank centralBankInstance;
+	localBank localBankInstance("Local Bank", &centralBankInstance);
+	std::vector<loan> loans;
+	std::vector<loan*> loanPtrs;
+	loans.reserve(loansAmount);
+	for (int i = 0; i < loansAmount; i++) {
+		loans.emplace_back(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER + i % 3, 10, localBankInstance.getInterestRate());
+		loanPtrs.push_back(&loans.back());
+	}
+	srand(seed);
+	dice referenceDice(BANK::DICE_SIZE);
+	double expectedTreasury {LOCAL_BANK::STARTING_TREASURY};
+	std::vector<bool> expectedGranted;
+	for (auto loanPtr: loanPtrs) {
+		int roll = referenceDice.roll();
+		expectedGranted.push_back((roll + static_cast<int>(loanPtr->getStartingValue()) % 3) >= 6);
+		if (expectedGranted.back()) {
+			expectedTreasury = expectedTreasury - loanPtr->getStartingValue();
+		}
+	}
+	srand(seed);
+	localBankInstance.loanProcessingBatch(loanPtrs);
+	for (int i = 0; i < loansAmount; i++) {
+		EXPECT_EQ(expectedGranted[i], loanPtrs[i]->isReadyToBePayed());
+	}
+	EXPECT_DOUBLE_EQ(expectedTreasury, localBankInstance.getCurrentTreasury());
+}
+
+/*!
+ * @brief Treasury feasibility kernel of Local Bank batch processing
+ */
+TEST(BankTest, LocalBank_CountFeasible) {
+	const double cumulativeValues[] {100, 100, 300, 600, 600, 1000};
+	EXPECT_EQ(0u, localBank::countFeasible(cumulativeValues, 6, 100));
+	EXPECT_EQ(2u, localBank::countFeasible(cumulativeValues, 6, 100.5));
+	EXPECT_EQ(5u, localBank::countFeasible(cumulativeValues, 6, 999));
+	EXPECT_EQ(6u, localBank::countFeasible(cumulativeValues, 6, 1001));
+}
+
+/*!
+ * @brief Missed installments age the loan through 30 / 60 / 90+ days buckets, payment cures it, fourth miss writes it off
+ *
+ * Seriously delinquent loans stop Local Bank lending until they are cured.
+ */
+TEST(BankTest, LocalBank_Delinquency) {
+	centralBank centralBankInstance;
+	localBank localBankInstance("Delinquency Local Bank", &centralBankInstance);
+	loan delinquentLoan(loanAmount / 10, loanInstalments, loanInterest);
+	delinquentLoan.validateLoan();
+	delinquentLoan.setAsReadyForPayment();
+	double valueLeft = delinquentLoan.getValueLeft();
+	loan application(loanAmount / 100, loanInstalments, loanInterest);
+
+	EXPECT_FALSE(localBankInstance.reportMissedPayment(&delinquentLoan));
+	EXPECT_EQ(1, localBankInstance.getDelinquencyBook().getBucket(30).loans);
+	EXPECT_FALSE(localBankInstance.reportMissedPayment(&delinquentLoan));
+	delinquencyBook delinquentLoans = localBankInstance.getDelinquencyBook();
+	EXPECT_EQ(0, delinquentLoans.getBucket(30).loans);
+	EXPECT_EQ(1, delinquentLoans.getBucket(60).loans);
+	EXPECT_DOUBLE_EQ(valueLeft, delinquentLoans.getDelinquentAmount(LOAN_POLICY::RISK_DAYS_PAST_DUE));
+	for (int i = 0; i < 20; i++) {
+		EXPECT_FALSE(localBankInstance.loanValidationMethod(&application));
+	}
+	EXPECT_FALSE(localBankInstance.reportMissedPayment(&delinquentLoan));
+	EXPECT_EQ(1, localBankInstance.getDelinquencyBook().getBucket(90).loans);
+
+	localBankInstance.reportCuredLoan(&delinquentLoan);
+	delinquentLoans = localBankInstance.getDelinquencyBook();
+	EXPECT_EQ(0, delinquentLoan.getMissedInstalments());
+	EXPECT_EQ(1, delinquentLoans.getCuredLoans());
+	EXPECT_DOUBLE_EQ(0, delinquentLoans.getDelinquentAmount(30));
+	bool approved {false};
+	for (int i = 0; i < 100 && !approved; i++) {
+		approved = localBankInstance.loanValidationMethod(&application);
+	}
+	EXPECT_TRUE(approved);
+
+	double totalTreasury = localBankInstance.getTotalTreasury();
+	for (int i = 1; i < LOAN::WRITE_OFF_MISSED_INSTALMENTS; i++) {
+		EXPECT_FALSE(localBankInstance.reportMissedPayment(&delinquentLoan));
+	}
+	EXPECT_TRUE(localBankInstance.reportMissedPayment(&delinquentLoan));
+	delinquentLoans = localBankInstance.getDelinquencyBook();
+	EXPECT_FALSE(delinquentLoan.isReadyToBePayed());
+	EXPECT_FALSE(delinquentLoan.isLoanValid());
+	EXPECT_EQ(1, delinquentLoans.getWrittenOffLoans());
+	EXPECT_DOUBLE_EQ(valueLeft, delinquentLoans.getWrittenOffAmount());
+	EXPECT_DOUBLE_EQ(0, delinquentLoans.getDelinquentAmount(30));
+	EXPECT_EQ(3 + LOAN::WRITE_OFF_MISSED_INSTALMENTS, delinquentLoans.getMissedInstalments());
+	EXPECT_DOUBLE_EQ(totalTreasury - valueLeft, localBankInstance.getTotalTreasury());
+}
+
+//========== LOAN POLICY: loanPolicy.h; policyBank.h; loanPolicyRegistry.h ==========
+/*!
+ * @brief Policy approving every loan, needed for policy tests
+ */
+struct approveAllPolicy {
+	static bool approve(const loanPolicyContext&) {
+		return true;
+	};
+};
+
+/*!
+ * @brief Policy rejecting every loan, needed for policy tests
+ */
+struct rejectAllPolicy {
+	static bool approve(const loanPolicyContext&) {
+		return false;
+	};
+};
+
+/*!
+ * @brief Policy chain approves only if all policies approve
+ */
+TEST(LoanPolicyTest, PolicyChain) {
+	loan loanInstance(loanAmount, loanInstalments, loanInterest);
+	dice diceInstance(BANK::DICE_SIZE);
+	loanPolicyContext context {&loanInstance, &diceInstance, 2 * loanAmount, 2 * loanAmount, loanInterest, false, 0.0};
+	EXPECT_TRUE((policyChain<approveAllPolicy, treasuryFeasibilityPolicy>::approve(context)));
+	EXPECT_FALSE((policyChain<approveAllPolicy, rejectAllPolicy>::approve(context)));
+	context.hasOwnLoan = true;
+	EXPECT_FALSE((policyChain<approveAllPolicy, noOwnLoanPolicy>::approve(context)));
+}
+
+/*!
+ * @brief Treasury ratio and credit scoring policies
+ */
+TEST(LoanPolicyTest, TreasuryRatioAndCreditScoring) {
+	loan smallLoan(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER, LOCAL_CLIENT::MINIMAL_INSTALLMENT_AMOUNT, loanInterest);
+	loan bigLoan(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER * 100, LOCAL_CLIENT::MINIMAL_INSTALLMENT_AMOUNT, loanInterest);
+	dice diceInstance(BANK::DICE_SIZE);
+	loanPolicyContext context {&smallLoan, &diceInstance, LOCAL_BANK::STARTING_TREASURY, LOCAL_BANK::STARTING_TREASURY, loanInterest, false, 0.0};
+	EXPECT_TRUE(treasuryRatioPolicy::approve(context));
+	EXPECT_TRUE(creditScoringPolicy::approve(context));
+	context.loanPtr = &bigLoan;
+	EXPECT_FALSE(treasuryRatioPolicy::approve(context));
+	EXPECT_FALSE(creditScoringPolicy::approve(context));
+}
+
+/*!
+ * @brief Local Bank with compile time policy
+ */
+TEST(LoanPolicyTest, PolicyLocalBank) {
+	centralBank centralBankInstance;
+	policyLocalBank<approveAllPolicy> approvingBank("Approving Local Bank", &centralBankInstance);
+	policyLocalBank<rejectAllPolicy> rejectingBank("Rejecting Local Bank", &centralBankInstance);
+	loan loanInstance1(LOCAL_BANK::STARTING_TREASURY * 0.5, 10, approvingBank.getInterestRate());
+	loan loanInstance2(LOCAL_BANK::STARTING_TREASURY * 0.5, 10, rejectingBank.getInterestRate());
+	approvingBank.loanProcessingMethod(&loanInstance1);
+	rejectingBank.loanProcessingMethod(&loanInstance2);
+	EXPECT_TRUE(loanInstance1.isReadyToBePayed());
+	EXPECT_FALSE(loanInstance2.isReadyToBePayed());
+	EXPECT_DOUBLE_EQ(LOCAL_BANK::STARTING_TREASURY * 0.5, approvingBank.getCurrentTreasury());
+	EXPECT_DOUBLE_EQ(LOCAL_BANK::STARTING_TREASURY, rejectingBank.getCurrentTreasury());
+}
+
+/*!
+ * @brief Batch processing of a policy Local Bank uses its policy instead of the dice rule
+ */
+TEST(LoanPolicyTest, PolicyLocalBankBatch) {
+	centralBank centralBankInstance;
+	policyLocalBank<approveAllPolicy> approvingBank("Approving Local Bank", &centralBankInstance);
+	policyLocalBank<rejectAllPolicy> rejectingBank("Rejecting Local Bank", &centralBankInstance);
+	const int loansAmount {10};
+	std::vector<loan> loans;
+	std::vector<loan*> approvingPtrs;
+	std::vector<loan*> rejectingPtrs;
+	loans.reserve(2 * loansAmount);
+	for (int i = 0; i < loansAmount; i++) {
+		loans.emplace_back(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER, 10, approvingBank.getInterestRate());
+		approvingPtrs.push_back(&loans.back());
+		loans.emplace_back(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER, 10, rejectingBank.getInterestRate());
+		rejectingPtrs.push_back(&loans.back());
+	}
+	localBank& approvingBase = approvingBank;
+	localBank& rejectingBase = rejectingBank;
+	approvingBase.loanProcessingBatch(approvingPtrs);
+	rejectingBase.loanProcessingBatch(rejectingPtrs);
+	for (int i = 0; i < loansAmount; i++) {
+		EXPECT_TRUE(approvingPtrs[i]->isReadyToBePayed());
+		EXPECT_FALSE(rejectingPtrs[i]->isReadyToBePayed());
+	}
+	EXPECT_DOUBLE_EQ(LOCAL_BANK::STARTING_TREASURY - loansAmount * LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER, approvingBank.getCurrentTreasury());
+	EXPECT_DOUBLE_EQ(LOCAL_BANK::STARTING_TREASURY, rejectingBank.getCurrentTreasury());
+	EXPECT_DOUBLE_EQ(loansAmount, rejectingBank.getTotalLoans());
+	EXPECT_DOUBLE_EQ(0, rejectingBank.getTotalValidLoans());
+}
+
+/*!
+ * @brief Creating banks by policy name
+ */
+TEST(LoanPolicyTest, PolicyRegistry) {
+	std::unique_ptr<centralBank> centralBankPtr = loanPolicyRegistry::createCentralBank("default");
+	ASSERT_NE(nullptr, centralBankPtr);
+	for (auto& policyName: loanPolicyRegistry::getLocalBankPolicyNames()) {
+		EXPECT_NE(nullptr, loanPolicyRegistry::createLocalBank(policyName, policyName, centralBankPtr.get()));
+	}
+	EXPECT_EQ(nullptr, loanPolicyRegistry::createLocalBank("no such policy", "Local Bank", centralBankPtr.get()));
+	loanPolicyRegistry::registerLocalBankPolicy<rejectAllPolicy>("rejectAll");
+	std::unique_ptr<localBank> localBankPtr = loanPolicyRegistry::createLocalBank("rejectAll", "Local Bank", centralBankPtr.get());
+	ASSERT_NE(nullptr, localBankPtr);
+	loan loanInstance(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER, 10, localBankPtr->getInterestRate());
+	localBankPtr->loanProcessingMethod(&loanInstance);
+	EXPECT_FALSE(loanInstance.isReadyToBePayed());
+}
+
+/*!
+ * @brief Visiting banks created by policy name with their concrete class
+ */
+TEST(LoanPolicyTest, VisitLocalBankType) {
+	centralBank centralBankInstance;
+	std::unique_ptr<localBank> creditScoringBank = loanPolicyRegistry::createLocalBank("creditScoring", "Local Bank", &centralBankInstance);
+	ASSERT_NE(nullptr, creditScoringBank);
+	int visits {0};
+	loanPolicyRegistry::visitLocalBankType(creditScoringBank.get(), [&visits](auto bankType) {
+		EXPECT_TRUE((std::is_same<loanPolicyRegistry::creditScoringLocalBank, typename decltype(bankType)::type>::value));
+		visits++;
+	});
+	loanPolicyRegistry::registerLocalBankPolicy<rejectAllPolicy>("rejectAll");
+	std::unique_ptr<localBank> rejectingBank = loanPolicyRegistry::createLocalBank("rejectAll", "Local Bank", &centralBankInstance);
+	ASSERT_NE(nullptr, rejectingBank);
+	loanPolicyRegistry::visitLocalBankType(rejectingBank.get(), [&visits](auto bankType) {
+		EXPECT_TRUE((std::is_same<localBank, typename decltype(bankType)::type>::value));
+		visits++;
+	});
+	EXPECT_EQ(2, visits);
+}
+
 //========== CLIENT: client.h; localBank.h; localClient.h ==========
 /*!
  * @brief Local Bank applying to Central Bank for loan
@@ -405,3 +762,998 @@ TEST(ClientTest, LocalClientLoanPayment) {
 			0.0001
 			);
 }
+
+/*!
+ * @brief Local Client paying to Local Bank in epoch settlement mode
+ * 
+ * Treasury should not change until bank::settleEpoch() is called
+ */
+TEST(ClientTest, LocalClientLoanPaymentEpochSettlement) {
+	centralBank centralBankInstance;
+	mockLocalBank mockLocalBankInstance("Local Bank", &centralBankInstance);
+	mockLocalBankInstance.setEpochSettlement(true);
+	localClient localClientInstance("Local Client", &mockLocalBankInstance);
+	EXPECT_CALL(mockLocalBankInstance, loanValidationMethod(testing::_)).Times(1).WillOnce(testing::Return(true));
+	mockLocalBankInstance.loanProcessingMethod(localClientInstance.getLoanPtr());
+	double treasuryBeforePayments = mockLocalBankInstance.getCurrentTreasury();
+	double expectedLocalBankTreasury = treasuryBeforePayments + localClientInstance.getLoanPtr()->getValueLeft();
+	while (localClientInstance.getLoanPtr()->isReadyToBePayed()) {
+		localClientInstance.paymentMethod();
+	}
+	EXPECT_DOUBLE_EQ(treasuryBeforePayments, mockLocalBankInstance.getCurrentTreasury());
+	mockLocalBankInstance.settleEpoch();
+	EXPECT_NEAR(
+			expectedLocalBankTreasury,
+			mockLocalBankInstance.getCurrentTreasury(),
+			0.0001
+			);
+	mockLocalBankInstance.settleEpoch();
+	EXPECT_NEAR(
+			expectedLocalBankTreasury,
+			mockLocalBankInstance.getCurrentTreasury(),
+			0.0001
+			);
+}
+
+/*!
+ * @brief Client loans are priced from the published rate snapshot and keep its version
+ */
+TEST(ClientTest, LocalClientLoanRateVersion) {
+	centralBank centralBankInstance;
+	localBank localBankInstance("Local Bank", &centralBankInstance);
+	std::uint64_t firstVersion = centralBankInstance.getRateVersion();
+	EXPECT_GE(firstVersion, 1);
+	rateSnapshot snapshot = localBankInstance.getRateSnapshot();
+	EXPECT_EQ(firstVersion, snapshot.version);
+	EXPECT_DOUBLE_EQ(localBankInstance.getInterestRate(), snapshot.getRate());
+	localClient firstClient("Local Client 1", &localBankInstance);
+	EXPECT_EQ(firstVersion, firstClient.getLoanPtr()->getRateVersion());
+	EXPECT_DOUBLE_EQ(localBankInstance.getInterestRate(), firstClient.getLoanPtr()->getInterestRate());
+
+	// same rate is not published again, changed rate gets the next version
+	centralBankInstance.withdraw(1);
+	EXPECT_EQ(firstVersion, centralBankInstance.getRateVersion());
+	centralBankInstance.withdraw(centralBankInstance.getCurrentTreasury() * 0.5);
+	EXPECT_EQ(firstVersion + 1, centralBankInstance.getRateVersion());
+	localClient secondClient("Local Client 2", &localBankInstance);
+	EXPECT_EQ(firstVersion + 1, secondClient.getLoanPtr()->getRateVersion());
+	EXPECT_DOUBLE_EQ(localBankInstance.getInterestRate(), secondClient.getLoanPtr()->getInterestRate());
+	EXPECT_NE(firstClient.getLoanPtr()->getInterestRate(), secondClient.getLoanPtr()->getInterestRate());
+	EXPECT_EQ(firstVersion, firstClient.getLoanPtr()->getRateVersion());
+}
+
+/*!
+ * @brief Local Client identified by number renders its name from Local Bank name
+ */
+TEST(ClientTest, NumberedLocalClientName) {
+	centralBank centralBankInstance;
+	localBank localBankInstance("Entity Id Local Bank", &centralBankInstance);
+	localClient numberedClient(7u, &localBankInstance);
+	localClient namedClient("Entity Id Local Client", &localBankInstance);
+	EXPECT_EQ(nameTable::intern("Entity Id Local Bank"), localBankInstance.getId());
+	EXPECT_EQ(7u, numberedClient.getClientNumber());
+	EXPECT_EQ("Entity Id Local Bank-Local Client-7", numberedClient.getName());
+	EXPECT_EQ("Entity Id Local Client", namedClient.getName());
+}
+
+//========== COMPACT: compactBank.h; nameTable.h ==========
+/*!
+ * @brief Interning the same name twice gives the same id
+ */
+TEST(CompactTest, NameTable) {
+	nameTable::entityId id1 = nameTable::intern("Name Table Test 1");
+	nameTable::entityId id2 = nameTable::intern("Name Table Test 2");
+	EXPECT_NE(id1, id2);
+	EXPECT_EQ(id1, nameTable::intern("Name Table Test 1"));
+	EXPECT_EQ("Name Table Test 2", nameTable::getName(id2));
+}
+
+/*!
+ * @brief Compact Local Client paying to compact Local Bank ends with the same treasury as classic one
+ */
+TEST(CompactTest, CompactLocalClientLoanPayment) {
+	centralBank centralBankInstance;
+	localBank localBankInstance("Local Bank", &centralBankInstance);
+	compactCentralBank compactCentralBankInstance;
+	compactLocalBank compactLocalBankInstance("Compact Local Bank", &compactCentralBankInstance);
+	EXPECT_EQ("Compact Local Bank", compactLocalBankInstance.getName());
+	EXPECT_DOUBLE_EQ(localBankInstance.getInterestRate(), compactLocalBankInstance.getInterestRate());
+
+	loan classicLoan(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER * 5, 12, localBankInstance.getInterestRate());
+	compactLocalClient compactLocalClientInstance(nameTable::intern("Compact Local Client"), &compactLocalBankInstance,
+			LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER * 5, 12);
+	classicLoan.setAsReadyForPayment();
+	compactLocalClientInstance.getLoan().setAsReadyForPayment();
+	while (classicLoan.isReadyToBePayed()) {
+		localBankInstance.receivePayment(&classicLoan);
+		classicLoan.payAndUpdate();
+		compactLocalClientInstance.paymentMethod();
+	}
+	EXPECT_FALSE(compactLocalClientInstance.getLoan().isReadyToBePayed());
+	EXPECT_EQ(12u, compactLocalBankInstance.getReceivedInstallments());
+	EXPECT_DOUBLE_EQ(localBankInstance.getCurrentTreasury(), compactLocalBankInstance.getCurrentTreasury());
+}
+
+//========== PROFILING: profiledMutex.h ==========
+/*!
+ * @brief Profiled mutex counts acquisitions and call sites only when profiling is enabled
+ */
+TEST(ProfilingTest, ProfiledMutexStatistics) {
+	profiledMutex mutexInstance("Profiling Test mutex");
+	profiledMutex::setEnabled(false);
+	{
+		profiledLock lock(mutexInstance);
+	}
+	EXPECT_EQ(0u, mutexInstance.getStats().acquisitions);
+	profiledMutex::setEnabled(true);
+	for (int i = 0; i < 3; i++) {
+		profiledLock lock(mutexInstance);
+	}
+	{
+		std::lock_guard<profiledMutex> lock(mutexInstance);
+	}
+	EXPECT_TRUE(mutexInstance.try_lock());
+	mutexInstance.unlock();
+	profiledMutex::setEnabled(false);
+	lockStats stats = mutexInstance.getStats();
+	EXPECT_EQ(5u, stats.acquisitions);
+	EXPECT_EQ(0u, stats.contendedAcquisitions);
+	std::uint64_t histogramSum {0};
+	for (auto bucket: stats.holdHistogram) {
+		histogramSum += bucket;
+	}
+	EXPECT_EQ(5u, histogramSum);
+	ASSERT_NE(nullptr, stats.callSites[0].site);
+	EXPECT_EQ(3u, stats.callSites[0].acquisitions);
+	EXPECT_NE(std::string::npos, std::string(stats.callSites[0].site).find("TestBody"));
+}
+
+/*!
+ * @brief Spans are recorded only when tracing is enabled and are exported as Chrome trace JSON
+ */
+TEST(ProfilingTest, TraceRecorder) {
+	const std::string traceFileName {(std::filesystem::temp_directory_path() / "economy2test_trace.json").string()};
+	traceRecorder::clear();
+	{
+		traceSpan span("disabled span");
+	}
+	EXPECT_EQ(0u, traceRecorder::size());
+	traceRecorder::setEnabled(true);
+	{
+		traceSpan span("enabled span");
+	}
+	centralBank centralBankInstance;
+	loan loanInstance(loanAmount, loanInstalments, loanInterest);
+	centralBankInstance.receivePayment(&loanInstance);
+	traceRecorder::setEnabled(false);
+	EXPECT_LT(2u, traceRecorder::size());
+	ASSERT_TRUE(traceRecorder::writeChromeTrace(traceFileName));
+	std::stringstream traceContent;
+	{
+		std::ifstream traceFile(traceFileName);
+		traceContent << traceFile.rdbuf();
+	}
+	std::remove(traceFileName.c_str());
+	EXPECT_NE(std::string::npos, traceContent.str().find("\"name\":\"enabled span\",\"ph\":\"X\""));
+	EXPECT_NE(std::string::npos, traceContent.str().find("\"name\":\"receivePayment\""));
+	EXPECT_EQ(std::string::npos, traceContent.str().find("disabled span"));
+	traceRecorder::clear();
+}
+
+//========== HEADLESS: loggerClass.h ==========
+/*!
+ * @brief In headless mode nothing is logged or written to console during the whole client life cycle
+ */
+TEST(HeadlessTest, NoPerEventOutput) {
+	std::stringstream capturedOutput;
+	std::streambuf* originalOutput = std::cout.rdbuf(capturedOutput.rdbuf());
+	loggerClass::setHeadless(true);
+	std::uint64_t eventCountBefore = loggerClass::getEventCount();
+	{
+		centralBank centralBankInstance;
+		mockLocalBank mockLocalBankInstance("Headless Local Bank", &centralBankInstance);
+		localClient localClientInstance("Headless Local Client", &mockLocalBankInstance);
+		EXPECT_CALL(mockLocalBankInstance, loanValidationMethod(testing::_)).Times(1).WillOnce(testing::Return(true));
+		mockLocalBankInstance.loanProcessingMethod(localClientInstance.getLoanPtr());
+		while (localClientInstance.getLoanPtr()->isReadyToBePayed()) {
+			localClientInstance.paymentMethod();
+		}
+		localClientInstance.coutEvent("console event");
+		mockLocalBankInstance.setAmountNeededForLoans(LOCAL_BANK::STARTING_TREASURY);
+		mockLocalBankInstance.applyForLoan();
+		while (mockLocalBankInstance.getLoanPtr()->isReadyToBePayed()) {
+			mockLocalBankInstance.paymentMethod();
+		}
+		mockLocalBankInstance.logEndingInfo();
+		centralBankInstance.logEndingInfo();
+	}
+	EXPECT_EQ(eventCountBefore, loggerClass::getEventCount());
+	loggerClass::setHeadless(false);
+	loggerClass::logEvent("headless test finished");
+	std::cout.rdbuf(originalOutput);
+	EXPECT_EQ("", capturedOutput.str());
+	EXPECT_EQ(eventCountBefore + 1, loggerClass::getEventCount());
+}
+
+/*!
+ * @brief Installed logSink receives formatted parts of events, events are still counted without a sink
+ */
+class recordingLogSink : public logSink {
+public:
+	std::vector<std::string> lines;
+
+	void write(const std::string& input) override {
+		this->lines.push_back(input);
+	};
+
+	void writeEntityEvent(const std::string& entityName, const std::string& input) override {
+		this->lines.push_back(entityName + " event: " + input);
+	};
+
+	void writeClientEvent(const std::string& bankName, std::uint32_t clientNumber, const std::string& input) override {
+		this->lines.push_back(bankName + "-Local Client-" + std::to_string(clientNumber) + " event: " + input);
+	};
+};
+
+TEST(LoggerTest, SinkInterface) {
+	recordingLogSink recordingSink;
+	logSink* originalSink = loggerClass::getSink();
+	loggerClass::setSink(&recordingSink);
+	{
+		centralBank centralBankInstance;
+		localBank localBankInstance("Sink Local Bank", &centralBankInstance);
+		localClient localClientInstance(7, &localBankInstance);
+		localClientInstance.logEvent("client event");
+		loggerClass::logEvent("plain event");
+	}
+	loggerClass::setSink(nullptr);
+	std::uint64_t eventCountBefore = loggerClass::getEventCount();
+	loggerClass::logEvent("dropped event");
+	loggerClass::setSink(originalSink);
+
+	EXPECT_EQ(eventCountBefore + 1, loggerClass::getEventCount());
+	EXPECT_NE(recordingSink.lines.end(), std::find(recordingSink.lines.begin(), recordingSink.lines.end(), "Sink Local Bank event: created"));
+	EXPECT_NE(recordingSink.lines.end(), std::find(recordingSink.lines.begin(), recordingSink.lines.end(), "Sink Local Bank-Local Client-7 event: client event"));
+	EXPECT_NE(recordingSink.lines.end(), std::find(recordingSink.lines.begin(), recordingSink.lines.end(), "plain event"));
+	EXPECT_EQ(recordingSink.lines.end(), std::find(recordingSink.lines.begin(), recordingSink.lines.end(), "dropped event"));
+}
+
+//========== SIMULATION ENGINE: simulationEngine.h; timingWheel.h; dice.h ==========
+/*!
+ * @brief Seeded dice give the same rolls, previous generator is restored after dice::threadSeed
+ */
+TEST(SimulationEngineTest, DiceThreadSeed) {
+	dice diceInstance(BANK::DICE_SIZE);
+	std::vector<int> firstRolls(100);
+	std::vector<int> secondRolls(100);
+	{
+		dice::threadSeed seedGuard(7);
+		diceInstance.rollBatch(firstRolls.data(), firstRolls.size());
+	}
+	{
+		dice::threadSeed seedGuard(7);
+		for (auto& roll: secondRolls) {
+			roll = diceInstance.roll();
+		}
+	}
+	EXPECT_EQ(firstRolls, secondRolls);
+	srand(7);
+	int expectedRoll = (rand() % BANK::DICE_SIZE) + 1;
+	srand(7);
+	EXPECT_EQ(expectedRoll, diceInstance.roll());
+}
+
+/*!
+ * @brief Same configuration gives the same result, every created client is accounted for
+ */
+TEST(SimulationEngineTest, DeterministicRun) {
+	loggerClass::setHeadless(true);
+	simulationConfig config;
+	config.seed = 2022;
+	config.clientsAmount = 500;
+	simulationResult firstResult = simulationEngine::create(config)->run();
+	simulationResult secondResult = simulationEngine::create(config)->run();
+	loggerClass::setHeadless(false);
+	EXPECT_EQ(500, firstResult.clients);
+	EXPECT_EQ(500, firstResult.loanApplications);
+	EXPECT_GT(firstResult.clientInstallments, 0);
+	EXPECT_EQ(firstResult.ticks, secondResult.ticks);
+	EXPECT_EQ(firstResult.events(), secondResult.events());
+	EXPECT_DOUBLE_EQ(firstResult.centralBankTreasury, secondResult.centralBankTreasury);
+	EXPECT_DOUBLE_EQ(firstResult.localBanksTreasury, secondResult.localBanksTreasury);
+	config.localBankPolicy = "unknown";
+	EXPECT_EQ(nullptr, simulationEngine::create(config));
+}
+
+/*!
+ * @brief Entries come out exactly in their due tick (also far ones cascaded from higher wheels), in scheduling order
+ */
+TEST(SimulationEngineTest, TimingWheel) {
+	timingWheel<std::uint64_t> wheel;
+	const std::uint64_t farTick {(std::uint64_t {1} << (2 * TIMING_WHEEL::SLOT_BITS)) + 3};
+	std::vector<std::uint64_t> dues {0, 1, 255, 256, 257, 1000, 65535, farTick, farTick, 5, 1000};
+	for (std::size_t i = 0; i < dues.size(); i++) {
+		wheel.schedule(dues[i] * 100 + i, dues[i]);
+	}
+	timingWheel<std::uint64_t>::handle cancelled = wheel.schedule(7, 700);
+	std::uint64_t cancelledValue {0};
+	EXPECT_TRUE(wheel.cancel(cancelled, cancelledValue));
+	EXPECT_EQ(7, cancelledValue);
+	EXPECT_FALSE(wheel.cancel(cancelled, cancelledValue));
+	EXPECT_EQ(dues.size(), wheel.size());
+
+	std::vector<std::uint64_t> due;
+	std::vector<std::uint64_t> returned;
+	while (!wheel.empty()) {
+		std::uint64_t tick = wheel.getCurrentTick();
+		due.clear();
+		wheel.advance(due);
+		for (std::uint64_t value: due) {
+			EXPECT_EQ(tick, value / 100);
+			returned.push_back(value);
+		}
+	}
+	EXPECT_EQ(farTick + 1, wheel.getCurrentTick());
+	std::vector<std::uint64_t> expected;
+	for (std::size_t i = 0; i < dues.size(); i++) {
+		expected.push_back(dues[i] * 100 + i);
+	}
+	std::stable_sort(expected.begin(), expected.end(), [](std::uint64_t first, std::uint64_t second) {
+		return first / 100 < second / 100;
+	});
+	EXPECT_EQ(expected, returned);
+
+	// past ticks are due immediately, freed entries are reused
+	wheel.schedule(1, 0);
+	due.clear();
+	EXPECT_EQ(1, wheel.advance(due));
+	EXPECT_TRUE(wheel.empty());
+}
+
+/*!
+ * @brief Longer installment period stretches the run, the same installments are paid
+ */
+TEST(SimulationEngineTest, InstallmentPeriod) {
+	loggerClass::setHeadless(true);
+	simulationConfig config;
+	config.seed = 2022;
+	config.clientsAmount = 300;
+	config.epochSettlement = false;
+	simulationResult monthlyResult = simulationEngine::create(config)->run();
+	config.installmentPeriod = 3;
+	simulationResult quarterlyResult = simulationEngine::create(config)->run();
+	loggerClass::setHeadless(false);
+	EXPECT_EQ(300, quarterlyResult.clients);
+	EXPECT_GT(quarterlyResult.ticks, monthlyResult.ticks);
+	EXPECT_GT(quarterlyResult.clientInstallments, 0);
+	EXPECT_EQ(0, quarterlyResult.waitingClients);
+}
+
+//========== SCENARIO: economicScenario.h; economicParameters.h ==========
+/*!
+ * @brief Shocks of one tick are folded into one snapshot, older snapshots stay unchanged, malformed lines are rejected
+ */
+TEST(ScenarioTest, ParseAndAdvance) {
+	std::stringstream scenarioText("# comment\n"
+			"20 demand all 400\n"
+			"10 rate central 0.3\n"
+			"20 fail local2 0\n"
+			"20 inject central 1000\n");
+	std::string error;
+	std::unique_ptr<economicScenario> scenario = economicScenario::parse(scenarioText, error);
+	ASSERT_NE(nullptr, scenario);
+	const economicParameters* initialParameters = scenario->getParameters();
+	EXPECT_TRUE(scenario->advance(5).empty());
+	EXPECT_EQ(initialParameters, scenario->getParameters());
+	EXPECT_EQ(1, scenario->advance(10).size());
+	const economicParameters* rateParameters = scenario->getParameters();
+	EXPECT_DOUBLE_EQ(0.3, rateParameters->interestRateOverride);
+	EXPECT_EQ(3, scenario->advance(25).size());
+	EXPECT_TRUE(scenario->isFinished());
+	EXPECT_DOUBLE_EQ(400, scenario->getParameters()->loanValueMultiplier);
+	EXPECT_TRUE(scenario->getParameters()->isLocalBankFailed(1));
+	EXPECT_FALSE(scenario->getParameters()->isLocalBankFailed(0));
+	EXPECT_DOUBLE_EQ(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER, rateParameters->loanValueMultiplier);
+	EXPECT_FALSE(initialParameters->hasInterestRateOverride());
+
+	for (std::string badLine: {"10 rate local1 0.3", "x demand all 2", "10 demand all", "10 fail central 0", "10 grow all 1",
+			"10 delinquency all 1.5", "10 delinquency local1 0.1"}) {
+		std::stringstream badText(badLine);
+		EXPECT_EQ(nullptr, economicScenario::parse(badText, error)) << badLine;
+	}
+}
+
+/*!
+ * @brief Published snapshot changes Central Bank rate and new client loans, failed banks stop creating clients
+ */
+TEST(ScenarioTest, ShocksInEngine) {
+	loggerClass::setHeadless(true);
+	{
+		centralBank centralBankInstance;
+		localBank localBankInstance("Scenario Local Bank", &centralBankInstance);
+		economicParameters shockedParameters;
+		shockedParameters.interestRateOverride = 0.4;
+		shockedParameters.loanValueMultiplier = 1000;
+		centralBankInstance.publishParameters(&shockedParameters);
+		localBankInstance.publishParameters(&shockedParameters);
+		EXPECT_DOUBLE_EQ(0.4, centralBankInstance.getInterestRate());
+		localClient localClientInstance(1, &localBankInstance);
+		EXPECT_EQ(0, static_cast<int>(localClientInstance.getLoanPtr()->getStartingValue()) % 1000);
+		centralBankInstance.publishParameters(economicParameters::defaults());
+		EXPECT_DOUBLE_EQ(CENTRAL_BANK::INTEREST_TO_TREASURY_RATE[1][9], centralBankInstance.getInterestRate());
+	}
+
+	const std::string scenarioFileName {"economy2test_scenario.txt"};
+	{
+		std::ofstream scenarioFile(scenarioFileName);
+		scenarioFile << "5 inject central 5000\n10 rate central 0.2\n20 fail all 0\n";
+	}
+	simulationConfig config;
+	config.seed = 2022;
+	config.clientsAmount = 500;
+	config.scenarioFileName = scenarioFileName;
+	std::unique_ptr<simulationEngine> engine = simulationEngine::create(config);
+	ASSERT_NE(nullptr, engine);
+	simulationResult result = engine->run();
+	EXPECT_EQ(3, result.shocks);
+	EXPECT_LT(result.clients, 500);
+	EXPECT_DOUBLE_EQ(0.2, engine->getCentralBank()->getInterestRate());
+	{
+		std::ofstream scenarioFile(scenarioFileName);
+		scenarioFile << "5 fail local9 0\n";
+	}
+	EXPECT_EQ(nullptr, simulationEngine::create(config));
+	std::remove(scenarioFileName.c_str());
+	loggerClass::setHeadless(false);
+}
+
+/*!
+ * @brief Rate shock reprices running variable-rate loans and leaves fixed-rate loans alone
+ */
+TEST(ScenarioTest, VariableRateLoans) {
+	loggerClass::setHeadless(true);
+	const std::string scenarioFileName {"economy2test_rate_scenario.txt"};
+	{
+		std::ofstream scenarioFile(scenarioFileName);
+		scenarioFile << "3 rate central 0.4\n";
+	}
+	simulationConfig config;
+	config.seed = 2022;
+	config.clientsAmount = 200;
+	config.scenarioFileName = scenarioFileName;
+	config.loanSchedule = "annuity";
+	simulationResult fixedResult = simulationEngine::create(config)->run();
+	config.variableRate = true;
+	simulationResult variableResult = simulationEngine::create(config)->run();
+	EXPECT_EQ(0, fixedResult.loanRepricings);
+	EXPECT_GT(variableResult.loanRepricings, 0);
+	EXPECT_EQ(200, variableResult.clients);
+	config.loanSchedule = "balloon";
+	EXPECT_EQ(nullptr, simulationEngine::create(config));
+	std::remove(scenarioFileName.c_str());
+	loggerClass::setHeadless(false);
+}
+
+/*!
+ * @brief Delinquency shock makes Local Clients miss installments, some loans are written off
+ */
+TEST(ScenarioTest, DelinquencyShock) {
+	loggerClass::setHeadless(true);
+	const std::string scenarioFileName {"economy2test_delinquency_scenario.txt"};
+	{
+		std::ofstream scenarioFile(scenarioFileName);
+		scenarioFile << "0 delinquency all 0.5\n";
+	}
+	simulationConfig config;
+	config.seed = 2022;
+	config.clientsAmount = 300;
+	simulationResult calmResult = simulationEngine::create(config)->run();
+	config.scenarioFileName = scenarioFileName;
+	simulationResult shockedResult = simulationEngine::create(config)->run();
+	EXPECT_EQ(0, calmResult.missedInstallments);
+	EXPECT_EQ(0, calmResult.writtenOffLoans);
+	EXPECT_GT(shockedResult.missedInstallments, 0);
+	EXPECT_GT(shockedResult.writtenOffLoans, 0);
+	std::remove(scenarioFileName.c_str());
+	loggerClass::setHeadless(false);
+}
+
+//========== ARRIVALS: arrivalProcess.h; arrivalQueue.h; arrivalGenerator.h ==========
+/*!
+ * @brief Mean inter-arrival time follows configured rates, trace is replayed in order, bad specs are rejected
+ */
+TEST(ArrivalTest, Processes) {
+	std::unique_ptr<arrivalProcess> poisson = arrivalProcess::create("poisson:1000", 7);
+	ASSERT_NE(nullptr, poisson);
+	double poissonTime {0};
+	for (int i = 0; i < 10'000; i++) {
+		poissonTime = poissonTime + poisson->nextInterarrival();
+	}
+	EXPECT_NEAR(10, poissonTime, 0.5);
+
+	std::unique_ptr<arrivalProcess> mmpp = arrivalProcess::create("mmpp:100:10000:0.1", 7);
+	ASSERT_NE(nullptr, mmpp);
+	double mmppTime {0};
+	for (int i = 0; i < 10'000; i++) {
+		mmppTime = mmppTime + mmpp->nextInterarrival();
+	}
+	EXPECT_GT(mmppTime, 10'000 / 10'000.0);
+	EXPECT_LT(mmppTime, 10'000 / 100.0);
+
+	const std::string traceFileName {"economy2test_arrivals.txt"};
+	{
+		std::ofstream traceFile(traceFileName);
+		traceFile << "# arrival times\n0.5\n0.25\n1\n";
+	}
+	std::unique_ptr<arrivalProcess> trace = arrivalProcess::create("trace:" + traceFileName);
+	std::remove(traceFileName.c_str());
+	ASSERT_NE(nullptr, trace);
+	EXPECT_DOUBLE_EQ(0.25, trace->nextInterarrival());
+	EXPECT_DOUBLE_EQ(0.25, trace->nextInterarrival());
+	EXPECT_DOUBLE_EQ(0.5, trace->nextInterarrival());
+	EXPECT_LT(trace->nextInterarrival(), 0);
+
+	for (std::string badSpec: {"", "poisson", "poisson:-1", "poisson:1x", "mmpp:1:2", "trace:missing_file.txt", "uniform:5"}) {
+		EXPECT_EQ(nullptr, arrivalProcess::create(badSpec)) << badSpec;
+	}
+}
+
+/*!
+ * @brief Full queue drops arrivals without blocking, closed queue drains, generator closes the queue at the end
+ */
+TEST(ArrivalTest, BoundedQueue) {
+	arrivalQueue queueInstance(2);
+	auto now = std::chrono::steady_clock::now();
+	EXPECT_TRUE(queueInstance.tryPush({0, now}));
+	EXPECT_TRUE(queueInstance.tryPush({1, now}));
+	EXPECT_FALSE(queueInstance.tryPush({2, now}));
+	EXPECT_EQ(2, queueInstance.getPushed());
+	EXPECT_EQ(1, queueInstance.getDropped());
+	EXPECT_EQ(2, queueInstance.getMaxDepth());
+	EXPECT_DOUBLE_EQ(1.5, queueInstance.getAverageDepth());
+	clientArrival arrival {};
+	EXPECT_TRUE(queueInstance.pop(arrival, std::chrono::milliseconds(0)));
+	EXPECT_EQ(0, arrival.clientNumber);
+	queueInstance.close();
+	EXPECT_FALSE(queueInstance.tryPush({3, now}));
+	EXPECT_FALSE(queueInstance.isDrained());
+	EXPECT_TRUE(queueInstance.pop(arrival, std::chrono::milliseconds(0)));
+	EXPECT_EQ(1, arrival.clientNumber);
+	EXPECT_FALSE(queueInstance.pop(arrival, std::chrono::milliseconds(1)));
+	EXPECT_TRUE(queueInstance.isDrained());
+	EXPECT_EQ(2, queueInstance.getQueueWait().getSamples());
+
+	arrivalQueue generatedQueue(1000);
+	{
+		arrivalGenerator generator(arrivalProcess::create("poisson:100000"), &generatedQueue, 100);
+		std::uint32_t popped {0};
+		while (!generatedQueue.isDrained()) {
+			if (generatedQueue.pop(arrival, std::chrono::milliseconds(10))) {
+				EXPECT_EQ(popped, arrival.clientNumber);
+				popped++;
+			}
+		}
+		EXPECT_TRUE(generator.isFinished());
+		EXPECT_EQ(100, generator.getGenerated());
+		EXPECT_EQ(100, popped);
+	}
+	EXPECT_GE(generatedQueue.getQueueWait().getQuantileNs(0.99), generatedQueue.getQueueWait().getQuantileNs(0.5));
+	EXPECT_LE(generatedQueue.getQueueWait().getQuantileNs(1), generatedQueue.getQueueWait().getMaxNs());
+}
+
+/*!
+ * @brief Full queue rejects new arrival, sheds the oldest one or waits for room depending on admissionPolicy
+ */
+TEST(ArrivalTest, AdmissionPolicies) {
+	admissionPolicy policy {admissionPolicy::REJECT};
+	EXPECT_TRUE(arrivalQueue::parsePolicy("shed", policy));
+	EXPECT_EQ(admissionPolicy::SHED, policy);
+	EXPECT_FALSE(arrivalQueue::parsePolicy("drop", policy));
+	EXPECT_EQ(admissionPolicy::SHED, policy);
+
+	auto now = std::chrono::steady_clock::now();
+	clientArrival arrival {};
+	arrivalQueue rejectQueue(2, admissionPolicy::REJECT);
+	EXPECT_EQ(admissionResult::ADMITTED, rejectQueue.push({0, now}, std::chrono::milliseconds(0)));
+	EXPECT_EQ(admissionResult::ADMITTED, rejectQueue.push({1, now}, std::chrono::milliseconds(0)));
+	EXPECT_EQ(admissionResult::REJECTED, rejectQueue.push({2, now}, std::chrono::milliseconds(0)));
+	EXPECT_EQ(2, rejectQueue.getPushed());
+	EXPECT_EQ(1, rejectQueue.getDropped());
+	EXPECT_EQ(0, rejectQueue.getShed());
+	EXPECT_TRUE(rejectQueue.pop(arrival, std::chrono::milliseconds(0)));
+	EXPECT_EQ(0, arrival.clientNumber);
+
+	arrivalQueue shedQueue(2, admissionPolicy::SHED);
+	EXPECT_EQ(admissionResult::ADMITTED, shedQueue.push({0, now}, std::chrono::milliseconds(0)));
+	EXPECT_EQ(admissionResult::ADMITTED, shedQueue.push({1, now}, std::chrono::milliseconds(0)));
+	EXPECT_EQ(admissionResult::ADMITTED_SHEDDING, shedQueue.push({2, now}, std::chrono::milliseconds(0)));
+	EXPECT_EQ(3, shedQueue.getPushed());
+	EXPECT_EQ(0, shedQueue.getDropped());
+	EXPECT_EQ(1, shedQueue.getShed());
+	EXPECT_EQ(2, shedQueue.getDepth());
+	EXPECT_TRUE(shedQueue.pop(arrival, std::chrono::milliseconds(0)));
+	EXPECT_EQ(1, arrival.clientNumber);
+
+	arrivalQueue waitQueue(1, admissionPolicy::WAIT);
+	EXPECT_EQ(admissionResult::ADMITTED, waitQueue.push({0, now}, std::chrono::milliseconds(0)));
+	EXPECT_EQ(admissionResult::REJECTED, waitQueue.push({1, now}, std::chrono::milliseconds(1)));
+	std::thread consumer([&waitQueue]() {
+		clientArrival consumed {};
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		waitQueue.pop(consumed, std::chrono::milliseconds(0));
+	});
+	EXPECT_EQ(admissionResult::ADMITTED, waitQueue.push({2, now}, std::chrono::seconds(10)));
+	consumer.join();
+	EXPECT_GE(waitQueue.getWaited(), 1);
+	EXPECT_EQ(1, waitQueue.getDropped());
+	waitQueue.close();
+	EXPECT_EQ(admissionResult::REJECTED, waitQueue.push({3, now}, std::chrono::seconds(10)));
+	EXPECT_TRUE(waitQueue.pop(arrival, std::chrono::milliseconds(0)));
+	EXPECT_EQ(2, arrival.clientNumber);
+
+	latencyHistogram merged;
+	merged.merge(rejectQueue.getQueueWait());
+	merged.merge(shedQueue.getQueueWait());
+	EXPECT_EQ(2, merged.getSamples());
+}
+
+//========== REPLAY: applicationTrace.h; dice.h ==========
+/*!
+ * @brief Replaying tape gives recorded rolls, rolls beyond the tape are counted as misses
+ */
+TEST(ReplayTest, DiceTape) {
+	dice diceInstance(BANK::DICE_SIZE);
+	std::vector<int> recordedRolls(50);
+	std::vector<std::uint8_t> tapeRolls;
+	{
+		dice::tape recordTape;
+		diceInstance.rollBatch(recordedRolls.data(), recordedRolls.size());
+		tapeRolls = recordTape.getRecorded();
+	}
+	ASSERT_EQ(recordedRolls.size(), tapeRolls.size());
+	dice::tape replayTape(tapeRolls.data(), tapeRolls.size());
+	for (std::size_t i = 0; i < recordedRolls.size(); i++) {
+		EXPECT_EQ(recordedRolls[i], diceInstance.roll());
+	}
+	EXPECT_EQ(0, replayTape.getUnused());
+	EXPECT_EQ(0, replayTape.getMisses());
+	int extraRoll = diceInstance.roll();
+	EXPECT_GE(extraRoll, 1);
+	EXPECT_LE(extraRoll, BANK::DICE_SIZE);
+	EXPECT_EQ(1, replayTape.getMisses());
+}
+
+/*!
+ * @brief Engine run recorded to a trace file and replayed from it gives the same result without missing rolls
+ */
+TEST(ReplayTest, RecordAndReplay) {
+	loggerClass::setHeadless(true);
+	const std::string traceFileName {"economy2test_applications.bin"};
+	simulationConfig config;
+	config.seed = 2022;
+	config.clientsAmount = 300;
+	applicationTrace recordedTrace;
+	std::unique_ptr<simulationEngine> recordingEngine = simulationEngine::create(config);
+	recordingEngine->setRecordingTrace(&recordedTrace);
+	simulationResult recordedResult = recordingEngine->run();
+	ASSERT_EQ(300, recordedTrace.getRecords().size());
+	ASSERT_TRUE(recordedTrace.write(traceFileName));
+
+	applicationTrace readTrace;
+	ASSERT_TRUE(readTrace.read(traceFileName));
+	ASSERT_EQ(recordedTrace.getRecords().size(), readTrace.getRecords().size());
+	for (std::size_t i = 0; i < readTrace.getRecords().size(); i++) {
+		EXPECT_EQ(recordedTrace.getRecords()[i].localBankIndex, readTrace.getRecords()[i].localBankIndex);
+		EXPECT_EQ(recordedTrace.getRecords()[i].clientNumber, readTrace.getRecords()[i].clientNumber);
+		EXPECT_EQ(recordedTrace.getRecords()[i].rolls, readTrace.getRecords()[i].rolls);
+	}
+	EXPECT_EQ(config.localBanksAmount, readTrace.getLocalBanksAmount());
+
+	// replay does not depend on the seed, all rolls come from the trace
+	simulationConfig replayConfig;
+	replayConfig.seed = 1;
+	replayConfig.replayFileName = traceFileName;
+	simulationResult replayedResult = simulationEngine::create(replayConfig)->run();
+	EXPECT_EQ(0, replayedResult.replayMisses);
+	EXPECT_EQ(recordedResult.clients, replayedResult.clients);
+	EXPECT_EQ(recordedResult.ticks, replayedResult.ticks);
+	EXPECT_EQ(recordedResult.events(), replayedResult.events());
+	EXPECT_DOUBLE_EQ(recordedResult.centralBankTreasury, replayedResult.centralBankTreasury);
+	EXPECT_DOUBLE_EQ(recordedResult.localBanksTreasury, replayedResult.localBanksTreasury);
+
+	{
+		std::ofstream traceFile(traceFileName, std::ios::binary | std::ios::trunc);
+		traceFile << "not a trace";
+	}
+	EXPECT_FALSE(readTrace.read(traceFileName));
+	EXPECT_EQ(nullptr, simulationEngine::create(replayConfig));
+	std::remove(traceFileName.c_str());
+	loggerClass::setHeadless(false);
+}
+
+//========== ENSEMBLE: runningStatistics.h; simulationEnsemble.h ==========
+/*!
+ * @brief Merged statistics equal statistics of all samples, sketch quantiles stay close to exact ones
+ */
+TEST(EnsembleTest, StreamingStatistics) {
+	runningStatistics allSamples;
+	runningStatistics firstHalf;
+	runningStatistics secondHalf;
+	quantileSketch firstSketch(64);
+	quantileSketch secondSketch(64);
+	std::vector<double> samples;
+	for (int i = 0; i < 10'000; i++) {
+		double value = (i * 7919) % 10'000;
+		samples.push_back(value);
+		allSamples.add(value);
+		(i % 3 == 0 ? firstHalf : secondHalf).add(value);
+		(i % 3 == 0 ? firstSketch : secondSketch).add(value);
+	}
+	firstHalf.merge(secondHalf);
+	firstSketch.merge(secondSketch);
+	EXPECT_EQ(10'000, firstHalf.getCount());
+	EXPECT_NEAR(4999.5, firstHalf.getMean(), 1e-6);
+	EXPECT_NEAR(allSamples.getVariance(), firstHalf.getVariance(), 1e-6 * allSamples.getVariance());
+	EXPECT_DOUBLE_EQ(0, firstHalf.getMin());
+	EXPECT_DOUBLE_EQ(9999, firstHalf.getMax());
+	EXPECT_GT(firstHalf.getConfidenceHalfWidth(), 0);
+	EXPECT_EQ(10'000, firstSketch.getCount());
+	EXPECT_LT(firstSketch.getRetained(), 1'000);
+	for (double fraction: {0.05, 0.5, 0.95}) {
+		EXPECT_NEAR(fraction * 10'000, firstSketch.getQuantile(fraction), 300);
+	}
+	quantileSketch exactSketch;
+	for (double value: {3.0, 1.0, 2.0}) {
+		exactSketch.add(value);
+	}
+	EXPECT_DOUBLE_EQ(1, exactSketch.getQuantile(0));
+	EXPECT_DOUBLE_EQ(2, exactSketch.getQuantile(0.5));
+	EXPECT_DOUBLE_EQ(3, exactSketch.getQuantile(1));
+}
+
+/*!
+ * @brief Ensemble on many threads gives the same moments as on one thread, every run is counted
+ */
+TEST(EnsembleTest, ParallelRuns) {
+	loggerClass::setHeadless(true);
+	ensembleConfig config;
+	config.simulation.clientsAmount = 200;
+	config.runs = 16;
+	config.threads = 1;
+	std::unique_ptr<ensembleResult> sequential = simulationEnsemble::run(config);
+	config.threads = 4;
+	std::unique_ptr<ensembleResult> parallel = simulationEnsemble::run(config);
+	ASSERT_NE(nullptr, sequential);
+	ASSERT_NE(nullptr, parallel);
+	EXPECT_EQ(16, sequential->runs);
+	EXPECT_EQ(16, parallel->runs);
+	EXPECT_EQ(sequential->events, parallel->events);
+	EXPECT_NEAR(sequential->loanValidationRate.moments.getMean(), parallel->loanValidationRate.moments.getMean(), 1e-9);
+	EXPECT_NEAR(sequential->centralBankTreasuryRate.moments.getVariance(),
+			parallel->centralBankTreasuryRate.moments.getVariance(), 1e-9);
+	EXPECT_GT(sequential->loanValidationRate.moments.getMean(), 0);
+	EXPECT_LE(sequential->loanValidationRate.moments.getMax(), 1);
+	config.simulation.localBankPolicy = "unknown";
+	EXPECT_EQ(nullptr, simulationEnsemble::run(config));
+	loggerClass::setHeadless(false);
+}
+
+//========== ROUTING: clientRouter.h ==========
+/*!
+ * @brief All policies route to existing open banks, hash is consistent, rate prefers banks not paying their loan
+ */
+TEST(RoutingTest, ClientRouterPolicies) {
+	loggerClass::setHeadless(true);
+	centralBank centralBankInstance;
+	std::vector<std::unique_ptr<localBank>> localBanks;
+	std::vector<localBank*> localBankPtrs;
+	for (int i = 0; i < 40; i++) {
+		localBanks.emplace_back(new localBank("Routed Local Bank " + std::to_string(i), &centralBankInstance));
+		localBankPtrs.push_back(localBanks.back().get());
+	}
+	EXPECT_EQ(nullptr, clientRouter::create("unknown", localBankPtrs));
+	EXPECT_EQ(nullptr, clientRouter::create("hash", {}));
+
+	// adding buckets moves only keys which go to the new bucket
+	int moved {0};
+	for (std::uint32_t key = 0; key < 10'000; key++) {
+		std::uint32_t bucket = clientRouter::jumpHash(key, 40);
+		EXPECT_LT(bucket, 40);
+		std::uint32_t grownBucket = clientRouter::jumpHash(key, 41);
+		EXPECT_TRUE(grownBucket == bucket || grownBucket == 40);
+		moved = moved + (grownBucket != bucket);
+	}
+	EXPECT_LT(moved, 10'000 / 41 * 2);
+
+	economicParameters failedParameters;
+	failedParameters.failedLocalBanks.assign(40, false);
+	for (int i = 0; i < 20; i++) {
+		failedParameters.failedLocalBanks[i] = true;
+	}
+	for (std::string policyName: {"region", "rate", "hash"}) {
+		std::unique_ptr<clientRouter> router = clientRouter::create(policyName, localBankPtrs);
+		ASSERT_NE(nullptr, router);
+		std::vector<int> clients(40, 0);
+		for (std::uint32_t clientNumber = 0; clientNumber < 4'000; clientNumber++) {
+			std::uint32_t index = router->route(clientNumber);
+			ASSERT_LT(index, 40);
+			EXPECT_EQ(index, router->route(clientNumber));
+			clients[index]++;
+		}
+		EXPECT_GT(std::count_if(clients.begin(), clients.end(), [](int amount) { return amount > 0; }), 30) << policyName;
+		router->refresh(failedParameters);
+		for (std::uint32_t clientNumber = 0; clientNumber < 4'000; clientNumber++) {
+			EXPECT_GE(router->route(clientNumber), 20) << policyName;
+		}
+		// scattered failures, every client still goes to an open bank
+		economicParameters scatteredParameters;
+		scatteredParameters.failedLocalBanks.assign(40, false);
+		for (int i = 0; i < 40; i += 3) {
+			scatteredParameters.failedLocalBanks[i] = true;
+		}
+		router->refresh(scatteredParameters);
+		for (std::uint32_t clientNumber = 0; clientNumber < 4'000; clientNumber++) {
+			EXPECT_NE(0, router->route(clientNumber) % 3) << policyName;
+		}
+		failedParameters.allLocalBanksFailed = true;
+		router->refresh(failedParameters);
+		EXPECT_EQ(clientRouter::NO_BANK, router->route(1)) << policyName;
+		failedParameters.allLocalBanksFailed = false;
+	}
+
+	// bank paying its own Central Bank loan does not get clients of rate policy
+	std::unique_ptr<clientRouter> rateRouter = clientRouter::create("rate", {localBankPtrs[0], localBankPtrs[1]});
+	localBankPtrs[0]->setAmountNeededForLoans(CENTRAL_BANK::STARTING_TREASURY * 0.01);
+	localBankPtrs[0]->generateLoan();
+	centralBankInstance.loanProcessingMethod(localBankPtrs[0]->getLoanPtr());
+	ASSERT_TRUE(localBankPtrs[0]->isPayingLoan());
+	rateRouter->refresh(*economicParameters::defaults());
+	for (std::uint32_t clientNumber = 0; clientNumber < 10; clientNumber++) {
+		EXPECT_EQ(1, rateRouter->route(clientNumber));
+	}
+	EXPECT_DOUBLE_EQ(localBankPtrs[1]->getInterestRate(), rateRouter->getCachedRate(1));
+
+	simulationConfig config;
+	config.clientsAmount = 500;
+	config.localBanksAmount = 50;
+	config.routingPolicy = "hash";
+	simulationResult result = simulationEngine::create(config)->run();
+	EXPECT_EQ(500, result.clients);
+	config.routingPolicy = "unknown";
+	EXPECT_EQ(nullptr, simulationEngine::create(config));
+	loggerClass::setHeadless(false);
+}
+
+//========== LEDGER: ledger.h; ledgerAuditor.h ==========
+/*!
+ * @brief Ledger follows treasuries through loans, installments and epoch settlement, payment without payer leg is detected
+ */
+TEST(LedgerTest, DoubleEntryBalance) {
+	ledger::setEnabled(true);
+	{
+		centralBank centralBankInstance;
+		mockLocalBank mockLocalBankInstance("Ledger Local Bank", &centralBankInstance);
+		localClient localClientInstance("Ledger Local Client", &mockLocalBankInstance);
+		EXPECT_CALL(mockLocalBankInstance, loanValidationMethod(testing::_)).Times(1).WillOnce(testing::Return(true));
+		mockLocalBankInstance.loanProcessingMethod(localClientInstance.getLoanPtr());
+		mockLocalBankInstance.setEpochSettlement(true);
+		for (int i = 0; i < 3 && localClientInstance.getLoanPtr()->isReadyToBePayed(); i++) {
+			localClientInstance.paymentMethod();
+		}
+		mockLocalBankInstance.setAmountNeededForLoans(LOCAL_BANK::STARTING_TREASURY);
+		mockLocalBankInstance.applyForLoan();
+		while (mockLocalBankInstance.isPayingLoan()) {
+			mockLocalBankInstance.paymentMethod();
+		}
+		mockLocalBankInstance.setEpochSettlement(false);
+		mockLocalBankInstance.withdraw(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER);
+		{
+			ledgerAuditor auditor({&mockLocalBankInstance, &centralBankInstance}, std::chrono::milliseconds(1));
+			EXPECT_EQ(0, auditor.auditPass());
+			EXPECT_EQ(0, auditor.getFailures());
+		}
+		EXPECT_TRUE(ledger::isBalanced());
+		loan unpaidLoan(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER, 10, 0.1);
+		centralBankInstance.receivePayment(&unpaidLoan);
+		EXPECT_TRUE(centralBankInstance.auditLedger());
+		EXPECT_FALSE(ledger::isBalanced());
+		ledger::post(ledger::EXTERNAL, -unpaidLoan.getSingleInstallmentValue());
+		ledger::collect();
+		EXPECT_TRUE(ledger::isBalanced());
+	}
+	ledger::setEnabled(false);
+}
+
+/*!
+ * @brief Postings of exited threads are collected and their journals are freed afterwards
+ */
+TEST(LedgerTest, ExitedThreadJournals) {
+	ledger::setEnabled(true);
+	ledger::collect();
+	std::size_t journalsBefore = ledger::getJournalsAmount();
+	ledger::accountId account = ledger::openAccount();
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; i++) {
+		threads.emplace_back([account]() {
+			for (std::size_t j = 0; j < LEDGER::CHUNK_SIZE + 1; j++) {
+				ledger::transfer(ledger::EXTERNAL, account, 1);
+			}
+		});
+	}
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	EXPECT_EQ(journalsBefore + 4, ledger::getJournalsAmount());
+	EXPECT_EQ(8 * (LEDGER::CHUNK_SIZE + 1), ledger::collect());
+	EXPECT_EQ(journalsBefore, ledger::getJournalsAmount());
+	EXPECT_DOUBLE_EQ(4.0 * (LEDGER::CHUNK_SIZE + 1), ledger::getBalance(account));
+	EXPECT_TRUE(ledger::isBalanced());
+	ledger::setEnabled(false);
+}
+
+//========== NUMA: numaTopology.h; loanArena.h ==========
+/*!
+ * @brief Local Banks are split into contiguous blocks covering all nodes, pinning is remembered per thread
+ */
+TEST(NumaTest, TopologyAndPinning) {
+	int nodesAmount = numaTopology::getNodesAmount();
+	ASSERT_GE(nodesAmount, 1);
+	for (int node = 0; node < nodesAmount; node++) {
+		EXPECT_FALSE(numaTopology::getNodeCpus(node).empty());
+	}
+	EXPECT_EQ(0, numaTopology::nodeOfLocalBank(0, 1000));
+	EXPECT_EQ(nodesAmount - 1, numaTopology::nodeOfLocalBank(999, 1000));
+	for (std::size_t i = 1; i < 1000; i++) {
+		EXPECT_LE(numaTopology::nodeOfLocalBank(i - 1, 1000), numaTopology::nodeOfLocalBank(i, 1000));
+	}
+	std::thread pinnedThread([nodesAmount]() {
+		EXPECT_EQ(-1, numaTopology::getPinnedNode());
+		if (numaTopology::pinCurrentThread(nodesAmount - 1)) {
+			EXPECT_EQ(nodesAmount - 1, numaTopology::getPinnedNode());
+			EXPECT_TRUE(numaTopology::pinCurrentThread(-1));
+			EXPECT_EQ(-1, numaTopology::getPinnedNode());
+		}
+	});
+	pinnedThread.join();
+}
+
+/*!
+ * @brief Loans of a placed Local Bank live in its arena, released blocks are reused, clients pay as usual
+ */
+TEST(NumaTest, LoanArena) {
+	{
+		loanArena arena(0);
+		std::vector<loan*> loanPtrs;
+		for (std::size_t i = 0; i <= NUMA::ARENA_CHUNK_LOANS; i++) {
+			loanPtrs.push_back(arena.create(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER, 10, 0.1));
+			EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(loanPtrs.back()) % NUMA::ARENA_BLOCK_ALIGNMENT);
+		}
+		EXPECT_EQ(2, arena.getChunksAmount());
+		EXPECT_EQ(NUMA::ARENA_CHUNK_LOANS + 1, arena.getUsedBlocks());
+		loan* releasedPtr = loanPtrs.back();
+		arena.destroy(releasedPtr);
+		loanPtrs.pop_back();
+		EXPECT_EQ(releasedPtr, arena.create(LOCAL_CLIENT::LOAN_VALUE_MULTIPLIER, 10, 0.1));
+		loanPtrs.push_back(releasedPtr);
+		for (auto loanPtr: loanPtrs) {
+			arena.destroy(loanPtr);
+		}
+		EXPECT_EQ(0, arena.getUsedBlocks());
+		EXPECT_EQ(2, arena.getChunksAmount());
+	}
+
+	centralBank centralBankInstance;
+	localBank localBankInstance("NUMA Local Bank", &centralBankInstance);
+	EXPECT_EQ(nullptr, localBankInstance.getLoanArena());
+	localBankInstance.setNumaNode(numaTopology::getNodesAmount() - 1);
+	ASSERT_NE(nullptr, localBankInstance.getLoanArena());
+	{
+		localClient localClientInstance(1, &localBankInstance);
+		EXPECT_EQ(1, localBankInstance.getLoanArena()->getUsedBlocks());
+		localBankInstance.loanProcessingMethod(localClientInstance.getLoanPtr());
+		while (localClientInstance.getLoanPtr()->isReadyToBePayed()) {
+			localClientInstance.paymentMethod();
+		}
+	}
+	EXPECT_EQ(0, localBankInstance.getLoanArena()->getUsedBlocks());
+}
@@ -0,0 +1,251 @@
+/*
+ * @brief Concurrent stress test of the banking library
+ *
+ * N threads perform random mix of operations on shared banks: creating Local Clients and processing
+ * their loans one by one (localBank::loanProcessingMethod, which may call centralBank::loanProcessingMethod)
+ * or in batches (localBank::loanProcessingBatch), paying installments (bank::receivePayment), paying
+ * Local Bank loans and settling epochs. Clients whose loans wait too long for Central Bank money resign
+ * (localBank::cancelWaitingLoan). Every thread owns its clients and the Local Banks with index
+ * equal to thread index modulo N pay their Central Bank loans only from that thread, like in economy2.
+ *
+ * At the end all loans are paid or cancelled (remaining Local Bank loans after all threads are joined)
+ * and money conservation is checked:
+ * sum of treasuries == sum of starting treasuries - granted client loans + client installments
+ * (Local Bank <-> Central Bank transfers cancel out). Throughput is reported per thread count.
+ * Audited runs additionally keep the double-entry ledger verified by ledgerAuditor during the run.
+ * Usage: economy2stress [max threads] [operations per thread]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "banking/centralBank.h"
+#include "banking/dice.h"
+#include "banking/ledger.h"
+#include "banking/ledgerAuditor.h"
+#include "banking/localBank.h"
+#include "banking/localClient.h"
+#include "banking/loanPolicyRegistry.h"
+#include "banking/profiledMutex.h"
+#include "../constants.h"
+
+const int STRESS_LOCAL_BANKS {4}; ///< Number of Local Banks shared by all threads
+const int DEFAULT_MAX_THREADS {8}; ///< Thread counts 1, 2, 4 ... up to this value are tested
+const int DEFAULT_OPERATIONS {20'000}; ///< Operations performed by every thread
+const int MAX_BATCH_SIZE {8}; ///< Maximal size of a single loanProcessingBatch() call
+const int MAX_WAITING_ROUNDS {8}; ///< Payment rounds after which client with waiting loan resigns
+const std::chrono::milliseconds STRESS_AUDIT_INTERVAL {1}; ///< Interval of ledgerAuditor in audited runs
+const double MONEY_TOLERANCE {1e-6}; ///< Allowed relative difference in money conservation check
+
+/*!
+ * @brief Shared state of a single stress run
+ */
+struct stressBanks {
+	std::unique_ptr<centralBank> centralBankInstance;
+	std::vector<std::unique_ptr<localBank>> localBanks;
+};
+
+/*!
+ * @brief Money which entered or left the banks, counted by a single thread
+ */
+struct moneyFlow {
+	double grantedClientLoans {0}; ///< Sum of starting values of client loans which became ready
+	double clientInstallments {0}; ///< Sum of installments paid by clients
+	std::uint64_t operations {0}; ///< Number of performed operations
+};
+
+/*!
+ * @brief Client owned by a single thread
+ */
+struct ownedClient {
+	std::unique_ptr<localClient> client;
+	localBank* localBankPtr;
+	bool granted; ///< Loan was seen as ready and counted in moneyFlow::grantedClientLoans
+	int waitingRounds; ///< Payment rounds spent waiting for the loan
+};
+
+/*!
+ * @brief Registers granted loan in **flow**, returns true while client still has something to do
+ *
+ * Waiting loan is granted under bank::bankMTX before it is removed from localBank.waitingLoans,
+ * so readiness is checked again after the loan is seen as not waiting.
+ */
+bool refreshClient(ownedClient& owned, moneyFlow& flow) {
+	loan* loanPtr = owned.client->getLoanPtr();
+	if (!owned.granted && !loanPtr->isReadyToBePayed() && owned.localBankPtr->isLoanWaiting(loanPtr)) {
+		return true;
+	}
+	if (!owned.granted && loanPtr->isReadyToBePayed()) {
+		owned.granted = true;
+		flow.grantedClientLoans = flow.grantedClientLoans + loanPtr->getStartingValue();
+	}
+	return owned.granted && loanPtr->isReadyToBePayed();
+}
+
+void payInstallment(ownedClient& owned, moneyFlow& flow) {
+	flow.clientInstallments = flow.clientInstallments + owned.client->getLoanPtr()->getSingleInstallmentValue();
+	owned.client->paymentMethod();
+}
+
+void runThread(stressBanks& banks, int threadIndex, int threadsAmount, int operationsAmount, moneyFlow& flow) {
+	dice::threadSeed seedGuard(static_cast<unsigned>(threadIndex) + 1);
+	std::minstd_rand random(static_cast<unsigned>(threadIndex) * 7919 + 1);
+	std::vector<ownedClient> clients;
+	std::uint32_t clientNumber {static_cast<std::uint32_t>(threadIndex) << 24};
+	for (int operation = 0; operation < operationsAmount; operation++) {
+		localBank* localBankPtr = banks.localBanks[random() % banks.localBanks.size()].get();
+		switch (random() % 6) {
+		case 0: {
+			clients.push_back({std::unique_ptr<localClient>(new localClient(clientNumber++, localBankPtr)), localBankPtr, false, 0});
+			localBankPtr->loanProcessingMethod(clients.back().client->getLoanPtr());
+			break;
+		}
+		case 1: {
+			std::vector<loan*> loanPtrs;
+			int batchSize = 1 + static_cast<int>(random() % MAX_BATCH_SIZE);
+			for (int i = 0; i < batchSize; i++) {
+				clients.push_back({std::unique_ptr<localClient>(new localClient(clientNumber++, localBankPtr)), localBankPtr, false, 0});
+				loanPtrs.push_back(clients.back().client->getLoanPtr());
+			}
+			localBankPtr->loanProcessingBatch(loanPtrs);
+			break;
+		}
+		case 2:
+		case 3: {
+			// every granted client pays one installment, finished, rejected and resigned clients are removed
+			clients.erase(std::remove_if(clients.begin(), clients.end(), [&flow](ownedClient& owned) {
+				if (refreshClient(owned, flow) && owned.granted) {
+					payInstallment(owned, flow);
+				} else if (!owned.granted && ++owned.waitingRounds > MAX_WAITING_ROUNDS
+						&& owned.localBankPtr->cancelWaitingLoan(owned.client->getLoanPtr())) {
+					return true;
+				}
+				return !refreshClient(owned, flow);
+			}), clients.end());
+			break;
+		}
+		case 4: {
+			for (std::size_t i = threadIndex; i < banks.localBanks.size(); i += threadsAmount) {
+				banks.localBanks[i]->paymentMethod();
+			}
+			break;
+		}
+		default: {
+			localBankPtr->settleEpoch();
+			banks.centralBankInstance->settleEpoch();
+			std::this_thread::yield();
+			break;
+		}
+		}
+		flow.operations++;
+	}
+	// finishing: waiting loans are cancelled (or granted in the meantime), granted loans are paid
+	for (auto& owned: clients) {
+		if (!owned.granted && owned.localBankPtr->cancelWaitingLoan(owned.client->getLoanPtr())) {
+			continue;
+		}
+		refreshClient(owned, flow);
+		while (owned.granted && owned.client->getLoanPtr()->isReadyToBePayed()) {
+			payInstallment(owned, flow);
+		}
+	}
+}
+
+/*!
+ * @brief Running **threadsAmount** threads and checking money conservation, returns false on violation
+ */
+bool runStress(int threadsAmount, int operationsAmount, bool epochSettlement, bool audited) {
+	ledger::setEnabled(audited);
+	stressBanks banks;
+	banks.centralBankInstance = loanPolicyRegistry::createCentralBank("default");
+	banks.centralBankInstance->setEpochSettlement(epochSettlement);
+	for (int i = 0; i < STRESS_LOCAL_BANKS; i++) {
+		banks.localBanks.push_back(loanPolicyRegistry::createLocalBank("default", "Stress Local Bank " + std::to_string(i),
+				banks.centralBankInstance.get()));
+		banks.localBanks.back()->setEpochSettlement(epochSettlement);
+	}
+	double startingMoney = banks.centralBankInstance->getCurrentTreasury() + STRESS_LOCAL_BANKS * LOCAL_BANK::STARTING_TREASURY;
+
+	std::vector<bank*> auditedBanks {banks.centralBankInstance.get()};
+	for (auto& localBankInstance: banks.localBanks) {
+		auditedBanks.push_back(localBankInstance.get());
+	}
+	std::unique_ptr<ledgerAuditor> auditor;
+	if (audited) {
+		auditor.reset(new ledgerAuditor(auditedBanks, STRESS_AUDIT_INTERVAL));
+	}
+
+	std::vector<moneyFlow> flows(threadsAmount);
+	std::vector<std::thread> threads;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < threadsAmount; i++) {
+		threads.emplace_back(runThread, std::ref(banks), i, threadsAmount, operationsAmount, std::ref(flows[i]));
+	}
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	// other threads could make a Local Bank borrow after its owner finished, remaining loans are paid here
+	for (auto& localBankInstance: banks.localBanks) {
+		while (localBankInstance->isPayingLoan()) {
+			localBankInstance->paymentMethod();
+		}
+	}
+
+	double expectedMoney {startingMoney};
+	std::uint64_t operations {0};
+	for (auto& flow: flows) {
+		expectedMoney = expectedMoney - flow.grantedClientLoans + flow.clientInstallments;
+		operations = operations + flow.operations;
+	}
+	banks.centralBankInstance->setEpochSettlement(false);
+	double money = banks.centralBankInstance->getCurrentTreasury();
+	bool passed {true};
+	for (auto& localBankInstance: banks.localBanks) {
+		localBankInstance->setEpochSettlement(false);
+		money = money + localBankInstance->getCurrentTreasury();
+	}
+	if (std::abs(money - expectedMoney) > MONEY_TOLERANCE * std::max(1.0, std::abs(expectedMoney))) {
+		std::cout << "FAIL: money is not conserved, treasuries " << money << " expected " << expectedMoney << std::endl;
+		passed = false;
+	}
+	if (auditor) {
+		if (auditor->auditPass() != 0 || auditor->getFailures() != 0 || !ledger::isBalanced()) {
+			std::cout << "FAIL: ledger audit found " << auditor->getFailures() << " mismatches, imbalance "
+					<< ledger::getImbalance() << std::endl;
+			passed = false;
+		}
+		auditor.reset();
+		ledger::setEnabled(false);
+	}
+	std::cout << (audited ? "audited " : "") << (epochSettlement ? "epoch" : "classic") << " settlement, " << threadsAmount << " threads: "
+			<< static_cast<long>(operations / seconds) << " ops / s ("
+			<< static_cast<long>(operations / seconds / threadsAmount) << " ops / s / thread)" << std::endl;
+	return passed;
+}
+
+int main(int argc, char **argv) {
+	int maxThreads = argc > 1 ? std::max(1, std::atoi(argv[1])) : DEFAULT_MAX_THREADS;
+	int operationsAmount = argc > 2 ? std::max(1, std::atoi(argv[2])) : DEFAULT_OPERATIONS;
+	loggerClass::setHeadless(true);
+	profiledMutex::setEnabled(false);
+	bool passed {true};
+	for (bool epochSettlement: {false, true}) {
+		for (int threadsAmount = 1; threadsAmount <= maxThreads; threadsAmount *= 2) {
+			passed = runStress(threadsAmount, operationsAmount, epochSettlement, false) && passed;
+		}
+	}
+	for (int threadsAmount = 1; threadsAmount <= maxThreads; threadsAmount *= 2) {
+		passed = runStress(threadsAmount, operationsAmount, true, true) && passed;
+	}
+	std::cout << (passed ? "PASS" : "FAIL") << std::endl;
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+/*
+ * @brief Thread safety stress test
+ *
+ * Many Local Banks served by many Local Client threads at once, with additional threads reading
+ * bank state. Meant to be built with -DECONOMY2_TSAN=ON so ThreadSanitizer reports every data race,
+ * without it the test still checks that every client is accounted for.
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "banking/centralBank.h"
+#include "banking/localBank.h"
+#include "banking/localClient.h"
+#include "banking/loan.h"
+#include "banking/loanPolicyRegistry.h"
+#include "banking/numaTopology.h"
+#include "banking/rateSnapshot.h"
+#include "../constants.h"
+
+const int STRESS_LOCAL_BANKS {8}; ///< Number of Local Banks
+const int STRESS_CLIENT_THREADS_PER_BANK {4}; ///< Number of Local Client threads of every Local Bank
+const int STRESS_CLIENTS {2'000}; ///< Total number of Local Clients
+
+/*!
+ * @brief Outcome counters of all Local Clients
+ */
+struct clientOutcomes {
+	std::atomic<int> paid {0}; ///< Loan granted and fully paid
+	std::atomic<int> rejected {0}; ///< Loan not granted
+	std::atomic<int> cancelled {0}; ///< Loan validated but client resigned while waiting
+};
+
+/*!
+ * @brief Life cycle of Local Clients of a single thread, same as startLocalClient() in economy2.cpp
+ */
+void runClients(localBank* localBankPtr, std::atomic<int>& clientsCounter, clientOutcomes& outcomes) {
+	int clientNumber {0};
+	while ((clientNumber = clientsCounter.fetch_add(1)) < STRESS_CLIENTS) {
+		localClient localClientInstance(static_cast<std::uint32_t>(clientNumber), localBankPtr);
+		loan* loanPtr = localClientInstance.getLoanPtr();
+		localBankPtr->loanProcessingMethod(loanPtr);
+		bool cancelled {false};
+		while (!loanPtr->isReadyToBePayed() && localBankPtr->isLoanWaiting(loanPtr)) {
+			if (clientsCounter >= STRESS_CLIENTS && localBankPtr->cancelWaitingLoan(loanPtr)) {
+				cancelled = true;
+				break;
+			}
+			std::this_thread::yield();
+		}
+		if (cancelled) {
+			outcomes.cancelled++;
+		} else if (loanPtr->isReadyToBePayed()) {
+			while (loanPtr->isReadyToBePayed()) {
+				localClientInstance.paymentMethod();
+			}
+			outcomes.paid++;
+		} else {
+			outcomes.rejected++;
+		}
+	}
+}
+
+/*!
+ * @brief Every client ends paid, rejected or cancelled while banks pay Central Bank and state is read concurrently
+ */
+TEST(ThreadSafetyTest, ManyBanksManyClients) {
+	loggerClass::setHeadless(true);
+	std::unique_ptr<centralBank> centralBankInstance = loanPolicyRegistry::createCentralBank("default");
+	std::vector<std::unique_ptr<localBank>> localBanks;
+	for (int i = 0; i < STRESS_LOCAL_BANKS; i++) {
+		localBanks.push_back(loanPolicyRegistry::createLocalBank("default", "Stress Local Bank " + std::to_string(i),
+				centralBankInstance.get()));
+	}
+	std::atomic<int> clientsCounter {0};
+	std::atomic<bool> clientsRunning {true};
+	clientOutcomes outcomes;
+
+	std::vector<std::thread> clientThreads;
+	for (auto& localBankInstance: localBanks) {
+		for (int i = 0; i < STRESS_CLIENT_THREADS_PER_BANK; i++) {
+			clientThreads.emplace_back(runClients, localBankInstance.get(), std::ref(clientsCounter), std::ref(outcomes));
+		}
+	}
+	std::vector<std::thread> bankThreads;
+	for (auto& localBankInstance: localBanks) {
+		localBank* localBankPtr = localBankInstance.get();
+		bankThreads.emplace_back([localBankPtr, &clientsRunning]() {
+			while (clientsRunning || localBankPtr->isPayingLoan()) {
+				localBankPtr->paymentMethod();
+				std::this_thread::yield();
+			}
+		});
+	}
+	std::thread readerThread([&]() {
+		double readSum {0};
+		std::uint64_t rateVersion {0};
+		do {
+			readSum = readSum + centralBankInstance->getCurrentTreasury() + centralBankInstance->getInterestRate();
+			for (auto& localBankInstance: localBanks) {
+				readSum = readSum + localBankInstance->getCurrentTreasury() + localBankInstance->getInterestRate();
+				rateSnapshot snapshot = localBankInstance->getRateSnapshot();
+				EXPECT_GE(snapshot.version, rateVersion);
+				rateVersion = snapshot.version;
+			}
+			std::this_thread::yield();
+		} while (clientsRunning);
+		EXPECT_GT(readSum, 0);
+	});
+
+	for (auto& clientThread: clientThreads) {
+		clientThread.join();
+	}
+	clientsRunning = false;
+	for (auto& bankThread: bankThreads) {
+		bankThread.join();
+	}
+	readerThread.join();
+	loggerClass::setHeadless(false);
+
+	EXPECT_EQ(STRESS_CLIENTS, outcomes.paid + outcomes.rejected + outcomes.cancelled);
+	EXPECT_GT(outcomes.paid, 0);
+	for (auto& localBankInstance: localBanks) {
+		EXPECT_FALSE(localBankInstance->isPayingLoan());
+	}
+}
+
+/*!
+ * @brief Clients of Local Banks placed on NUMA nodes create and release loans in their loanArena concurrently
+ */
+TEST(ThreadSafetyTest, PlacedBanksLoanArena) {
+	loggerClass::setHeadless(true);
+	std::unique_ptr<centralBank> centralBankInstance = loanPolicyRegistry::createCentralBank("default");
+	std::vector<std::unique_ptr<localBank>> localBanks;
+	for (int i = 0; i < 2; i++) {
+		localBanks.push_back(loanPolicyRegistry::createLocalBank("default", "Placed Local Bank " + std::to_string(i),
+				centralBankInstance.get()));
+		localBanks.back()->setNumaNode(numaTopology::nodeOfLocalBank(i, 2));
+	}
+	std::atomic<int> clientsCounter {0};
+	clientOutcomes outcomes;
+	std::vector<std::thread> clientThreads;
+	for (auto& localBankInstance: localBanks) {
+		for (int i = 0; i < STRESS_CLIENT_THREADS_PER_BANK; i++) {
+			clientThreads.emplace_back([&clientsCounter, &outcomes](localBank* localBankPtr) {
+				numaTopology::pinCurrentThread(localBankPtr->getNumaNode());
+				runClients(localBankPtr, clientsCounter, outcomes);
+			}, localBankInstance.get());
+		}
+	}
+	for (auto& clientThread: clientThreads) {
+		clientThread.join();
+	}
+	loggerClass::setHeadless(false);
+	EXPECT_EQ(STRESS_CLIENTS, outcomes.paid + outcomes.rejected + outcomes.cancelled);
+	for (auto& localBankInstance: localBanks) {
+		EXPECT_EQ(0, localBankInstance->getLoanArena()->getUsedBlocks());
+	}
+}
+
+/*!
+ * @brief Readers never see a rate mixed with a version of another publication
+ */
+TEST(ThreadSafetyTest, RateSeqlock) {
+	rateSeqlock publishedRate;
+	std::atomic<bool> publishing {true};
+	std::thread writerThread([&]() {
+		for (int i = 1; i <= 100'000; i++) {
+			publishedRate.publish(i);
+		}
+		publishing = false;
+	});
+	std::vector<std::thread> readerThreads;
+	for (int i = 0; i < 2; i++) {
+		readerThreads.emplace_back([&]() {
+			std::uint64_t previousVersion {0};
+			do {
+				double rate {0};
+				std::uint64_t version = publishedRate.read(rate);
+				EXPECT_EQ(static_cast<double>(version), rate);
+				EXPECT_GE(version, previousVersion);
+				previousVersion = version;
+			} while (publishing);
+		});
+	}
+	writerThread.join();
+	for (auto& readerThread: readerThreads) {
+		readerThread.join();
+	}
+	EXPECT_EQ(100'000, publishedRate.getVersion());
+}